@@ -0,0 +1,92 @@
+//============================================================================
+//	Johns Hopkins University Whiting School of Engineering
+//	605.667  Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  David W. Nesbitt
+//	File:    AssetPacker/main.cpp
+//	Purpose: Command line tool that packs asset files into an archive
+//           readable by cg::AssetArchive.
+//
+//	Usage:   AssetPacker <archive> <root directory> <file or directory>...
+//           Asset names are paths relative to the root directory, so
+//           AssetPacker Module5/module5.pak . Module5/simple_light.vert
+//           stores the shader under the name Module5/simple_light.vert.
+//           Directories are added recursively.
+//
+//============================================================================
+
+#include "filesystem_support/asset_archive.hpp"
+
+#include <filesystem>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+bool add_path(cg::AssetArchiveWriter &writer, const fs::path &root, const fs::path &path)
+{
+    std::error_code ec;
+    if(fs::is_directory(path, ec))
+    {
+        for(const auto &entry : fs::recursive_directory_iterator(path, ec))
+        {
+            if(entry.is_regular_file() && !add_path(writer, root, entry.path())) return false;
+        }
+        return !ec;
+    }
+
+    std::string name = fs::relative(path, root, ec).generic_string();
+    if(ec || name.empty() || name.compare(0, 2, "..") == 0)
+    {
+        std::cout << "File " << path << " is not under the root directory " << root << '\n';
+        return false;
+    }
+    if(!writer.add_file(name, path.string()))
+    {
+        std::cout << "Could not read " << path << '\n';
+        return false;
+    }
+    std::cout << "  " << name << '\n';
+    return true;
+}
+
+} // namespace
+
+/**
+ * Main method. Entry point for application.
+ */
+int main(int argc, char *argv[])
+{
+    if(argc < 4)
+    {
+        std::cout << "Usage: AssetPacker <archive> <root directory> <file or directory>...\n";
+        return 1;
+    }
+
+    fs::path               root = fs::absolute(argv[2]);
+    cg::AssetArchiveWriter writer;
+    for(int i = 3; i < argc; ++i)
+    {
+        fs::path path = fs::absolute(root / argv[i]);
+        if(!fs::exists(path)) path = fs::absolute(argv[i]);
+        if(!add_path(writer, root, path)) return 1;
+    }
+
+    if(!writer.write(argv[1]))
+    {
+        std::cout << "Could not write archive " << argv[1] << '\n';
+        return 1;
+    }
+
+    cg::AssetArchive archive;
+    if(!archive.open(argv[1]))
+    {
+        std::cout << "Archive " << argv[1] << " failed validation\n";
+        return 1;
+    }
+    std::cout << "Wrote " << archive.get_entry_count() << " assets to " << argv[1] << '\n';
+    return 0;
+}
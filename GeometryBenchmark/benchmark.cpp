@@ -0,0 +1,156 @@
+#include "GeometryBenchmark/benchmark.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+namespace cg
+{
+
+BenchmarkRunner::BenchmarkRunner(const std::string &filter, uint32_t repetitions, double batch_ms)
+    : filter_(filter), repetitions_(std::max(repetitions, 1u)), batch_ns_(batch_ms * 1.0e6),
+      reference_a_(256), reference_b_(64), reference_iterations_(0)
+{
+    for(uint32_t k = 0; k < reference_a_.size(); ++k)
+        reference_a_[k] = 0.5f + 0.25f * static_cast<float>(k);
+    for(uint32_t k = 0; k < reference_b_.size(); ++k)
+        reference_b_[k] = 1.0f - 0.125f * static_cast<float>(k);
+}
+
+const std::vector<BenchmarkResult> &BenchmarkRunner::get_results() const { return results_; }
+
+void BenchmarkRunner::select(const std::vector<std::string> &names) { selected_ = names; }
+
+double BenchmarkRunner::time_reference()
+{
+    // Dot products of float arrays, compiled with the same flags as the code timed
+    auto op = [this](uint32_t i)
+    {
+        float sum = 0.0f;
+        for(uint32_t k = 0; k < reference_b_.size(); ++k)
+            sum += reference_a_[(i + k) & 255] * reference_b_[k];
+        do_not_optimize(sum);
+    };
+
+    // Reference batches take a quarter of the benchmark batch time
+    if(reference_iterations_ == 0)
+    {
+        reference_iterations_ = 1;
+        while(time_batch(op, reference_iterations_) < 0.25 * batch_ns_)
+            reference_iterations_ *= 2;
+    }
+    return time_batch(op, reference_iterations_) / static_cast<double>(reference_iterations_);
+}
+
+bool BenchmarkRunner::is_selected(const std::string &name) const
+{
+    if(!filter_.empty() && name.find(filter_) == std::string::npos) return false;
+    return selected_.empty() ||
+           std::find(selected_.begin(), selected_.end(), name) != selected_.end();
+}
+
+// Median of the values (sorts them)
+static double median_of(std::vector<double> &values)
+{
+    std::sort(values.begin(), values.end());
+    size_t mid = values.size() / 2;
+    return (values.size() % 2 == 1) ? values[mid] : 0.5 * (values[mid - 1] + values[mid]);
+}
+
+void BenchmarkRunner::add_result(const std::string   &name,
+                                 std::vector<double> &samples,
+                                 std::vector<double> &relative,
+                                 uint64_t             iterations)
+{
+    double median = median_of(samples);
+    double relative_median = median_of(relative);
+    results_.push_back({name, median, samples.front(), samples.back(), relative_median,
+                        relative.front(), iterations, static_cast<uint32_t>(samples.size())});
+    printf("%-40s %12.3f ns/op  (min %.3f max %.3f)  relative %.3f\n", name.c_str(), median,
+           samples.front(), samples.back(), relative_median);
+}
+
+bool write_benchmark_json(const std::string                  &filename,
+                          const std::string                  &build_type,
+                          const std::vector<BenchmarkResult> &results)
+{
+    FILE *file = fopen(filename.c_str(), "w");
+    if(file == nullptr) return false;
+
+    fprintf(file, "{\n  \"build_type\": \"%s\",\n  \"benchmarks\": [\n", build_type.c_str());
+    for(size_t i = 0; i < results.size(); ++i)
+    {
+        const BenchmarkResult &r = results[i];
+        fprintf(file,
+                "    {\"name\": \"%s\", \"ns_per_op\": %.3f, \"min_ns\": %.3f, \"max_ns\": %.3f, "
+                "\"relative\": %.4f, \"relative_min\": %.4f, \"iterations\": %llu, "
+                "\"repetitions\": %u}%s\n",
+                r.name.c_str(), r.median_ns, r.min_ns, r.max_ns, r.relative, r.relative_min,
+                static_cast<unsigned long long>(r.iterations), r.repetitions,
+                i + 1 < results.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    return fclose(file) == 0;
+}
+
+// Find "key": in the line and return the text following it (nullptr if not found)
+static const char *find_value(const std::string &line, const char *key)
+{
+    std::string quoted = std::string("\"") + key + "\":";
+    size_t      pos = line.find(quoted);
+    if(pos == std::string::npos) return nullptr;
+    pos += quoted.size();
+    while(pos < line.size() && line[pos] == ' ') ++pos;
+    return line.c_str() + pos;
+}
+
+bool read_benchmark_json(const std::string            &filename,
+                         std::string                  &build_type,
+                         std::vector<BenchmarkResult> &results)
+{
+    std::ifstream file(filename);
+    if(!file) return false;
+
+    // Only reads the layout written by write_benchmark_json (one benchmark per line)
+    size_t      count = results.size();
+    std::string line;
+    build_type.clear();
+    while(std::getline(file, line))
+    {
+        const char *type = find_value(line, "build_type");
+        if(type != nullptr && *type == '"')
+        {
+            const char *type_end = strchr(type + 1, '"');
+            if(type_end != nullptr) build_type.assign(type + 1, type_end);
+            continue;
+        }
+
+        const char *name = find_value(line, "name");
+        const char *median = find_value(line, "ns_per_op");
+        if(name == nullptr || median == nullptr || *name != '"') continue;
+
+        BenchmarkResult r{};
+        const char     *name_end = strchr(name + 1, '"');
+        if(name_end == nullptr) continue;
+        r.name.assign(name + 1, name_end);
+        r.median_ns = atof(median);
+        const char *value = find_value(line, "min_ns");
+        r.min_ns = value ? atof(value) : r.median_ns;
+        value = find_value(line, "max_ns");
+        r.max_ns = value ? atof(value) : r.median_ns;
+        value = find_value(line, "relative");
+        r.relative = value ? atof(value) : 0.0;
+        value = find_value(line, "relative_min");
+        r.relative_min = value ? atof(value) : r.relative;
+        value = find_value(line, "iterations");
+        r.iterations = value ? strtoull(value, nullptr, 10) : 0;
+        value = find_value(line, "repetitions");
+        r.repetitions = value ? static_cast<uint32_t>(atoi(value)) : 0;
+        results.push_back(r);
+    }
+    return results.size() > count;
+}
+
+} // namespace cg
@@ -0,0 +1,180 @@
+//============================================================================
+//	Johns Hopkins University Engineering Programs for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:	David W. Nesbitt
+//	File:    GeometryBenchmark/benchmark.hpp
+//	Purpose: Micro-benchmark runner: warmup, repeated timed batches, median
+//           ns per operation and JSON output.
+//
+//============================================================================
+
+#ifndef __GEOMETRY_BENCHMARK_BENCHMARK_HPP__
+#define __GEOMETRY_BENCHMARK_BENCHMARK_HPP__
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cg
+{
+
+/**
+ * Keeps the compiler from discarding a value (and the work that computed it).
+ * @param  value  Value to keep.
+ */
+template <typename T>
+inline void do_not_optimize(const T &value)
+{
+#if defined(_MSC_VER)
+    static volatile const void *sink;
+    sink = &value;
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+/**
+ * Build type the benchmarks were compiled in (set by CMake). Times from
+ * different build types are not comparable.
+ */
+#ifdef CG_BUILD_TYPE
+constexpr const char *BENCHMARK_BUILD_TYPE = CG_BUILD_TYPE;
+#else
+constexpr const char *BENCHMARK_BUILD_TYPE = "unknown";
+#endif
+
+/**
+ * Timing of one benchmark. Times are per operation. Relative times are
+ * divided by the time of the reference workload measured alongside, so they
+ * carry over between machines (and between a busy and an idle one).
+ */
+struct BenchmarkResult
+{
+    std::string name;
+    double      median_ns;
+    double      min_ns;
+    double      max_ns;
+    double      relative;     // Median time relative to the reference
+    double      relative_min; // Lowest time relative to the reference
+    uint64_t    iterations;   // Operations per timed batch
+    uint32_t    repetitions;  // Timed batches
+};
+
+/**
+ * Runs benchmarks and collects their results. Each benchmark runs a batch of
+ * operations, doubling the batch size until it takes at least the minimum
+ * batch time (which also warms caches and branch predictors), then times
+ * the batch repeatedly and reports the median. Each timed batch is followed
+ * by a batch of a fixed reference workload (plain float arithmetic), and the
+ * ratio of the two gives the relative time.
+ */
+class BenchmarkRunner
+{
+  public:
+    /**
+     * Constructor.
+     * @param  filter       Only run benchmarks whose name contains this (empty runs all).
+     * @param  repetitions  Number of timed batches per benchmark.
+     * @param  batch_ms     Minimum time of a batch in milliseconds.
+     */
+    BenchmarkRunner(const std::string &filter, uint32_t repetitions, double batch_ms);
+
+    /**
+     * Run a benchmark.
+     * @param  name  Name of the benchmark.
+     * @param  op    Operation to time. Called with the operation index, which should be
+     *               used to vary the input so the work cannot be hoisted out of the loop.
+     */
+    template <typename Function>
+    void run(const std::string &name, Function op)
+    {
+        if(!is_selected(name)) return;
+
+        // Calibrate the batch size (this also serves as the warmup)
+        uint64_t iterations = 1;
+        while(time_batch(op, iterations) < batch_ns_ && iterations < (uint64_t(1) << 40))
+            iterations *= 2;
+        time_batch(op, iterations);
+
+        std::vector<double> samples, relative;
+        for(uint32_t r = 0; r < repetitions_; ++r)
+        {
+            samples.push_back(time_batch(op, iterations) / static_cast<double>(iterations));
+            relative.push_back(samples.back() / time_reference());
+        }
+        add_result(name, samples, relative, iterations);
+    }
+
+    /**
+     * Only run the named benchmarks (exact names), e.g. to re-run suspected
+     * regressions. An empty list runs all benchmarks that pass the filter.
+     * @param  names  Names of the benchmarks to run.
+     */
+    void select(const std::vector<std::string> &names);
+
+    /**
+     * Get the results of the benchmarks run so far.
+     * @return  Returns the results in the order run.
+     */
+    const std::vector<BenchmarkResult> &get_results() const;
+
+  protected:
+    std::string                  filter_;
+    std::vector<std::string>     selected_;
+    uint32_t                     repetitions_;
+    double                       batch_ns_;
+    std::vector<BenchmarkResult> results_;
+    std::vector<float>           reference_a_, reference_b_; // Reference workload inputs
+    uint64_t                     reference_iterations_;      // 0 until calibrated
+
+    // Time a batch of operations. Returns nanoseconds.
+    template <typename Function>
+    static double time_batch(Function &op, uint64_t iterations)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for(uint64_t i = 0; i < iterations; ++i) op(static_cast<uint32_t>(i));
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start)
+            .count();
+    }
+
+    // Time a batch of the reference workload. Returns nanoseconds per operation.
+    double time_reference();
+
+    // Does the benchmark pass the filter and selection?
+    bool is_selected(const std::string &name) const;
+
+    // Record the median, min and max of the samples and print a line
+    void add_result(const std::string   &name,
+                    std::vector<double> &samples,
+                    std::vector<double> &relative,
+                    uint64_t             iterations);
+};
+
+/**
+ * Write benchmark results as JSON, one benchmark per line so files diff cleanly.
+ * @param  filename    File to write.
+ * @param  build_type  Build type the benchmarks were compiled in.
+ * @param  results     Results to write.
+ * @return  Returns true if the file was written.
+ */
+bool write_benchmark_json(const std::string                  &filename,
+                          const std::string                  &build_type,
+                          const std::vector<BenchmarkResult> &results);
+
+/**
+ * Read benchmark results written by write_benchmark_json.
+ * @param  filename    File to read.
+ * @param  build_type  Build type the results were recorded in (empty if not given).
+ * @param  results     Results read (appended). Relative times are 0 if not given.
+ * @return  Returns false if the file could not be read or holds no results.
+ */
+bool read_benchmark_json(const std::string            &filename,
+                         std::string                  &build_type,
+                         std::vector<BenchmarkResult> &results);
+
+} // namespace cg
+
+#endif
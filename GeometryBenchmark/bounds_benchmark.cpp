@@ -0,0 +1,41 @@
+#include "GeometryBenchmark/benchmark.hpp"
+#include "geometry/geometry.hpp"
+
+#include <random>
+
+namespace cg
+{
+
+void bounds_benchmark(BenchmarkRunner &runner)
+{
+    // Vertex lists of the size of a small mesh. Times are per bounding volume
+    std::mt19937                          rng(4);
+    std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+    std::vector<std::vector<Point3>>      vertex_lists(4);
+    for(auto &vertex_list : vertex_lists)
+    {
+        for(uint32_t i = 0; i < 1024; ++i)
+            vertex_list.emplace_back(dist(rng), dist(rng), dist(rng));
+    }
+
+    runner.run("AABB construct (1024 points)",
+               [&](uint32_t i) { do_not_optimize(AABB(vertex_lists[i & 3])); });
+    runner.run("BoundingSphere construct (1024 points)",
+               [&](uint32_t i) { do_not_optimize(BoundingSphere(vertex_lists[i & 3])); });
+
+    std::vector<AABB> boxes;
+    for(uint32_t i = 0; i < 256; ++i)
+    {
+        Point3 p(dist(rng), dist(rng), dist(rng));
+        boxes.emplace_back(p, Point3(p.x + 1.0f, p.y + 2.0f, p.z + 3.0f));
+    }
+    runner.run("AABB::merge",
+               [&](uint32_t i)
+               {
+                   AABB box = boxes[i & 255];
+                   box.merge(boxes[(i + 1) & 255]);
+                   do_not_optimize(box);
+               });
+}
+
+} // namespace cg
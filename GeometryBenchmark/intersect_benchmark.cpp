@@ -0,0 +1,53 @@
+#include "GeometryBenchmark/benchmark.hpp"
+#include "geometry/geometry.hpp"
+
+#include <cmath>
+#include <random>
+
+namespace cg
+{
+
+static constexpr uint32_t INPUT_COUNT = 256; // Power of 2 so the index is a mask
+static constexpr uint32_t INPUT_MASK = INPUT_COUNT - 1;
+
+void intersect_benchmark(BenchmarkRunner &runner)
+{
+    // Rays from around the origin in random directions. Roughly half hit each object
+    std::mt19937                          rng(3);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<Ray3>                     rays(INPUT_COUNT);
+    std::vector<BoundingSphere>           spheres(INPUT_COUNT);
+    std::vector<Plane>                    planes(INPUT_COUNT);
+    for(uint32_t i = 0; i < INPUT_COUNT; ++i)
+    {
+        rays[i] = Ray3(Point3(dist(rng), dist(rng), dist(rng)),
+                       Vector3(dist(rng), dist(rng), dist(rng)), true);
+        spheres[i] = BoundingSphere(Point3(dist(rng) * 5.0f, dist(rng) * 5.0f, 5.0f), 2.0f);
+        Vector3 n(dist(rng), dist(rng), dist(rng));
+        planes[i] = Plane(Point3(dist(rng) * 5.0f, dist(rng) * 5.0f, dist(rng) * 5.0f),
+                          n.normalize());
+    }
+
+    runner.run("Ray3::intersect(BoundingSphere)", [&](uint32_t i)
+               { do_not_optimize(rays[i & INPUT_MASK].intersect(spheres[i & INPUT_MASK])); });
+    runner.run("Ray3::intersect(Plane)", [&](uint32_t i)
+               { do_not_optimize(rays[i & INPUT_MASK].intersect(planes[i & INPUT_MASK])); });
+
+    // Segments crossing a convex octagon: some inside, some clipped, some rejected
+    std::vector<Point2> octagon;
+    for(uint32_t i = 0; i < 8; ++i)
+    {
+        float angle = 2.0f * PI * static_cast<float>(i) / 8.0f;
+        octagon.emplace_back(std::cos(angle) * 4.0f, std::sin(angle) * 4.0f);
+    }
+    std::vector<LineSegment2> segments(INPUT_COUNT);
+    for(uint32_t i = 0; i < INPUT_COUNT; ++i)
+    {
+        segments[i] = LineSegment2(Point2(dist(rng) * 6.0f, dist(rng) * 6.0f),
+                                   Point2(dist(rng) * 6.0f, dist(rng) * 6.0f));
+    }
+    runner.run("LineSegment2::clip_to_polygon (8 sides)", [&](uint32_t i)
+               { do_not_optimize(segments[i & INPUT_MASK].clip_to_polygon(octagon)); });
+}
+
+} // namespace cg
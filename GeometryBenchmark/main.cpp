@@ -0,0 +1,226 @@
+//============================================================================
+//	Johns Hopkins University Whiting School of Engineering
+//	605.667 Principles of Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  David W. Nesbitt
+//	File:    GeometryBenchmark/main.cpp
+//	Purpose: Micro-benchmarks of the geometry library. Prints ns per operation
+//           and writes the results as JSON to compare between commits.
+//
+//           Usage: GeometryBenchmark [--out file.json] [--filter name]
+//                                    [--repetitions n] [--batch-ms ms]
+//                                    [--compare baseline.json] [--threshold pct]
+//
+//           With --compare the run fails (exit code 1) if any benchmark in
+//           the baseline is slower by more than the threshold percentage.
+//           Times relative to the reference workload are compared, and only
+//           with a baseline recorded in the same build type.
+//
+//============================================================================
+
+#include "GeometryBenchmark/benchmark.hpp"
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace cg
+{
+
+void vector_benchmark(BenchmarkRunner &runner);
+void matrix_benchmark(BenchmarkRunner &runner);
+void intersect_benchmark(BenchmarkRunner &runner);
+void bounds_benchmark(BenchmarkRunner &runner);
+void mesh_benchmark(BenchmarkRunner &runner);
+void noise_benchmark(BenchmarkRunner &runner);
+void simulation_benchmark(BenchmarkRunner &runner);
+
+// Geometry library messages (e.g. a singular matrix) go to stderr
+void logmsg(const char *message, ...)
+{
+    va_list arg;
+    va_start(arg, message);
+    vfprintf(stderr, message, arg);
+    fputc('\n', stderr);
+    va_end(arg);
+}
+
+} // namespace cg
+
+// Times of a suspected regression are re-measured up to this many times
+constexpr uint32_t MAX_RETRIES = 2;
+
+// Run every benchmark suite (the runner skips those not selected)
+static void run_benchmarks(cg::BenchmarkRunner &runner)
+{
+    cg::vector_benchmark(runner);
+    cg::matrix_benchmark(runner);
+    cg::intersect_benchmark(runner);
+    cg::bounds_benchmark(runner);
+    cg::mesh_benchmark(runner);
+    cg::noise_benchmark(runner);
+    cg::simulation_benchmark(runner);
+}
+
+// Find a result by name (nullptr if not found)
+static const cg::BenchmarkResult *find_result(const std::vector<cg::BenchmarkResult> &results,
+                                              const std::string                      &name)
+{
+    for(const auto &r : results)
+        if(r.name == name) return &r;
+    return nullptr;
+}
+
+/**
+ * Compare results with a baseline, using times relative to the reference
+ * workload so the comparison holds on other machines. A benchmark slower than
+ * the threshold is re-run (noise on a busy machine only ever makes times
+ * longer, so the fastest run is kept) and only fails if it is still slower
+ * and even its fastest batch is slower than the baseline median.
+ * @return  Returns the number of regressions.
+ */
+static uint32_t compare_to_baseline(std::vector<cg::BenchmarkResult>       &results,
+                                    const std::vector<cg::BenchmarkResult> &baseline,
+                                    const std::string                      &filter,
+                                    uint32_t                                repetitions,
+                                    double                                  batch_ms,
+                                    double                                  threshold)
+{
+    double limit = 1.0 + threshold * 0.01;
+    for(uint32_t retry = 0; retry < MAX_RETRIES; ++retry)
+    {
+        std::vector<std::string> suspects;
+        for(const auto &r : results)
+        {
+            const cg::BenchmarkResult *base = find_result(baseline, r.name);
+            if(base != nullptr && r.relative > base->relative * limit) suspects.push_back(r.name);
+        }
+        if(suspects.empty()) break;
+
+        printf("Re-running %zu benchmark(s) slower than the baseline\n", suspects.size());
+        cg::BenchmarkRunner rerun(filter, repetitions, batch_ms);
+        rerun.select(suspects);
+        run_benchmarks(rerun);
+        for(const auto &again : rerun.get_results())
+        {
+            for(auto &r : results)
+                if(r.name == again.name && again.relative < r.relative) r = again;
+        }
+    }
+
+    uint32_t regressions = 0;
+    printf("\nTimes relative to the reference workload\n");
+    printf("%-40s %12s %12s %8s\n", "Benchmark", "Baseline", "Current", "Change");
+    for(const auto &base : baseline)
+    {
+        const cg::BenchmarkResult *r = find_result(results, base.name);
+        if(r == nullptr)
+        {
+            if(filter.empty())
+                printf("%-40s %12.3f %12s\n", base.name.c_str(), base.relative, "missing");
+            continue;
+        }
+        double change = (r->relative / base.relative - 1.0) * 100.0;
+        bool   regressed = r->relative > base.relative * limit && r->relative_min > base.relative;
+        if(regressed) ++regressions;
+        printf("%-40s %12.3f %12.3f %+7.1f%%%s\n", base.name.c_str(), base.relative, r->relative,
+               change, regressed ? "  REGRESSION" : "");
+    }
+    for(const auto &r : results)
+    {
+        if(find_result(baseline, r.name) == nullptr)
+            printf("%-40s %12s %12.3f\n", r.name.c_str(), "new", r.relative);
+    }
+    return regressions;
+}
+
+/**
+ * Main method. Entry point for application.
+ */
+int main(int argc, char *argv[])
+{
+    std::string out_filename = "GeometryBenchmark.json";
+    std::string filter;
+    uint32_t    repetitions = 21;
+    double      batch_ms = 2.0;
+    std::string baseline_filename;
+    double      threshold = 25.0;
+    for(int i = 1; i < argc; ++i)
+    {
+        bool has_value = i + 1 < argc;
+        if(strcmp(argv[i], "--out") == 0 && has_value)
+            out_filename = argv[++i];
+        else if(strcmp(argv[i], "--filter") == 0 && has_value)
+            filter = argv[++i];
+        else if(strcmp(argv[i], "--repetitions") == 0 && has_value)
+            repetitions = static_cast<uint32_t>(atoi(argv[++i]));
+        else if(strcmp(argv[i], "--batch-ms") == 0 && has_value)
+            batch_ms = atof(argv[++i]);
+        else if(strcmp(argv[i], "--compare") == 0 && has_value)
+            baseline_filename = argv[++i];
+        else if(strcmp(argv[i], "--threshold") == 0 && has_value)
+            threshold = atof(argv[++i]);
+        else
+        {
+            fprintf(stderr,
+                    "Usage: %s [--out file.json] [--filter name] [--repetitions n] "
+                    "[--batch-ms ms] [--compare baseline.json] [--threshold pct]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+
+    // Read the baseline first so a bad path fails before spending time on the run. Times
+    // from another build type (or without relative times) cannot be compared
+    std::vector<cg::BenchmarkResult> baseline;
+    std::string                      baseline_build_type;
+    if(!baseline_filename.empty())
+    {
+        if(!cg::read_benchmark_json(baseline_filename, baseline_build_type, baseline))
+        {
+            fprintf(stderr, "Could not read baseline %s\n", baseline_filename.c_str());
+            return 1;
+        }
+        if(baseline_build_type != cg::BENCHMARK_BUILD_TYPE)
+        {
+            fprintf(stderr, "Baseline %s was recorded in a '%s' build, this is a '%s' build\n",
+                    baseline_filename.c_str(), baseline_build_type.c_str(),
+                    cg::BENCHMARK_BUILD_TYPE);
+            return 1;
+        }
+        for(const auto &base : baseline)
+        {
+            if(base.relative <= 0.0)
+            {
+                fprintf(stderr, "Baseline %s has no relative times\n", baseline_filename.c_str());
+                return 1;
+            }
+        }
+    }
+
+    cg::BenchmarkRunner runner(filter, repetitions, batch_ms);
+    run_benchmarks(runner);
+    std::vector<cg::BenchmarkResult> results = runner.get_results();
+
+    uint32_t regressions = 0;
+    if(!baseline.empty())
+        regressions =
+            compare_to_baseline(results, baseline, filter, repetitions, batch_ms, threshold);
+
+    if(!cg::write_benchmark_json(out_filename, cg::BENCHMARK_BUILD_TYPE, results))
+    {
+        fprintf(stderr, "Could not write %s\n", out_filename.c_str());
+        return 1;
+    }
+    printf("Wrote %zu results to %s\n", results.size(), out_filename.c_str());
+
+    if(regressions > 0)
+    {
+        printf("%u benchmark(s) regressed by more than %.1f%%\n", regressions, threshold);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,49 @@
+#include "GeometryBenchmark/benchmark.hpp"
+#include "geometry/geometry.hpp"
+
+#include <random>
+
+namespace cg
+{
+
+static constexpr uint32_t INPUT_COUNT = 256; // Power of 2 so the index is a mask
+static constexpr uint32_t INPUT_MASK = INPUT_COUNT - 1;
+
+void matrix_benchmark(BenchmarkRunner &runner)
+{
+    // Random rigid transforms with scale (invertible, like scene graph transforms)
+    std::mt19937                          rng(2);
+    std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+    std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+    std::vector<Matrix4x4>                m(INPUT_COUNT);
+    std::vector<Point3>                   p(INPUT_COUNT);
+    std::vector<Vector3>                  v(INPUT_COUNT);
+    for(uint32_t i = 0; i < INPUT_COUNT; ++i)
+    {
+        m[i].translate(dist(rng), dist(rng), dist(rng));
+        m[i].rotate(dist(rng) * 18.0f, dist(rng), dist(rng), dist(rng));
+        m[i].scale(scale(rng), scale(rng), scale(rng));
+        p[i] = Point3(dist(rng), dist(rng), dist(rng));
+        v[i].set(dist(rng), dist(rng), dist(rng));
+    }
+
+    runner.run("Matrix4x4::operator*(Matrix4x4)", [&](uint32_t i)
+               { do_not_optimize(m[i & INPUT_MASK] * m[(i + 1) & INPUT_MASK]); });
+    runner.run("Matrix4x4::get_inverse",
+               [&](uint32_t i) { do_not_optimize(m[i & INPUT_MASK].get_inverse()); });
+    runner.run("Matrix4x4::get_transpose",
+               [&](uint32_t i) { do_not_optimize(m[i & INPUT_MASK].get_transpose()); });
+    runner.run("Matrix4x4::operator*(Point3)",
+               [&](uint32_t i) { do_not_optimize(m[i & INPUT_MASK] * p[i & INPUT_MASK]); });
+    runner.run("Matrix4x4::operator*(Vector3)",
+               [&](uint32_t i) { do_not_optimize(m[i & INPUT_MASK] * v[i & INPUT_MASK]); });
+    runner.run("Matrix4x4::rotate",
+               [&](uint32_t i)
+               {
+                   Matrix4x4 r = m[i & INPUT_MASK];
+                   r.rotate(30.0f, v[i & INPUT_MASK].x, v[i & INPUT_MASK].y, v[i & INPUT_MASK].z);
+                   do_not_optimize(r);
+               });
+}
+
+} // namespace cg
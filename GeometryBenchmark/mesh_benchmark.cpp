@@ -0,0 +1,106 @@
+#include "GeometryBenchmark/benchmark.hpp"
+#include "geometry/geometry.hpp"
+
+#include <random>
+
+namespace cg
+{
+
+static constexpr uint32_t RAY_COUNT = 256; // Power of 2 so the index is a mask
+static constexpr uint32_t RAY_MASK = RAY_COUNT - 1;
+
+// UV sphere mesh of radius 10 at the origin (as in the ray / mesh test)
+static void build_sphere_mesh(uint32_t               stacks,
+                              uint32_t               slices,
+                              std::vector<Point3>   &vertex_list,
+                              std::vector<uint16_t> &face_list)
+{
+    const float radius = 10.0f;
+    for(uint32_t i = 0; i <= stacks; ++i)
+    {
+        float phi = PI * static_cast<float>(i) / stacks;
+        for(uint32_t j = 0; j <= slices; ++j)
+        {
+            float theta = 2.0f * PI * static_cast<float>(j) / slices;
+            vertex_list.emplace_back(radius * std::sin(phi) * std::cos(theta),
+                                     radius * std::sin(phi) * std::sin(theta),
+                                     radius * std::cos(phi));
+        }
+    }
+    for(uint32_t i = 0; i < stacks; ++i)
+    {
+        for(uint32_t j = 0; j < slices; ++j)
+        {
+            uint16_t a = static_cast<uint16_t>(i * (slices + 1) + j);
+            uint16_t b = static_cast<uint16_t>(a + slices + 1);
+            face_list.insert(face_list.end(), {a, b, static_cast<uint16_t>(a + 1)});
+            face_list.insert(face_list.end(),
+                             {static_cast<uint16_t>(a + 1), b, static_cast<uint16_t>(b + 1)});
+        }
+    }
+}
+
+void mesh_benchmark(BenchmarkRunner &runner)
+{
+    // A 40960 triangle sphere and rays from around it toward its middle
+    std::vector<Point3>   vertex_list;
+    std::vector<uint16_t> face_list;
+    build_sphere_mesh(128, 160, vertex_list, face_list);
+    MeshBVH       bvh(vertex_list, face_list);
+    TriangleBatch batch;
+    batch.reserve(static_cast<uint32_t>(face_list.size() / 3));
+    for(size_t i = 0; i < face_list.size(); i += 3)
+        batch.add(vertex_list[face_list[i]], vertex_list[face_list[i + 1]],
+                  vertex_list[face_list[i + 2]]);
+
+    std::mt19937                          rng(5);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<Ray3>                     rays;
+    for(uint32_t i = 0; i < RAY_COUNT; ++i)
+    {
+        Point3 origin(dist(rng) * 30.0f, dist(rng) * 30.0f, dist(rng) * 30.0f);
+        Point3 target(dist(rng) * 12.0f, dist(rng) * 12.0f, dist(rng) * 12.0f);
+        rays.emplace_back(origin, target, true);
+    }
+
+    runner.run("Ray3::intersect mesh brute force (40960 triangles)", [&](uint32_t i)
+               { do_not_optimize(rays[i & RAY_MASK].intersect(vertex_list, face_list, 1000.0f)); });
+    runner.run("TriangleBatch::intersect (40960 triangles)", [&](uint32_t i)
+               { do_not_optimize(batch.intersect(rays[i & RAY_MASK], 0, batch.size(), 1000.0f)); });
+    runner.run("MeshBVH nearest hit (40960 triangles)",
+               [&](uint32_t i) { do_not_optimize(rays[i & RAY_MASK].intersect(bvh, 1000.0f)); });
+    runner.run("MeshBVH any hit (40960 triangles)", [&](uint32_t i)
+               { do_not_optimize(rays[i & RAY_MASK].does_intersect_exist(bvh, 1000.0f)); });
+
+    // Coherent picking grid from one eye point. Times are per 4 rays
+    const uint32_t    grid = 64;
+    std::vector<Ray3> grid_rays;
+    Point3            eye(0.0f, -40.0f, 5.0f);
+    for(uint32_t j = 0; j < grid; ++j)
+    {
+        for(uint32_t i = 0; i < grid; ++i)
+        {
+            Point3 target(-12.0f + 24.0f * i / grid, 0.0f, -7.0f + 24.0f * j / grid);
+            grid_rays.emplace_back(eye, target, true);
+        }
+    }
+    uint32_t packet_mask = grid * grid / RayPacket4::WIDTH - 1;
+    runner.run("MeshBVH picking grid, 4 single rays",
+               [&](uint32_t i)
+               {
+                   const Ray3 *r = &grid_rays[(i & packet_mask) * RayPacket4::WIDTH];
+                   for(uint32_t lane = 0; lane < RayPacket4::WIDTH; ++lane)
+                       do_not_optimize(r[lane].intersect(bvh, 1000.0f));
+               });
+    runner.run("MeshBVH picking grid, 4 ray packet",
+               [&](uint32_t i)
+               {
+                   RayMeshIntersectResult results[RayPacket4::WIDTH];
+                   RayPacket4 rp(&grid_rays[(i & packet_mask) * RayPacket4::WIDTH],
+                                 RayPacket4::WIDTH);
+                   bvh.intersect(rp, 1000.0f, results);
+                   do_not_optimize(results);
+               });
+}
+
+} // namespace cg
@@ -0,0 +1,57 @@
+#include "GeometryBenchmark/benchmark.hpp"
+#include "geometry/geometry.hpp"
+
+#include <random>
+#include <vector>
+
+namespace cg
+{
+
+void noise_benchmark(BenchmarkRunner &runner)
+{
+    // Scalar calls against the batch path over the same points. Times are per 256 points
+    const uint32_t                        count = 256;
+    std::mt19937                          rng(6);
+    std::uniform_real_distribution<float> dist(-20.0f, 20.0f);
+    std::vector<Point3>                   points;
+    for(uint32_t i = 0; i < count; ++i) points.emplace_back(dist(rng), dist(rng), dist(rng));
+    std::vector<float> values(count);
+    Noise              noise;
+
+    runner.run("Noise::noise scalar (256 points)",
+               [&](uint32_t i)
+               {
+                   float scale = (i & 1) ? 0.5f : 0.25f;
+                   for(uint32_t p = 0; p < count; ++p) values[p] = noise.noise(points[p], scale);
+                   do_not_optimize(values.data());
+               });
+    runner.run("Noise::noise batch (256 points)",
+               [&](uint32_t i)
+               {
+                   noise.noise(points.data(), count, (i & 1) ? 0.5f : 0.25f, values.data());
+                   do_not_optimize(values.data());
+               });
+    runner.run("Noise::turbulence scalar (256 points)",
+               [&](uint32_t i)
+               {
+                   float scale = (i & 1) ? 0.5f : 0.25f;
+                   for(uint32_t p = 0; p < count; ++p)
+                       values[p] = noise.turbulence(scale, points[p]);
+                   do_not_optimize(values.data());
+               });
+    runner.run("Noise::turbulence batch (256 points)",
+               [&](uint32_t i)
+               {
+                   noise.turbulence((i & 1) ? 0.5f : 0.25f, points.data(), count, values.data());
+                   do_not_optimize(values.data());
+               });
+
+    // Baking throughput on one thread, so the time does not depend on the core count
+    NoiseBaker baker(noise);
+    baker.set_scale(8.0f);
+    baker.set_thread_count(1);
+    runner.run("NoiseBaker::bake 32x32x8 FLOAT32 (1 thread)",
+               [&](uint32_t) { do_not_optimize(baker.bake(32, 32, 8, NoiseFormat::FLOAT32)); });
+}
+
+} // namespace cg
@@ -0,0 +1,195 @@
+#include "GeometryBenchmark/benchmark.hpp"
+#include "Module5/collision.hpp"
+#include "Module5/continuous_collision.hpp"
+#include "scene/scene_state.hpp"
+
+#include <random>
+
+namespace cg
+{
+
+// Balls placed and launched like Module5's create_balls, from a fixed seed
+static std::vector<std::shared_ptr<BallTransform>> create_balls(uint32_t count)
+{
+    std::mt19937                          rng(5);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<std::shared_ptr<BallTransform>> balls;
+    for(uint32_t i = 0; i < count; ++i)
+    {
+        Point3  position(-40.0f + unit(rng) * 80.0f, -40.0f + unit(rng) * 80.0f,
+                         25.0f + unit(rng) * 50.0f);
+        float   radius = 3.0f + unit(rng) * 4.0f;
+        Vector3 direction(unit(rng) * 2.0f - 1.0f, unit(rng) * 2.0f - 1.0f,
+                          unit(rng) * 2.0f - 1.0f);
+        float   speed = 5.0f + unit(rng) * 10.0f;
+        balls.push_back(std::make_shared<BallTransform>(radius, position, direction, speed));
+    }
+    return balls;
+}
+
+// A settled room: 256 balls at rest and asleep on an 8 x 8 x 4 grid except the
+// first moving balls
+static std::vector<std::shared_ptr<BallTransform>> create_settled_balls(uint32_t moving)
+{
+    std::mt19937                          rng(6);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<std::shared_ptr<BallTransform>> balls;
+    for(uint32_t i = 0; i < 256; ++i)
+    {
+        Point3  position(-43.75f + 12.5f * static_cast<float>(i % 8),
+                         -43.75f + 12.5f * static_cast<float>((i / 8) % 8),
+                         6.25f + 12.5f * static_cast<float>(i / 64));
+        float   radius = 3.0f + unit(rng) * 2.0f;
+        Vector3 direction(unit(rng) * 2.0f - 1.0f, unit(rng) * 2.0f - 1.0f,
+                          unit(rng) * 2.0f - 1.0f);
+        float   speed = (i < moving) ? 5.0f + unit(rng) * 10.0f : 0.0f;
+        balls.push_back(std::make_shared<BallTransform>(radius, position, direction, speed));
+        balls.back()->setSleeping(i >= moving);
+    }
+    return balls;
+}
+
+// A packed pile: 256 balls on an 8 x 8 x 4 grid, each overlapping its 6 grid
+// neighbors, moving slowly
+static std::vector<std::shared_ptr<BallTransform>> create_packed_balls()
+{
+    std::mt19937                          rng(7);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<std::shared_ptr<BallTransform>> balls;
+    for(uint32_t i = 0; i < 256; ++i)
+    {
+        Point3  position(-21.0f + 6.0f * static_cast<float>(i % 8),
+                         -21.0f + 6.0f * static_cast<float>((i / 8) % 8),
+                         3.5f + 6.0f * static_cast<float>(i / 64));
+        float   radius = 3.0f + unit(rng) * 0.5f;
+        Vector3 direction(unit(rng) * 2.0f - 1.0f, unit(rng) * 2.0f - 1.0f,
+                          unit(rng) * 2.0f - 1.0f);
+        balls.push_back(std::make_shared<BallTransform>(radius, position, direction, 2.0f));
+    }
+    return balls;
+}
+
+// Ball state saved once and restored before each timed op, so every op runs the
+// same step rather than a room that drifts (and settles) as the benchmark runs
+class BallSnapshot
+{
+  public:
+    explicit BallSnapshot(const std::vector<std::shared_ptr<BallTransform>> &balls)
+        : balls_(balls)
+    {
+        for(const auto &ball : balls)
+            states_.push_back({ball->getPosition(), ball->getVelocity(), ball->isSleeping(),
+                               ball->getStillTime()});
+    }
+
+    void restore() const
+    {
+        for(size_t i = 0; i < balls_.size(); ++i)
+        {
+            balls_[i]->setPosition(states_[i].position);
+            balls_[i]->setVelocity(states_[i].velocity);
+            balls_[i]->setSleeping(states_[i].sleeping);
+            balls_[i]->setStillTime(states_[i].still_time);
+        }
+    }
+
+  private:
+    struct State
+    {
+        Point3  position;
+        Vector3 velocity;
+        bool    sleeping;
+        float   still_time;
+    };
+
+    const std::vector<std::shared_ptr<BallTransform>> &balls_;
+    std::vector<State>                                 states_;
+};
+
+void simulation_benchmark(BenchmarkRunner &runner)
+{
+    std::vector<Plane> bounding_planes;
+    initialize_bounding_planes(bounding_planes);
+
+    // Continuous collision steps, each from the same start. The 256 ball room is
+    // crowded enough that the broadphase matters
+    ContinuousCollisionSolver solver;
+    auto                      ccd_balls64 = create_balls(64);
+    auto                      ccd_balls256 = create_balls(256);
+    BallSnapshot              ccd_start64(ccd_balls64);
+    BallSnapshot              ccd_start256(ccd_balls256);
+    runner.run("continuous collision step (64 balls)",
+               [&](uint32_t)
+               {
+                   ccd_start64.restore();
+                   solver.step(ccd_balls64, bounding_planes, 1.0f / 72.0f);
+               });
+    runner.run("continuous collision step (256 balls)",
+               [&](uint32_t)
+               {
+                   ccd_start256.restore();
+                   solver.step(ccd_balls256, bounding_planes, 1.0f / 72.0f);
+               });
+
+    // Packed pile, where every ball starts overlapping its neighbors, so the
+    // step first pushes the pile apart
+    ContinuousCollisionSolver packed_solver;
+    auto                      packed_balls = create_packed_balls();
+    BallSnapshot              packed_start(packed_balls);
+    runner.run("continuous collision step (256 packed balls)",
+               [&](uint32_t)
+               {
+                   packed_start.restore();
+                   packed_solver.step(packed_balls, bounding_planes, 1.0f / 72.0f);
+               });
+
+    // Mostly settled room: sleeping balls are skipped until hit
+    ContinuousCollisionSolver settled_solver;
+    auto                      settled_balls = create_settled_balls(16);
+    BallSnapshot              settled_start(settled_balls);
+    runner.run("continuous collision step (256 balls, 16 moving)",
+               [&](uint32_t)
+               {
+                   settled_start.restore();
+                   settled_solver.step(settled_balls, bounding_planes, 1.0f / 72.0f);
+               });
+
+    // A full simulation frame as Module5 runs it: a collision step then the
+    // scene graph update traversal
+    ContinuousCollisionSolver frame_solver;
+    auto                      balls = create_balls(64);
+    BallSnapshot              frame_start(balls);
+    SceneNode                 root;
+    SceneState                scene_state;
+    for(auto &ball : balls)
+    {
+        ball->setMovedBySolver(true);
+        root.add_child(ball);
+    }
+    runner.run("simulation frame (64 balls)",
+               [&](uint32_t)
+               {
+                   frame_start.restore();
+                   frame_solver.step(balls, bounding_planes, 1.0f / 72.0f);
+                   root.update(scene_state);
+               });
+
+    // Update traversal of a deeper graph (8 groups of 8 groups of 16 balls)
+    auto many_balls = create_balls(1024);
+    auto scene_root = std::make_shared<SceneNode>();
+    for(uint32_t i = 0; i < 8; ++i)
+    {
+        auto group = std::make_shared<SceneNode>();
+        scene_root->add_child(group);
+        for(uint32_t j = 0; j < 8; ++j)
+        {
+            auto subgroup = std::make_shared<SceneNode>();
+            group->add_child(subgroup);
+            for(uint32_t k = 0; k < 16; ++k) subgroup->add_child(many_balls[(i * 8 + j) * 16 + k]);
+        }
+    }
+    runner.run("scene update traversal (1024 balls)",
+               [&](uint32_t) { scene_root->update(scene_state); });
+}
+
+} // namespace cg
@@ -0,0 +1,45 @@
+#include "GeometryBenchmark/benchmark.hpp"
+#include "geometry/geometry.hpp"
+
+#include <random>
+
+namespace cg
+{
+
+static constexpr uint32_t INPUT_COUNT = 256; // Power of 2 so the index is a mask
+static constexpr uint32_t INPUT_MASK = INPUT_COUNT - 1;
+
+void vector_benchmark(BenchmarkRunner &runner)
+{
+    std::mt19937                          rng(1);
+    std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+    std::vector<Vector3>                  v(INPUT_COUNT);
+    std::vector<Vector3>                  w(INPUT_COUNT);
+    for(uint32_t i = 0; i < INPUT_COUNT; ++i)
+    {
+        v[i].set(dist(rng), dist(rng), dist(rng));
+        w[i].set(dist(rng), dist(rng), dist(rng));
+    }
+
+    runner.run("Vector3::operator+",
+               [&](uint32_t i) { do_not_optimize(v[i & INPUT_MASK] + w[i & INPUT_MASK]); });
+    runner.run("Vector3::operator*(float)",
+               [&](uint32_t i) { do_not_optimize(v[i & INPUT_MASK] * 1.5f); });
+    runner.run("Vector3::dot",
+               [&](uint32_t i) { do_not_optimize(v[i & INPUT_MASK].dot(w[i & INPUT_MASK])); });
+    runner.run("Vector3::cross",
+               [&](uint32_t i) { do_not_optimize(v[i & INPUT_MASK].cross(w[i & INPUT_MASK])); });
+    runner.run("Vector3::norm", [&](uint32_t i) { do_not_optimize(v[i & INPUT_MASK].norm()); });
+    runner.run("Vector3::normalize",
+               [&](uint32_t i)
+               {
+                   Vector3 n = v[i & INPUT_MASK];
+                   do_not_optimize(n.normalize());
+               });
+    runner.run("Vector3::projection", [&](uint32_t i)
+               { do_not_optimize(v[i & INPUT_MASK].projection(w[i & INPUT_MASK])); });
+    runner.run("Vector3::angle_between", [&](uint32_t i)
+               { do_not_optimize(v[i & INPUT_MASK].angle_between(w[i & INPUT_MASK])); });
+}
+
+} // namespace cg
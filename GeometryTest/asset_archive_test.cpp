@@ -0,0 +1,142 @@
+#include "filesystem_support/asset_archive.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace cg
+{
+
+// declare logging function
+void logmsg(const char *message, ...);
+
+namespace
+{
+
+// Write bytes to a file
+void write_bytes(const char *filename, const std::vector<char> &bytes)
+{
+    std::ofstream out(filename, std::ios::binary);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+// Does an open archive hold the asset with the given contents?
+bool holds(const AssetArchive &archive, const std::string &name, const std::string &contents)
+{
+    FileView view;
+    return archive.find(name, view) && view.size == contents.size() &&
+           std::memcmp(view.data, contents.data(), contents.size()) == 0;
+}
+
+// Entry count from the header of archive bytes
+uint32_t archive_entry_count(const std::vector<char> &bytes)
+{
+    AssetArchiveHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    return header.entry_count;
+}
+
+} // namespace
+
+void asset_archive_test()
+{
+    logmsg("\nAsset Archive Tests");
+
+    const char *filename = "asset_archive_test.pak";
+    const char *corrupt_filename = "asset_archive_test_corrupt.pak";
+
+    // Round trip. A name added twice keeps the last data
+    std::string        shader = "void main() { gl_FragColor = vec4(1.0); }";
+    std::string        mesh(1000, 'm');
+    std::string        empty;
+    AssetArchiveWriter writer;
+    writer.add("shaders/simple.frag", "old", 3);
+    writer.add("shaders/simple.frag", shader.data(), shader.size());
+    writer.add("meshes/sphere.mesh", mesh.data(), mesh.size());
+    writer.add("empty.txt", empty.data(), empty.size());
+    bool written = writer.write(filename);
+
+    AssetArchive archive;
+    bool         opened = archive.open(filename);
+    logmsg("   Written = %s  opened = %s  entries = %u", written ? "true" : "false",
+           opened ? "true" : "false", archive.get_entry_count());
+    FileView missing;
+    logmsg("   Contents match: shader = %s  mesh = %s  empty = %s  missing found = %s",
+           holds(archive, "shaders/simple.frag", shader) ? "true" : "false",
+           holds(archive, "meshes/sphere.mesh", mesh) ? "true" : "false",
+           holds(archive, "empty.txt", empty) ? "true" : "false",
+           archive.find("shaders/missing.frag", missing) ? "true" : "false");
+
+    // Backslashes match forward slashes, and load copies a null terminated buffer
+    FileContents contents;
+    bool         loaded = archive.load("shaders\\simple.frag", contents);
+    logmsg("   Loaded with backslashes = %s  size = %llu  terminated = %s",
+           loaded ? "true" : "false", static_cast<unsigned long long>(contents.size),
+           loaded && contents.data[contents.size] == '\0' ? "true" : "false");
+    contents.destroy();
+    archive.close();
+
+    // Mounted archives are searched by name
+    bool     mounted = mount_asset_archive(filename);
+    FileView mounted_view;
+    bool     found = find_mounted_asset("meshes/sphere.mesh", mounted_view);
+    logmsg("   Mounted = %s  found = %s  size = %llu", mounted ? "true" : "false",
+           found ? "true" : "false", static_cast<unsigned long long>(mounted_view.size));
+    unmount_asset_archives();
+    logmsg("   Found after unmount = %s",
+           find_mounted_asset("meshes/sphere.mesh", mounted_view) ? "true" : "false");
+
+    // Corrupt archives must be rejected rather than read out of bounds
+    std::ifstream     in(filename, std::ios::binary);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(in)),
+                            std::istreambuf_iterator<char>());
+    in.close();
+
+    std::vector<char> corrupt = bytes;
+    AssetArchiveEntry entry;
+    char             *last_entry = corrupt.data() + sizeof(AssetArchiveHeader) +
+                      (archive_entry_count(bytes) - 1) * sizeof(AssetArchiveEntry);
+    std::memcpy(&entry, last_entry, sizeof(entry));
+    entry.stored_size = corrupt.size();
+    std::memcpy(last_entry, &entry, sizeof(entry));
+    write_bytes(corrupt_filename, corrupt);
+    bool entry_rejected = !archive.open(corrupt_filename);
+
+    // An offset that wraps around when the size is added
+    entry.offset = UINT64_MAX;
+    entry.stored_size = 2;
+    std::memcpy(last_entry, &entry, sizeof(entry));
+    write_bytes(corrupt_filename, corrupt);
+    bool wrap_rejected = !archive.open(corrupt_filename);
+
+    corrupt = bytes;
+    AssetArchiveHeader header;
+    std::memcpy(&header, corrupt.data(), sizeof(header));
+    header.entry_count = 1000000;
+    std::memcpy(corrupt.data(), &header, sizeof(header));
+    write_bytes(corrupt_filename, corrupt);
+    bool count_rejected = !archive.open(corrupt_filename);
+
+    corrupt.assign(bytes.begin(), bytes.begin() + sizeof(AssetArchiveHeader) + 8);
+    write_bytes(corrupt_filename, corrupt);
+    bool truncated_rejected = !archive.open(corrupt_filename);
+
+    corrupt = bytes;
+    corrupt[0] = 'X';
+    write_bytes(corrupt_filename, corrupt);
+    bool magic_rejected = !archive.open(corrupt_filename);
+    logmsg("   Rejected: entry out of bounds = %s  wrapped offset = %s  entry count = %s",
+           entry_rejected ? "true" : "false", wrap_rejected ? "true" : "false",
+           count_rejected ? "true" : "false");
+    logmsg("   Rejected: truncated = %s  bad magic = %s  open = %s",
+           truncated_rejected ? "true" : "false", magic_rejected ? "true" : "false",
+           archive.is_open() ? "true" : "false");
+
+    std::remove(filename);
+    std::remove(corrupt_filename);
+}
+
+} // namespace cg
@@ -0,0 +1,121 @@
+#include "filesystem_support/async_loader.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace cg
+{
+
+// declare logging function
+void logmsg(const char *message, ...);
+
+namespace
+{
+
+struct TestItem : public MpscNode
+{
+    uint32_t producer;
+    uint32_t sequence;
+};
+
+} // namespace
+
+void async_loader_test()
+{
+    logmsg("\nAsync Loader Tests");
+
+    // Two producers push while the consumer pops. Each producer's items must
+    // come out in the order pushed, and none may be lost or repeated
+    const uint32_t           producers = 2;
+    const uint32_t           per_producer = 100000;
+    std::vector<TestItem>    items(producers * per_producer);
+    MpscQueue                queue;
+    std::vector<std::thread> threads;
+    for(uint32_t p = 0; p < producers; ++p)
+    {
+        threads.emplace_back(
+            [&, p]()
+            {
+                for(uint32_t s = 0; s < per_producer; ++s)
+                {
+                    TestItem &item = items[p * per_producer + s];
+                    item.producer = p;
+                    item.sequence = s;
+                    queue.push(&item);
+                }
+            });
+    }
+    std::vector<uint32_t> next(producers, 0);
+    uint32_t              popped = 0, out_of_order = 0;
+    while(popped < producers * per_producer)
+    {
+        MpscNode *node = queue.pop();
+        if(node == nullptr)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        const TestItem *item = static_cast<TestItem *>(node);
+        if(item->sequence != next[item->producer]) ++out_of_order;
+        next[item->producer] = item->sequence + 1;
+        ++popped;
+    }
+    for(auto &thread : threads) thread.join();
+    uint32_t lost = 0;
+    for(uint32_t p = 0; p < producers; ++p) lost += per_producer - next[p];
+    logmsg("   MPSC queue: %u producers  popped = %u  out of order = %u  lost = %u  empty = %s",
+           producers, popped, out_of_order, lost, queue.pop() == nullptr ? "true" : "false");
+
+    // Load files on two workers. Complete functions run only in drain, on
+    // this thread, and a missing file reports failure
+    const uint32_t           file_count = 8;
+    std::vector<std::string> filenames;
+    for(uint32_t i = 0; i < file_count; ++i)
+    {
+        filenames.push_back("async_loader_test_" + std::to_string(i) + ".txt");
+        std::ofstream out(filenames.back(), std::ios::binary);
+        out << std::string(i + 1, 'x');
+    }
+
+    AsyncLoader           loader(2);
+    std::vector<uint64_t> sizes(file_count, 0);
+    uint32_t              succeeded = 0, failed = 0;
+    for(uint32_t i = 0; i < file_count; ++i)
+    {
+        loader.load(
+            filenames[i],
+            [&sizes, i](const FileView &file)
+            {
+                sizes[i] = file.size;
+                return true;
+            },
+            [&](bool success) { ++(success ? succeeded : failed); });
+    }
+    loader.load("async_loader_test_missing.txt", nullptr,
+                [&](bool success) { ++(success ? succeeded : failed); });
+
+    // A process function that throws fails its load and leaves the worker running
+    loader.load(
+        filenames[0], [](const FileView &) -> bool { throw std::runtime_error("bad file"); },
+        [&](bool success) { ++(success ? succeeded : failed); });
+    loader.wait_idle();
+    uint32_t completed_before_drain = succeeded + failed;
+    uint32_t pending = loader.get_pending_count();
+    uint32_t first_drain = loader.drain(3);
+    uint32_t second_drain = loader.drain();
+    bool     sizes_match = true;
+    for(uint32_t i = 0; i < file_count; ++i) sizes_match = sizes_match && sizes[i] == i + 1;
+    logmsg("   Async loader: pending after wait = %u  completed before drain = %u", pending,
+           completed_before_drain);
+    logmsg("   Drained %u then %u  succeeded = %u  failed = %u  sizes match = %s  pending = %u",
+           first_drain, second_drain, succeeded, failed, sizes_match ? "true" : "false",
+           loader.get_pending_count());
+
+    for(const auto &filename : filenames) std::remove(filename.c_str());
+}
+
+} // namespace cg
@@ -0,0 +1,329 @@
+#include "Module5/collision.hpp"
+#include "Module5/continuous_collision.hpp"
+
+#include <cmath>
+#include <random>
+
+namespace cg
+{
+
+// declare logging function
+void logmsg(const char *message, ...);
+
+namespace
+{
+
+using BallList = std::vector<std::shared_ptr<BallTransform>>;
+
+// Add a ball moving with the given velocity
+void add_ball(BallList &balls, float radius, const Point3 &position, const Vector3 &velocity)
+{
+    float speed = velocity.norm();
+    balls.push_back(std::make_shared<BallTransform>(
+        radius, position, speed > 0.0f ? velocity : Vector3(1.0f, 0.0f, 0.0f), speed));
+    balls.back()->setMovedBySolver(true);
+}
+
+// Total kinetic energy (times 2) of the balls
+float kinetic_energy(const BallList &balls)
+{
+    float energy = 0.0f;
+    for(const auto &ball : balls)
+        energy += ball->getMass() * ball->getVelocity().dot(ball->getVelocity());
+    return energy;
+}
+
+// Total momentum of the balls
+Vector3 momentum(const BallList &balls)
+{
+    Vector3 total(0.0f, 0.0f, 0.0f);
+    for(const auto &ball : balls) total += ball->getVelocity() * ball->getMass();
+    return total;
+}
+
+// Number of ball pairs overlapping by more than the tolerance
+uint32_t count_overlaps(const BallList &balls, float tolerance)
+{
+    uint32_t count = 0;
+    for(size_t i = 0; i < balls.size(); ++i)
+    {
+        for(size_t j = i + 1; j < balls.size(); ++j)
+        {
+            float distance = (balls[j]->getPosition() - balls[i]->getPosition()).norm();
+            if(distance < balls[i]->getRadius() + balls[j]->getRadius() - tolerance) ++count;
+        }
+    }
+    return count;
+}
+
+// Are all balls inside the room (the 6 planes) to within the tolerance?
+bool inside_room(const BallList &balls, const std::vector<Plane> &planes, float tolerance)
+{
+    for(const auto &ball : balls)
+    {
+        for(const auto &plane : planes)
+        {
+            if(plane.solve(ball->getPosition()) < ball->getRadius() - tolerance) return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+void continuous_collision_test()
+{
+    logmsg("\nContinuous Collision Tests");
+
+    std::vector<Plane> room;
+    initialize_bounding_planes(room);
+    std::vector<Plane> no_walls;
+
+    // A ball crossing the room several times over in one large step must stay
+    // inside: it bounces between the side walls instead of passing through
+    {
+        ContinuousCollisionSolver solver;
+        solver.set_sleep_threshold(0.0f, 0.0f);
+        BallList balls;
+        add_ball(balls, 1.0f, Point3(-40.0f, 0.0f, 50.0f), Vector3(3000.0f, 0.0f, 0.0f));
+        solver.step(balls, room, 0.1f);
+        Point3 position = balls[0]->getPosition();
+        logmsg("   Fast ball, 300 units in one step: inside room = %s  x = %.3f  events = %u",
+               inside_room(balls, room, 1.0e-3f) ? "true" : "false", position.x,
+               solver.get_stats().events);
+    }
+
+    // Two fast balls that would pass through each other in one step collide
+    // and bounce back instead
+    {
+        ContinuousCollisionSolver solver;
+        solver.set_sleep_threshold(0.0f, 0.0f);
+        BallList balls;
+        add_ball(balls, 1.0f, Point3(-20.0f, 0.0f, 50.0f), Vector3(500.0f, 0.0f, 0.0f));
+        add_ball(balls, 1.0f, Point3(20.0f, 0.0f, 50.0f), Vector3(-500.0f, 0.0f, 0.0f));
+        solver.step(balls, no_walls, 0.05f);
+        float x0 = balls[0]->getPosition().x, x1 = balls[1]->getPosition().x;
+        logmsg("   Head on, 25 units each in one step: order kept = %s  x = %.3f, %.3f  "
+               "velocity x = %.1f, %.1f",
+               x0 < x1 ? "true" : "false", x0, x1, balls[0]->getVelocity().x,
+               balls[1]->getVelocity().x);
+    }
+
+    // Newton's cradle: the first ball hits a row of 4 equal balls with small
+    // gaps. The contacts are resolved in order within one step, passing the
+    // velocity down the row to the last ball
+    {
+        ContinuousCollisionSolver solver;
+        solver.set_sleep_threshold(0.0f, 0.0f);
+        BallList balls;
+        add_ball(balls, 1.0f, Point3(-3.0f, 0.0f, 50.0f), Vector3(10.0f, 0.0f, 0.0f));
+        for(uint32_t i = 0; i < 4; ++i)
+        {
+            add_ball(balls, 1.0f, Point3(2.1f * static_cast<float>(i), 0.0f, 50.0f),
+                     Vector3(0.0f, 0.0f, 0.0f));
+        }
+        solver.step(balls, no_walls, 0.5f);
+        logmsg("   Cradle: events = %u  velocity x = %.3f %.3f %.3f %.3f %.3f  overlaps = %u",
+               solver.get_stats().events, balls[0]->getVelocity().x, balls[1]->getVelocity().x,
+               balls[2]->getVelocity().x, balls[3]->getVelocity().x, balls[4]->getVelocity().x,
+               count_overlaps(balls, 1.0e-3f));
+    }
+
+    // Bounces: a ball 8 times heavier (twice the radius) takes 2 / 9 of the
+    // speed elastically. With restitution 0.5 a head on collision and a wall
+    // return half the approach speed, and slow contacts do not bounce
+    {
+        ContinuousCollisionSolver solver;
+        solver.set_sleep_threshold(0.0f, 0.0f);
+        BallList balls;
+        add_ball(balls, 1.0f, Point3(-5.0f, 0.0f, 50.0f), Vector3(10.0f, 0.0f, 0.0f));
+        add_ball(balls, 2.0f, Point3(0.0f, 0.0f, 50.0f), Vector3(0.0f, 0.0f, 0.0f));
+        solver.step(balls, no_walls, 1.0f);
+        logmsg("   Masses 1 and 8: velocity x = %.3f, %.3f  momentum x = %.3f",
+               balls[0]->getVelocity().x, balls[1]->getVelocity().x, momentum(balls).x);
+
+        solver.set_restitution(0.5f);
+        balls.clear();
+        add_ball(balls, 1.0f, Point3(-5.0f, 0.0f, 50.0f), Vector3(10.0f, 0.0f, 0.0f));
+        add_ball(balls, 1.0f, Point3(5.0f, 0.0f, 50.0f), Vector3(-10.0f, 0.0f, 0.0f));
+        add_ball(balls, 1.0f, Point3(44.0f, 20.0f, 50.0f), Vector3(10.0f, 0.0f, 0.0f));
+        add_ball(balls, 1.0f, Point3(-10.0f, 20.0f, 50.0f), Vector3(0.2f, 0.0f, 0.0f));
+        add_ball(balls, 1.0f, Point3(-7.9f, 20.0f, 50.0f), Vector3(0.0f, 0.0f, 0.0f));
+        solver.step(balls, room, 1.0f);
+        logmsg("   Restitution 0.5: head on velocity x = %.3f, %.3f  wall velocity x = %.3f  "
+               "slow contact velocity x = %.3f, %.3f",
+               balls[0]->getVelocity().x, balls[1]->getVelocity().x, balls[2]->getVelocity().x,
+               balls[3]->getVelocity().x, balls[4]->getVelocity().x);
+    }
+
+    // Sleeping: with restitution 0.5 a room of balls loses its energy and goes
+    // to sleep (below 1 unit/second, as the slowest balls take long to reach a
+    // wall). Steps of a sleeping room load no balls
+    {
+        ContinuousCollisionSolver             solver;
+        std::mt19937                          rng(5);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        BallList                              balls;
+        solver.set_restitution(0.5f);
+        solver.set_sleep_threshold(1.0f, 0.5f);
+        for(uint32_t i = 0; i < 16; ++i)
+        {
+            Point3  position(-30.0f + 20.0f * static_cast<float>(i % 4),
+                             -30.0f + 20.0f * static_cast<float>(i / 4), 50.0f);
+            Vector3 velocity(unit(rng) * 40.0f - 20.0f, unit(rng) * 40.0f - 20.0f,
+                             unit(rng) * 40.0f - 20.0f);
+            add_ball(balls, 2.0f + unit(rng) * 2.0f, position, velocity);
+        }
+        auto settle = [&]()
+        {
+            for(uint32_t step = 0; step < 1000; ++step)
+            {
+                solver.step(balls, room, 1.0f);
+                if(solver.get_stats().awake == 0) return step + 1;
+            }
+            return 0u;
+        };
+        uint32_t steps = settle();
+        solver.step(balls, room, 1.0f);
+        const ContinuousCollisionStats &stats = solver.get_stats();
+        logmsg("   Restitution 0.5, 16 balls: settled = %s  sleeping = %u  active = %u  "
+               "candidate pairs = %u",
+               steps > 0 ? "true" : "false", stats.sleeping, stats.active,
+               stats.candidate_pairs);
+
+        // Throw ball 0 at its nearest neighbor: the neighbor wakes on contact,
+        // and only the balls near ball 0 are loaded
+        uint32_t nearest = 1;
+        for(uint32_t i = 2; i < balls.size(); ++i)
+        {
+            if((balls[i]->getPosition() - balls[0]->getPosition()).norm() <
+               (balls[nearest]->getPosition() - balls[0]->getPosition()).norm())
+                nearest = i;
+        }
+        Vector3 toward(balls[0]->getPosition(), balls[nearest]->getPosition());
+        float   gap = toward.norm() - balls[0]->getRadius() - balls[nearest]->getRadius();
+        toward.normalize();
+        balls[0]->setVelocity(toward * 10.0f);
+        balls[0]->setSleeping(false);
+        solver.step(balls, room, gap / 10.0f + 0.1f);
+        logmsg("   Ball thrown: woken = %u  neighbor awake = %s  awake = %u  active < 16 = %s",
+               stats.woken, balls[nearest]->isSleeping() ? "false" : "true", stats.awake,
+               stats.active < 16 ? "true" : "false");
+        logmsg("   Settled again = %s", settle() > 0 ? "true" : "false");
+    }
+
+    // A crowd of balls of different sizes: steps conserve energy (walls only
+    // reverse velocity) and, without walls, momentum
+    for(uint32_t walls = 0; walls < 2; ++walls)
+    {
+        ContinuousCollisionSolver             solver;
+        std::mt19937                          rng(11);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        BallList                              balls;
+        solver.set_sleep_threshold(0.0f, 0.0f);
+        for(uint32_t i = 0; i < 64; ++i)
+        {
+            Point3  position(-35.0f + 10.0f * static_cast<float>(i % 8),
+                             -35.0f + 10.0f * static_cast<float>(i / 8), 50.0f);
+            Vector3 velocity(unit(rng) * 40.0f - 20.0f, unit(rng) * 40.0f - 20.0f,
+                             unit(rng) * 40.0f - 20.0f);
+            add_ball(balls, 2.0f + unit(rng) * 2.5f, position, velocity);
+        }
+        float    energy = kinetic_energy(balls);
+        Vector3  start_momentum = momentum(balls);
+        float    scale = std::sqrt(energy * 64.0f);
+        uint32_t events = 0;
+        for(uint32_t step = 0; step < 100; ++step)
+        {
+            solver.step(balls, walls ? room : no_walls, 1.0f / 24.0f);
+            events += solver.get_stats().events;
+        }
+        float energy_change = std::fabs(kinetic_energy(balls) / energy - 1.0f);
+        float momentum_change = (momentum(balls) - start_momentum).norm() / scale;
+        logmsg("   64 balls, 100 steps %s: collisions = %u  energy kept = %s  %s  overlaps = %u",
+               walls ? "in the room" : "without walls", events,
+               energy_change < 1.0e-3f ? "true" : "false",
+               walls ? (inside_room(balls, room, 1.0e-3f) ? "inside room = true"
+                                                          : "inside room = false")
+                     : (momentum_change < 1.0e-3f ? "momentum kept = true"
+                                                  : "momentum kept = false"),
+               count_overlaps(balls, 1.0e-3f));
+    }
+
+    // Islands of a known layout of slow balls of radius 1 (each reaching 2
+    // units): 4 single balls, 3 pairs, a row of 3, a row of 5 and a 10 x 7
+    // grid, with the balls of a group 3 units apart and the groups far apart
+    {
+        ContinuousCollisionSolver solver;
+        solver.set_sleep_threshold(0.0f, 0.0f);
+        BallList balls;
+        Vector3  slow(0.0f, 0.0f, 0.01f);
+        auto     add_row = [&](uint32_t count, float x, float y, float z)
+        {
+            for(uint32_t i = 0; i < count; ++i)
+                add_ball(balls, 1.0f, Point3(x + 3.0f * static_cast<float>(i), y, z), slow);
+        };
+        for(uint32_t i = 0; i < 4; ++i)
+            add_row(1, -40.0f + 20.0f * static_cast<float>(i), -40.0f, 20.0f);
+        for(uint32_t i = 0; i < 3; ++i)
+            add_row(2, -40.0f + 20.0f * static_cast<float>(i), -20.0f, 20.0f);
+        add_row(3, -40.0f, 0.0f, 20.0f);
+        add_row(5, 0.0f, 0.0f, 20.0f);
+        for(uint32_t j = 0; j < 7; ++j)
+            add_row(10, -15.0f, 20.0f + 3.0f * static_cast<float>(j), 60.0f);
+        solver.step(balls, room, 1.0f / 72.0f);
+        const ContinuousCollisionStats &stats = solver.get_stats();
+        logmsg("   Island layout: islands = %u  largest = %u  sizes 1, 2, 3-4, 5-8, 9-16, 17-32, "
+               "33-64, 65+ = %u %u %u %u %u %u %u %u",
+               stats.islands, stats.largest_island, stats.island_sizes[0],
+               stats.island_sizes[1], stats.island_sizes[2], stats.island_sizes[3],
+               stats.island_sizes[4], stats.island_sizes[5], stats.island_sizes[6],
+               stats.island_sizes[7]);
+    }
+
+    // Islands solved on several threads give the same result, bit for bit, as
+    // on one thread
+    {
+        BallList                              balls[2];
+        std::mt19937                          rng(17);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        for(uint32_t i = 0; i < 256; ++i)
+        {
+            Point3  position(-43.75f + 12.5f * static_cast<float>(i % 8),
+                             -43.75f + 12.5f * static_cast<float>((i / 8) % 8),
+                             6.25f + 12.5f * static_cast<float>(i / 64));
+            Vector3 velocity(unit(rng) * 40.0f - 20.0f, unit(rng) * 40.0f - 20.0f,
+                             unit(rng) * 40.0f - 20.0f);
+            float   radius = 2.0f + unit(rng) * 3.0f;
+            add_ball(balls[0], radius, position, velocity);
+            add_ball(balls[1], radius, position, velocity);
+        }
+        ContinuousCollisionSolver solvers[2];
+        solvers[0].set_thread_count(1);
+        solvers[1].set_thread_count(4);
+        bool     identical = true;
+        uint32_t events = 0, islands = 0;
+        for(uint32_t step = 0; step < 100; ++step)
+        {
+            for(uint32_t s = 0; s < 2; ++s) solvers[s].step(balls[s], room, 1.0f / 24.0f);
+            const ContinuousCollisionStats &one = solvers[0].get_stats();
+            const ContinuousCollisionStats &many = solvers[1].get_stats();
+            identical = identical && one.events == many.events && one.islands == many.islands &&
+                        one.island_sizes == many.island_sizes;
+            for(uint32_t i = 0; i < 256; ++i)
+            {
+                identical = identical &&
+                            balls[0][i]->getPosition() == balls[1][i]->getPosition() &&
+                            balls[0][i]->getVelocity() == balls[1][i]->getVelocity() &&
+                            balls[0][i]->isSleeping() == balls[1][i]->isSleeping();
+            }
+            events += one.events;
+            islands += one.islands;
+        }
+        logmsg("   256 balls, 100 steps on 1 and 4 threads: identical = %s  collisions = %u  "
+               "islands per step = %.1f",
+               identical ? "true" : "false", events, static_cast<float>(islands) / 100.0f);
+    }
+}
+
+} // namespace cg
@@ -0,0 +1,136 @@
+#include "geometry/geometry.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace cg
+{
+
+// declare logging function
+void logmsg(const char *message, ...);
+
+// Build a unit sphere from latitude/longitude bands (what the procedural
+// geometry nodes do at load time)
+static void build_sphere(uint32_t                      bands,
+                         std::vector<VertexAndNormal> &vertex_list,
+                         std::vector<uint32_t>        &face_list)
+{
+    vertex_list.clear();
+    face_list.clear();
+    for(uint32_t i = 0; i <= bands; ++i)
+    {
+        float phi = PI * static_cast<float>(i) / static_cast<float>(bands);
+        for(uint32_t j = 0; j <= 2 * bands; ++j)
+        {
+            float           theta = PI * static_cast<float>(j) / static_cast<float>(bands);
+            VertexAndNormal vtx;
+            vtx.normal = Vector3(std::sin(phi) * std::cos(theta),
+                                 std::sin(phi) * std::sin(theta),
+                                 std::cos(phi));
+            vtx.vertex = Point3(vtx.normal.x, vtx.normal.y, vtx.normal.z);
+            vertex_list.push_back(vtx);
+        }
+    }
+    uint32_t row = 2 * bands + 1;
+    for(uint32_t i = 0; i < bands; ++i)
+    {
+        for(uint32_t j = 0; j < 2 * bands; ++j)
+        {
+            uint32_t a = i * row + j;
+            uint32_t b = a + row;
+            face_list.insert(face_list.end(), {a, b, a + 1, a + 1, b, b + 1});
+        }
+    }
+}
+
+void cooked_mesh_test()
+{
+    logmsg("\nCooked Mesh Tests");
+
+    const char *filename = "cooked_mesh_test.mesh";
+
+    std::vector<VertexAndNormal> vertex_list;
+    std::vector<uint32_t>        face_list;
+    build_sphere(256, vertex_list, face_list);
+
+    if(!write_cooked_mesh(filename, vertex_list, face_list))
+    {
+        logmsg("   Failed to write %s", filename);
+        return;
+    }
+
+    // Load: read the whole file into a 4 byte aligned buffer and parse in place
+    std::ifstream in(filename, std::ios::binary | std::ios::ate);
+    uint64_t      size = static_cast<uint64_t>(in.tellg());
+    in.seekg(0);
+    std::vector<uint32_t> buffer((size + 3) / 4);
+    in.read(reinterpret_cast<char *>(buffer.data()), size);
+    in.close();
+    CookedMeshView view;
+    bool parsed = parse_cooked_mesh(reinterpret_cast<const char *>(buffer.data()), size, view);
+
+    logmsg("   Parsed = %s  vertices = %u  indices = %u  index size = %u",
+           parsed ? "true" : "false", view.vertex_count, view.index_count, view.index_size);
+    if(parsed)
+    {
+        bool     same = view.vertex_count == vertex_list.size() &&
+                        view.index_count == face_list.size();
+        uint32_t i = 0;
+        for(; same && i < view.vertex_count; ++i)
+        {
+            same = view.vertices[i].vertex == vertex_list[i].vertex &&
+                   view.vertices[i].normal == vertex_list[i].normal;
+        }
+        const uint32_t *indices = static_cast<const uint32_t *>(view.indices);
+        for(i = 0; same && i < view.index_count; ++i) { same = indices[i] == face_list[i]; }
+        logmsg("   Round trip matches = %s", same ? "true" : "false");
+        Point3 box_min = view.box.min_pt();
+        Point3 box_max = view.box.max_pt();
+        logmsg("   AABB min = (%.3f, %.3f, %.3f)  max = (%.3f, %.3f, %.3f)", box_min.x, box_min.y,
+               box_min.z, box_max.x, box_max.y, box_max.z);
+        logmsg("   Sphere center = (%.3f, %.3f, %.3f)  radius = %.3f",
+               view.sphere.center.x, view.sphere.center.y, view.sphere.center.z,
+               view.sphere.radius);
+    }
+
+    // Corrupt data must be rejected
+    CookedMeshView bad_view;
+    bool truncated = parse_cooked_mesh(reinterpret_cast<const char *>(buffer.data()),
+                                       size / 2, bad_view);
+
+    // A vertex offset that wraps offset + count * stride back into the file
+    CookedMeshHeader header;
+    std::memcpy(&header, buffer.data(), sizeof(header));
+    std::vector<uint32_t> corrupt = buffer;
+    CookedMeshHeader      wrapped = header;
+    wrapped.vertex_offset = ~uint64_t(0) - sizeof(VertexAndNormal) + 1;
+    wrapped.vertex_count = 1;
+    std::memcpy(corrupt.data(), &wrapped, sizeof(wrapped));
+    bool wrapped_offset =
+        parse_cooked_mesh(reinterpret_cast<const char *>(corrupt.data()), size, bad_view);
+
+    // An index past the last vertex
+    corrupt = buffer;
+    uint32_t bad_index = header.vertex_count;
+    std::memcpy(reinterpret_cast<char *>(corrupt.data()) + header.index_offset +
+                    sizeof(uint32_t) * (header.index_count - 1),
+                &bad_index, sizeof(bad_index));
+    bool bad_index_parsed =
+        parse_cooked_mesh(reinterpret_cast<const char *>(corrupt.data()), size, bad_view);
+
+    buffer[0] = 0;
+    bool bad_magic = parse_cooked_mesh(reinterpret_cast<const char *>(buffer.data()), size,
+                                       bad_view);
+    logmsg("   Truncated file rejected = %s  bad magic rejected = %s",
+           truncated ? "false" : "true", bad_magic ? "false" : "true");
+    logmsg("   Wrapped vertex offset rejected = %s  out of range index rejected = %s",
+           wrapped_offset ? "false" : "true", bad_index_parsed ? "false" : "true");
+
+    logmsg("   File size = %llu bytes", static_cast<unsigned long long>(size));
+
+    std::remove(filename);
+}
+
+} // namespace cg
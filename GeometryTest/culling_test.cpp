@@ -0,0 +1,196 @@
+#include "geometry/geometry.hpp"
+#include "scene/scene.hpp"
+
+#include <memory>
+
+namespace cg
+{
+
+// declare logging function
+void logmsg(const char *message, ...);
+
+namespace
+{
+
+/**
+ * Unit sphere geometry that counts draw calls rather than drawing.
+ */
+class CountingGeometry : public GeometryNode
+{
+  public:
+    CountingGeometry() : draw_count(0)
+    {
+        set_bounds(BoundingSphere(Point3(0.0f, 0.0f, 0.0f), 1.0f),
+                   AABB(Point3(-1.0f, -1.0f, -1.0f), Point3(1.0f, 1.0f, 1.0f)));
+    }
+
+    void draw(SceneState &) override { ++draw_count; }
+
+    uint32_t draw_count;
+};
+
+const char *result_str(FrustumTestResult result)
+{
+    switch(result)
+    {
+        case FrustumTestResult::OUTSIDE: return "OUTSIDE";
+        case FrustumTestResult::INTERSECT: return "INTERSECT";
+        case FrustumTestResult::INSIDE: return "INSIDE";
+        default: return "UNKNOWN";
+    }
+}
+
+/**
+ * Same fixed projection and view as Module5: camera at (0,-90,50) looking
+ * down +y with +z up. fov = 70, near = 1, far = 200.
+ */
+Matrix4x4 module5_pv()
+{
+    Matrix4x4 projection;
+    projection.m00() = 1.428f;
+    projection.m11() = 1.428f;
+    projection.m22() = -1.010f;
+    projection.m23() = -2.010f;
+    projection.m32() = -1.0f;
+    projection.m33() = 0.0f;
+
+    Matrix4x4 view;
+    view.m11() = 0.0f;
+    view.m12() = 1.0f;
+    view.m13() = -50.0f;
+    view.m21() = -1.0f;
+    view.m22() = 0.0f;
+    view.m23() = -90.0f;
+    return projection * view;
+}
+
+} // namespace
+
+void culling_test()
+{
+    logmsg("\nFrustum Culling Tests");
+
+    Matrix4x4 pv = module5_pv();
+    Frustum   frustum(pv);
+
+    // ---------- Single bounding volume tests ----------------//
+    BoundingSphere in_front(Point3(0.0f, 10.0f, 50.0f), 5.0f);
+    BoundingSphere behind(Point3(0.0f, -120.0f, 50.0f), 5.0f);
+    BoundingSphere beyond_far(Point3(0.0f, 150.0f, 50.0f), 5.0f);
+    BoundingSphere straddle(Point3(70.0f, 10.0f, 50.0f), 5.0f);
+    logmsg("   Sphere in front of camera: %s", result_str(frustum.test(in_front)));
+    logmsg("   Sphere behind camera: %s", result_str(frustum.test(behind)));
+    logmsg("   Sphere beyond far plane: %s", result_str(frustum.test(beyond_far)));
+    logmsg("   Sphere straddling right plane: %s", result_str(frustum.test(straddle)));
+
+    AABB room(Point3(-50.0f, -50.0f, 0.0f), Point3(50.0f, 50.0f, 100.0f));
+    AABB off_left(Point3(-400.0f, 0.0f, 0.0f), Point3(-300.0f, 10.0f, 10.0f));
+    logmsg("   Room box: %s", result_str(frustum.test(room)));
+    logmsg("   Box far to the left: %s", result_str(frustum.test(off_left)));
+
+    // Transformed bounds
+    Matrix4x4 m;
+    m.translate(0.0f, 10.0f, 50.0f);
+    m.scale(2.0f, 3.0f, 1.0f);
+    BoundingSphere s = m * BoundingSphere(Point3(0.0f, 0.0f, 0.0f), 1.0f);
+    AABB           b = m * AABB(Point3(-1.0f, -1.0f, -1.0f), Point3(1.0f, 1.0f, 1.0f));
+    logmsg("   Transformed sphere center %f %f %f radius %f",
+           s.center.x, s.center.y, s.center.z, s.radius);
+    logmsg("   Transformed box min %f %f %f max %f %f %f",
+           b.minpt.x, b.minpt.y, b.minpt.z, b.maxpt.x, b.maxpt.y, b.maxpt.z);
+
+    // ---------- Large synthetic scene ----------------//
+    // 200 x 200 grid of spheres in the plane z = 50, spaced 5 units apart in x,y.
+    // All transforms share a single geometry node.
+    constexpr int32_t GRID = 200;
+    constexpr float   SPACING = 5.0f;
+    auto              geometry = std::make_shared<CountingGeometry>();
+    auto              root = std::make_shared<SceneNode>();
+    uint32_t          centers_visible = 0;
+    for(int32_t i = 0; i < GRID; ++i)
+    {
+        for(int32_t j = 0; j < GRID; ++j)
+        {
+            float x = (i - GRID / 2) * SPACING;
+            float y = (j - GRID / 2) * SPACING;
+            auto  transform = std::make_shared<TransformNode>();
+            transform->translate(x, y, 50.0f);
+            transform->add_child(geometry);
+            root->add_child(transform);
+
+            // Brute force: a node whose center projects inside the clip volume
+            // must never be culled.
+            HPoint3 clip = pv * Point3(x, y, 50.0f);
+            if(clip.w > 0.0f && std::abs(clip.x) <= clip.w && std::abs(clip.y) <= clip.w &&
+               std::abs(clip.z) <= clip.w)
+                ++centers_visible;
+        }
+    }
+
+    SceneState scene_state;
+    scene_state.pv = pv;
+
+    scene_state.frustum_culling = false;
+    scene_state.init();
+    root->draw(scene_state);
+    logmsg("   Culling off: %d nodes, drawn = %d culled = %d",
+           GRID * GRID, geometry->draw_count, scene_state.nodes_culled);
+
+    geometry->draw_count = 0;
+    scene_state.frustum_culling = true;
+    scene_state.init();
+    root->draw(scene_state);
+    logmsg("   Culling on: %d nodes, drawn = %d culled = %d tests = %d",
+           GRID * GRID, geometry->draw_count, scene_state.nodes_culled, scene_state.cull_tests);
+    logmsg("   Nodes with visible centers = %d, all drawn = %s",
+           centers_visible, (geometry->draw_count >= centers_visible) ? "true" : "false");
+
+    // ---------- Hierarchical bounds ----------------//
+    // Same grid grouped into 20 x 20 blocks of 10 x 10 nodes. Whole blocks are
+    // rejected (or accepted) with a single test.
+    constexpr int32_t BLOCK = 10;
+    auto              hroot = std::make_shared<SceneNode>();
+    std::shared_ptr<TransformNode> moved;
+    for(int32_t bi = 0; bi < GRID; bi += BLOCK)
+    {
+        for(int32_t bj = 0; bj < GRID; bj += BLOCK)
+        {
+            auto block = std::make_shared<SceneNode>();
+            hroot->add_child(block);
+            for(int32_t i = bi; i < bi + BLOCK; ++i)
+            {
+                for(int32_t j = bj; j < bj + BLOCK; ++j)
+                {
+                    auto transform = std::make_shared<TransformNode>();
+                    transform->translate((i - GRID / 2) * SPACING, (j - GRID / 2) * SPACING, 50.0f);
+                    transform->add_child(geometry);
+                    block->add_child(transform);
+                    moved = transform;
+                }
+            }
+        }
+    }
+
+    geometry->draw_count = 0;
+    scene_state.init();
+    hroot->draw(scene_state);
+    logmsg("   Hierarchical: drawn = %d culled = %d tests = %d",
+           geometry->draw_count, scene_state.nodes_culled, scene_state.cull_tests);
+
+    const AABB &before = hroot->get_aabb();
+    logmsg("   Root bounds min %f %f %f max %f %f %f",
+           before.minpt.x, before.minpt.y, before.minpt.z,
+           before.maxpt.x, before.maxpt.y, before.maxpt.z);
+
+    // Moving one node marks its ancestors dirty. Bounds are recomputed on demand.
+    moved->translate(0.0f, 0.0f, 500.0f);
+    const AABB &after = hroot->get_aabb();
+    logmsg("   Root bounds after move min %f %f %f max %f %f %f",
+           after.minpt.x, after.minpt.y, after.minpt.z,
+           after.maxpt.x, after.maxpt.y, after.maxpt.z);
+    const BoundingSphere &hs = hroot->get_bounding_sphere();
+    logmsg("   Root sphere center %f %f %f radius %f", hs.center.x, hs.center.y, hs.center.z,
+           hs.radius);
+}
+
+} // namespace cg
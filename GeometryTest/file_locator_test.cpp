@@ -0,0 +1,75 @@
+#include "filesystem_support/file_locator.hpp"
+
+#include <filesystem>
+#include <fstream>
+
+namespace cg
+{
+
+// declare logging function
+void logmsg(const char *message, ...);
+
+void file_locator_test()
+{
+    logmsg("\nFile Locator Tests");
+
+    // The same file name in two directories, found through the executable path
+    const char *filename = "file_locator_test.txt";
+    std::filesystem::create_directory("file_locator_test_a");
+    std::filesystem::create_directory("file_locator_test_b");
+    {
+        std::ofstream a("file_locator_test_a/file_locator_test.txt", std::ios::binary);
+        a << "a";
+        std::ofstream b("file_locator_test_b/file_locator_test.txt", std::ios::binary);
+        b << "bb";
+    }
+
+    set_root_paths("file_locator_test_a/GeometryTest");
+    FileInfo first = locate_path_for_filename(filename);
+    logmsg("   Root a: found = %s  size = %llu", first.found ? "true" : "false",
+           static_cast<unsigned long long>(first.file_size));
+
+    // Changing the root paths must forget the path resolved under the old root
+    set_root_paths("file_locator_test_b/GeometryTest");
+    FileInfo second = locate_path_for_filename(filename);
+    logmsg("   Root b: found = %s  size = %llu  path changed = %s",
+           second.found ? "true" : "false", static_cast<unsigned long long>(second.file_size),
+           second.file_path != first.file_path ? "true" : "false");
+
+    // Sizes are read again on each lookup, and a removed file is searched for again
+    {
+        std::ofstream b("file_locator_test_b/file_locator_test.txt", std::ios::binary);
+        b << "bbbb";
+    }
+    FileInfo grown = locate_path_for_filename(filename);
+    std::filesystem::remove_all("file_locator_test_b");
+    FileInfo removed = locate_path_for_filename(filename);
+    logmsg("   File grown: size = %llu  file removed: found = %s",
+           static_cast<unsigned long long>(grown.file_size), removed.found ? "true" : "false");
+
+    // Misses are cached until cleared, so a file created later is not found until then
+    const char *late = "file_locator_test_late.txt";
+    FileInfo    before = locate_path_for_filename(late);
+    {
+        std::ofstream out(late, std::ios::binary);
+        out << "late";
+    }
+    FileInfo cached_miss = locate_path_for_filename(late);
+    clear_located_paths();
+    FileInfo after_clear = locate_path_for_filename(late);
+    logmsg("   Created later: before = %s  cached miss = %s  after clear = %s",
+           before.found ? "true" : "false", cached_miss.found ? "true" : "false",
+           after_clear.found ? "true" : "false");
+    std::filesystem::remove(late);
+
+    // Batch lookups share the cache and keep the order of the names
+    std::vector<FileInfo> batch = locate_paths_for_filenames(
+        {"file_locator_test_missing.txt", filename, "file_locator_test_a/file_locator_test.txt"});
+    logmsg("   Batch: found = %s %s %s", batch[0].found ? "true" : "false",
+           batch[1].found ? "true" : "false", batch[2].found ? "true" : "false");
+
+    std::filesystem::remove_all("file_locator_test_a");
+    set_root_paths("./GeometryTest");
+}
+
+} // namespace cg
@@ -0,0 +1,146 @@
+#include "logging/logger.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace cg
+{
+
+// declare logging function
+void logmsg(const char *message, ...);
+
+namespace
+{
+
+bool push_message(LogRingBuffer &buffer, LogLevel level, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    bool pushed = buffer.push(level, format, args);
+    va_end(args);
+    return pushed;
+}
+
+void write_message(Logger &logger, LogLevel level, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    logger.write(level, format, args);
+    va_end(args);
+}
+
+} // namespace
+
+void log_ring_buffer_test()
+{
+    logmsg("\nLog Ring Buffer Tests");
+
+    // Capacity rounds up to a power of 2. A full buffer refuses pushes, and
+    // records come out in the order pushed
+    LogRingBuffer small(6);
+    uint32_t      accepted = 0;
+    for(uint32_t i = 0; i < 10; ++i)
+    {
+        if(push_message(small, LogLevel::INFO, "message %u", i)) ++accepted;
+    }
+    LogRecord record;
+    uint32_t  popped = 0;
+    bool      in_order = true;
+    while(small.pop(record))
+    {
+        in_order = in_order && record.text == "message " + std::to_string(popped);
+        ++popped;
+    }
+    logmsg("   Capacity 6: accepted = %u  popped = %u  in order = %s  pushes = %llu", accepted,
+           popped, in_order ? "true" : "false",
+           static_cast<unsigned long long>(small.get_push_count()));
+
+    // Long messages are truncated to fit the record, and marked
+    std::string long_text(500, 'x');
+    push_message(small, LogLevel::WARNING, "%s", long_text.c_str());
+    small.pop(record);
+    logmsg("   Long message: length = %u  level warning = %s  ends with ... = %s", record.length,
+           record.level == LogLevel::WARNING ? "true" : "false",
+           std::string(record.text).compare(record.length - 3, 3, "...") == 0 ? "true" : "false");
+
+    // Levels below CG_LOG_LEVEL are dropped (the debug line must not reach this log)
+    log_message(LogLevel::DEBUG, "   Debug message logged below CG_LOG_LEVEL");
+    logmsg("   CG_LOG_LEVEL %d: debug enabled = %s  info enabled = %s", CG_LOG_LEVEL,
+           is_log_level_enabled(LogLevel::DEBUG) ? "true" : "false",
+           is_log_level_enabled(LogLevel::INFO) ? "true" : "false");
+
+    // Two producers push while the consumer pops. Each producer's records
+    // must come out in the order pushed, and every push must be accounted
+    // for as either popped or refused
+    const uint32_t           producers = 2;
+    const uint32_t           per_producer = 50000;
+    LogRingBuffer            ring(256);
+    std::vector<uint32_t>    refused(producers, 0);
+    std::atomic<uint32_t>    finished(0);
+    std::vector<std::thread> threads;
+    for(uint32_t p = 0; p < producers; ++p)
+    {
+        threads.emplace_back(
+            [&, p]()
+            {
+                for(uint32_t s = 0; s < per_producer; ++s)
+                {
+                    if(!push_message(ring, LogLevel::INFO, "%u %u", p, s)) ++refused[p];
+                }
+                finished.fetch_add(1);
+            });
+    }
+    std::vector<int64_t> last(producers, -1);
+    uint32_t             received = 0, out_of_order = 0;
+    while(true)
+    {
+        // Read finished first so records pushed before it was set are popped
+        bool done = finished.load() == producers;
+        if(!ring.pop(record))
+        {
+            if(done) break;
+            std::this_thread::yield();
+            continue;
+        }
+        uint32_t p, s;
+        if(std::sscanf(record.text, "%u %u", &p, &s) != 2 || p >= producers ||
+           static_cast<int64_t>(s) <= last[p])
+        {
+            ++out_of_order;
+            continue;
+        }
+        last[p] = s;
+        ++received;
+    }
+    for(auto &thread : threads) thread.join();
+    uint32_t total_refused = 0;
+    for(uint32_t p = 0; p < producers; ++p) total_refused += refused[p];
+    logmsg("   %u producers: out of order = %u  received + refused = %u of %u  "
+           "pops = pushes = %s",
+           producers, out_of_order, received + total_refused, producers * per_producer,
+           ring.get_pop_count() == ring.get_push_count() ? "true" : "false");
+
+    // A logger that drops messages when full reports the count in the file
+    const char *filename = "log_ring_buffer_test.log";
+    {
+        Logger logger(8);
+        for(uint32_t i = 0; i < 20; ++i) write_message(logger, LogLevel::INFO, "line %u", i);
+        uint64_t dropped = logger.get_dropped_count();
+        logger.open(filename);
+        logger.close();
+
+        std::ifstream            in(filename);
+        std::vector<std::string> lines;
+        for(std::string line; std::getline(in, line);) lines.push_back(line);
+        logmsg("   Logger capacity 8, 20 messages: dropped = %llu  lines = %u  last = %s",
+               static_cast<unsigned long long>(dropped), static_cast<uint32_t>(lines.size()),
+               lines.empty() ? "" : lines.back().c_str());
+    }
+    std::remove(filename);
+}
+
+} // namespace cg
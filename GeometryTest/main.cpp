@@ -9,6 +9,8 @@
 //
 //============================================================================
 
+#include "logging/logger.hpp"
+
 #include <stdarg.h>
 #include <stdio.h>
 
@@ -18,19 +20,25 @@ namespace cg
 void vector_test_module1();
 void matrix_test_module4();
 void vector_test_module5();
+void culling_test();
+void ray_mesh_test();
+void noise_test();
+void noise_bake_test();
+void cooked_mesh_test();
+void mapped_file_test();
+void async_loader_test();
+void file_locator_test();
+void asset_archive_test();
+void log_ring_buffer_test();
+void continuous_collision_test();
 
-// Simple logging function
+// Simple logging function. Messages go to the asynchronous logger (opened in main) at
+// info level, and are truncated to LOG_MESSAGE_SIZE - 1 characters
 void logmsg(const char *message, ...)
 {
-    // Open file if not already opened
-    static FILE *lfile = NULL;
-    if(lfile == NULL) { lfile = fopen("GeometryTest_Module5.log", "w"); }
-
     va_list arg;
     va_start(arg, message);
-    vfprintf(lfile, message, arg);
-    putc('\n', lfile);
-    fflush(lfile);
+    log_message_v(LogLevel::INFO, message, arg);
     va_end(arg);
 }
 
@@ -41,6 +49,20 @@ void logmsg(const char *message, ...)
  */
 int main(int argc, char *argv[])
 {
+    // Tests compare the log against a solution, so wait rather than drop lines
+    cg::get_logger().open("GeometryTest_Module5.log", true);
+
     cg::vector_test_module5();
+    cg::culling_test();
+    cg::ray_mesh_test();
+    cg::noise_test();
+    cg::noise_bake_test();
+    cg::cooked_mesh_test();
+    cg::mapped_file_test();
+    cg::async_loader_test();
+    cg::file_locator_test();
+    cg::asset_archive_test();
+    cg::log_ring_buffer_test();
+    cg::continuous_collision_test();
     return 1;
 }
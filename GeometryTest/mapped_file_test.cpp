@@ -0,0 +1,81 @@
+#include "filesystem_support/mapped_file.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace cg
+{
+
+// declare logging function
+void logmsg(const char *message, ...);
+
+void mapped_file_test()
+{
+    logmsg("\nMapped File Tests");
+
+    const char *filename = "mapped_file_test.txt";
+    const char *empty_filename = "mapped_file_test_empty.txt";
+    const char *text = "The quick brown fox jumps over the lazy dog";
+    {
+        std::ofstream out(filename, std::ios::binary);
+        out << text;
+        std::ofstream empty(empty_filename, std::ios::binary);
+    }
+
+    MappedFile file(filename);
+    bool       same = file.is_open() && file.size() == std::strlen(text) &&
+                std::memcmp(file.data(), text, file.size()) == 0;
+    logmsg("   Open = %s  mapped = %s  size = %llu  contents match = %s",
+           file.is_open() ? "true" : "false", file.is_mapped() ? "true" : "false",
+           static_cast<unsigned long long>(file.size()), same ? "true" : "false");
+
+    // Views are clamped to the end of the file
+    FileView word = file.view(4, 5);
+    FileView tail = file.view(40, 100);
+    FileView past = file.view(100, 10);
+    logmsg("   View (4, 5) = %.*s  view (40, 100) = %.*s  view past end size = %llu",
+           static_cast<int>(word.size), word.data, static_cast<int>(tail.size), tail.data,
+           static_cast<unsigned long long>(past.size));
+
+    // Moving transfers the mapping
+    MappedFile moved(std::move(file));
+    logmsg("   Moved: source open = %s  target open = %s  target size = %llu",
+           file.is_open() ? "true" : "false", moved.is_open() ? "true" : "false",
+           static_cast<unsigned long long>(moved.size()));
+    moved.close();
+    logmsg("   Closed: open = %s  size = %llu", moved.is_open() ? "true" : "false",
+           static_cast<unsigned long long>(moved.size()));
+
+    // An empty file opens with no data to map; a missing file fails to open
+    MappedFile empty(empty_filename);
+    logmsg("   Empty file: open = %s  mapped = %s  size = %llu  data = %s",
+           empty.is_open() ? "true" : "false", empty.is_mapped() ? "true" : "false",
+           static_cast<unsigned long long>(empty.size()),
+           empty.data() != nullptr ? "not null" : "null");
+    MappedFile missing;
+    bool       opened = missing.open("mapped_file_test_missing.txt");
+    logmsg("   Missing file: open returned = %s  open = %s  size = %llu",
+           opened ? "true" : "false", missing.is_open() ? "true" : "false",
+           static_cast<unsigned long long>(missing.size()));
+
+    // A directory is not a file: neither mapped nor read through the fallback
+    const char *dirname = "mapped_file_test_dir";
+    std::filesystem::create_directory(dirname);
+    MappedFile   directory;
+    FileContents contents;
+    bool         dir_opened = directory.open(dirname);
+    bool         dir_loaded = load_file_contents(dirname, contents);
+    logmsg("   Directory: open returned = %s  open = %s  load_file_contents returned = %s",
+           dir_opened ? "true" : "false", directory.is_open() ? "true" : "false",
+           dir_loaded ? "true" : "false");
+    contents.destroy();
+    std::filesystem::remove(dirname);
+
+    empty.close();
+    std::remove(filename);
+    std::remove(empty_filename);
+}
+
+} // namespace cg
@@ -0,0 +1,60 @@
+#include "geometry/geometry.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace cg
+{
+
+// declare logging function
+void logmsg(const char *message, ...);
+
+void noise_bake_test()
+{
+    logmsg("\nNoise Baking Tests");
+
+    Noise      noise;
+    NoiseBaker baker(noise);
+    baker.set_scale(8.0f);
+
+    // 3D volume single threaded, then with all cores (throughput is in GeometryBenchmark)
+    baker.set_thread_count(1);
+    NoiseVolume single = baker.bake(128, 128, 64, NoiseFormat::FLOAT32);
+    uint32_t    progress_calls = 0;
+    float       last_progress = 0.0f;
+    bool        monotonic = true;
+    baker.set_thread_count(0);
+    baker.set_progress_callback(
+        [&](float fraction)
+        {
+            monotonic = monotonic && fraction >= last_progress;
+            last_progress = fraction;
+            ++progress_calls;
+        });
+    NoiseVolume    multi = baker.bake(128, 128, 64, NoiseFormat::FLOAT32);
+    NoiseBakeStats multi_stats = baker.get_stats();
+
+    bool same = single.size_bytes() == multi.size_bytes() &&
+                std::memcmp(single.data(), multi.data(), single.size_bytes()) == 0;
+    logmsg("   128x128x64 volume: %llu samples %d tiles, threaded result matches: %s",
+           (unsigned long long)multi_stats.samples, multi_stats.tiles, same ? "true" : "false");
+    logmsg("   Progress: %s, final = %f, monotonic = %s", progress_calls > 0 ? "reported" : "none",
+           last_progress, monotonic ? "true" : "false");
+    logmsg("   Sample at (5,6,7) = %f turbulence = %f", single.values[(7 * 128 + 6) * 128 + 5],
+           noise.turbulence(8.0f, Point3(5.0f / 128.0f, 6.0f / 128.0f, 7.0f / 64.0f)));
+
+    // 2D RGBA texture written to a raw file
+    baker.set_progress_callback(nullptr);
+    NoiseVolume image = baker.bake(256, 256, 1, NoiseFormat::RGBA8);
+    const char *filename = "noise_256x256_rgba8.raw";
+    bool        written = image.write_raw(filename);
+    std::ifstream in(filename, std::ios::binary | std::ios::ate);
+    logmsg("   256x256 RGBA8 raw file written: %s, size = %lld bytes (expected %llu)",
+           written ? "true" : "false", (long long)in.tellg(),
+           (unsigned long long)image.size_bytes());
+    in.close();
+    std::remove(filename);
+}
+
+} // namespace cg
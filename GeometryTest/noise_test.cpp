@@ -0,0 +1,62 @@
+#include "geometry/geometry.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace cg
+{
+
+// declare logging function
+void logmsg(const char *message, ...);
+
+void noise_test()
+{
+    logmsg("\nNoise Tests");
+
+    // Sample a 128 x 128 x 16 grid of points
+    std::vector<Point3> points;
+    for(uint32_t k = 0; k < 16; ++k)
+    {
+        for(uint32_t j = 0; j < 128; ++j)
+        {
+            for(uint32_t i = 0; i < 128; ++i)
+                points.emplace_back(i * 0.37f - 20.0f, j * 0.41f - 7.0f, k * 0.53f + 3.0f);
+        }
+    }
+    uint32_t count = static_cast<uint32_t>(points.size());
+
+    Noise noise;
+    Noise same_seed;
+    Noise other_seed(7);
+    logmsg("   Lattice point noise = %f", noise.noise(Point3(3.0f, 4.0f, 5.0f), 1.0f));
+    float n = noise.noise(points[1000], 1.0f);
+    logmsg("   Same seed repeatable: %s, other seed differs: %s",
+           n == same_seed.noise(points[1000], 1.0f) ? "true" : "false",
+           n != other_seed.noise(points[1000], 1.0f) ? "true" : "false");
+
+    // Scalar against batch (timings are in GeometryBenchmark)
+    std::vector<float> scalar(count), batch(count), turb_scalar(count), turb_batch(count);
+    for(uint32_t i = 0; i < count; ++i) scalar[i] = noise.noise(points[i], 0.5f);
+    noise.noise(points.data(), count, 0.5f, batch.data());
+    for(uint32_t i = 0; i < count; ++i) turb_scalar[i] = noise.turbulence(0.5f, points[i]);
+    noise.turbulence(0.5f, points.data(), count, turb_batch.data());
+
+    float  max_diff = 0.0f, turb_max_diff = 0.0f;
+    float  lo = 1.0f, hi = 0.0f, turb_lo = 1.0f, turb_hi = 0.0f;
+    double mean = 0.0;
+    for(uint32_t i = 0; i < count; ++i)
+    {
+        max_diff = std::max(max_diff, std::fabs(scalar[i] - batch[i]));
+        turb_max_diff = std::max(turb_max_diff, std::fabs(turb_scalar[i] - turb_batch[i]));
+        lo = std::min(lo, scalar[i]);
+        hi = std::max(hi, scalar[i]);
+        turb_lo = std::min(turb_lo, turb_scalar[i]);
+        turb_hi = std::max(turb_hi, turb_scalar[i]);
+        mean += scalar[i];
+    }
+    logmsg("   %d points: noise range %f to %f mean %f", count, lo, hi, mean / count);
+    logmsg("   Turbulence range %f to %f", turb_lo, turb_hi);
+    logmsg("   Batch max difference: noise %f turbulence %f", max_diff, turb_max_diff);
+}
+
+} // namespace cg
@@ -0,0 +1,206 @@
+#include "geometry/geometry.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace cg
+{
+
+// declare logging function
+void logmsg(const char *message, ...);
+
+namespace
+{
+
+/**
+ * Build a UV sphere mesh (radius 10 at the origin). Keeps the vertex count
+ * below 65536 so faces fit 16 bit indices.
+ */
+void build_sphere_mesh(uint32_t              stacks,
+                       uint32_t              slices,
+                       std::vector<Point3>   &vertex_list,
+                       std::vector<uint16_t> &face_list)
+{
+    const float radius = 10.0f;
+    for(uint32_t i = 0; i <= stacks; ++i)
+    {
+        float phi = PI * static_cast<float>(i) / stacks;
+        for(uint32_t j = 0; j <= slices; ++j)
+        {
+            float theta = 2.0f * PI * static_cast<float>(j) / slices;
+            vertex_list.emplace_back(radius * std::sin(phi) * std::cos(theta),
+                                     radius * std::sin(phi) * std::sin(theta),
+                                     radius * std::cos(phi));
+        }
+    }
+    for(uint32_t i = 0; i < stacks; ++i)
+    {
+        for(uint32_t j = 0; j < slices; ++j)
+        {
+            uint16_t a = static_cast<uint16_t>(i * (slices + 1) + j);
+            uint16_t b = static_cast<uint16_t>(a + slices + 1);
+            face_list.insert(face_list.end(), {a, b, static_cast<uint16_t>(a + 1)});
+            face_list.insert(face_list.end(),
+                             {static_cast<uint16_t>(a + 1), b, static_cast<uint16_t>(b + 1)});
+        }
+    }
+}
+
+} // namespace
+
+void ray_mesh_test()
+{
+    logmsg("\nRay / Mesh Intersection Tests");
+
+    // Single triangle
+    Ray3 ray(Point3(0.25f, 0.25f, 5.0f), Vector3(0.0f, 0.0f, -1.0f));
+    auto tri = ray.intersect(Point3(0.0f, 0.0f, 0.0f), Point3(1.0f, 0.0f, 0.0f),
+                             Point3(0.0f, 1.0f, 0.0f));
+    logmsg("   Triangle hit: %d distance = %f u = %f v = %f", tri.intersects, tri.distance,
+           tri.barycentric_u, tri.barycentric_v);
+    Ray3 miss(Point3(1.0f, 1.0f, 5.0f), Vector3(0.0f, 0.0f, -1.0f));
+    logmsg("   Triangle miss: %d", miss.does_intersect_exist(Point3(0.0f, 0.0f, 0.0f),
+                                                            Point3(1.0f, 0.0f, 0.0f),
+                                                            Point3(0.0f, 1.0f, 0.0f)));
+
+    // Ray / box
+    AABB box(Point3(-1.0f, -1.0f, -1.0f), Point3(1.0f, 1.0f, 1.0f));
+    auto box_hit = Ray3(Point3(-5.0f, 0.5f, 0.0f), Vector3(1.0f, 0.0f, 0.0f)).intersect(box);
+    auto box_inside = Ray3(Point3(0.0f, 0.0f, 0.0f), Vector3(0.0f, 0.0f, 1.0f)).intersect(box);
+    auto box_miss = Ray3(Point3(-5.0f, 2.0f, 0.0f), Vector3(1.0f, 0.0f, 0.0f)).intersect(box);
+    auto box_behind = Ray3(Point3(5.0f, 0.0f, 0.0f), Vector3(1.0f, 0.0f, 0.0f)).intersect(box);
+    logmsg("   Box hit: %d distance = %f", box_hit.intersects, box_hit.distance);
+    logmsg("   Box from inside: %d distance = %f", box_inside.intersects, box_inside.distance);
+    logmsg("   Box miss: %d behind: %d", box_miss.intersects, box_behind.intersects);
+
+    // Rays running in a face plane (a zero direction component with the origin on
+    // a slab plane, so 0 * inf in the slab test). Both signs of zero touch the box.
+    Ray3 edge_on[RayPacket4::WIDTH] = {
+        Ray3(Point3(1.0f, 0.0f, -5.0f), Vector3(0.0f, 0.0f, 1.0f)),
+        Ray3(Point3(1.0f, 0.0f, -5.0f), Vector3(-0.0f, 0.0f, 1.0f)),
+        Ray3(Point3(-1.0f, 0.0f, -5.0f), Vector3(-0.0f, 0.0f, 1.0f)),
+        Ray3(Point3(0.0f, 1.0f, -5.0f), Vector3(0.0f, -0.0f, 1.0f))};
+    uint32_t edge_hits = 0;
+    float    edge_max = 0.0f;
+    for(const auto &r : edge_on)
+    {
+        auto hit = r.intersect(box);
+        if(hit.intersects) ++edge_hits;
+        edge_max = std::max(edge_max, std::abs(hit.distance - 4.0f));
+    }
+    float    t_max[RayPacket4::WIDTH] = {1000.0f, 1000.0f, 1000.0f, 1000.0f};
+    uint32_t edge_mask = RayPacket4(edge_on, RayPacket4::WIDTH).intersect(box, t_max, nullptr);
+    logmsg("   Box in face planes: hits = %u of 4 distance error = %f packet mask = %x",
+           edge_hits, edge_max, edge_mask);
+
+    // Ray / plane (the plane z = 2)
+    Plane   plane(Point3(0.0f, 0.0f, 2.0f), Vector3(0.0f, 0.0f, 1.0f));
+    Point3  above(0.0f, 0.0f, 5.0f);
+    Point3  below(0.0f, 0.0f, -2.0f);
+    Vector3 up(0.0f, 0.0f, 1.0f);
+    auto    plane_hit = Ray3(above, Vector3(0.0f, 0.6f, -0.8f)).intersect(plane);
+    auto    plane_below = Ray3(below, up).intersect(plane);
+    auto    plane_parallel = Ray3(above, Vector3(1.0f, 0.0f, 0.0f)).intersect(plane);
+    auto    plane_behind = Ray3(above, up).intersect(plane);
+    logmsg("   Plane hit: %d distance = %f  from below: %d distance = %f", plane_hit.intersects,
+           plane_hit.distance, plane_below.intersects, plane_below.distance);
+    logmsg("   Plane parallel: %d behind: %d", plane_parallel.intersects, plane_behind.intersects);
+
+    // Large mesh: compare the BVH against brute force over random rays
+    std::vector<Point3>   vertex_list;
+    std::vector<uint16_t> face_list;
+    build_sphere_mesh(128, 160, vertex_list, face_list);
+    MeshBVH bvh(vertex_list, face_list);
+    logmsg("   Mesh: %d vertices %d triangles, BVH nodes = %d", (int)vertex_list.size(),
+           bvh.triangle_count(), bvh.node_count());
+
+    std::mt19937                          rng(1234);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    const uint32_t                        ray_count = 2000;
+    std::vector<Ray3>                     rays;
+    for(uint32_t i = 0; i < ray_count; ++i)
+    {
+        Point3  origin(dist(rng) * 30.0f, dist(rng) * 30.0f, dist(rng) * 30.0f);
+        Point3  target(dist(rng) * 12.0f, dist(rng) * 12.0f, dist(rng) * 12.0f);
+        rays.emplace_back(origin, target, true);
+    }
+
+    TriangleBatch batch;
+    batch.reserve(static_cast<uint32_t>(face_list.size() / 3));
+    for(size_t i = 0; i < face_list.size(); i += 3)
+        batch.add(vertex_list[face_list[i]], vertex_list[face_list[i + 1]],
+                  vertex_list[face_list[i + 2]]);
+
+    // Timings are in GeometryBenchmark; the log keeps deterministic results only
+    uint32_t hits = 0, mismatches = 0, any_mismatches = 0, batch_mismatches = 0;
+    for(const auto &r : rays)
+    {
+        auto expected = r.intersect(vertex_list, face_list, 1000.0f);
+        auto batched = batch.intersect(r, 0, batch.size(), 1000.0f);
+        auto actual = r.intersect(bvh, 1000.0f);
+
+        if(expected.intersects != batched.intersects ||
+           (expected.intersects && expected.face_index != batched.face_index))
+        {
+            ++batch_mismatches;
+        }
+        if(expected.intersects) ++hits;
+        if(expected.intersects != actual.intersects ||
+           (expected.intersects && std::fabs(expected.distance - actual.distance) > 1.0e-4f))
+        {
+            ++mismatches;
+        }
+        if(r.does_intersect_exist(bvh, 1000.0f) != expected.intersects) ++any_mismatches;
+    }
+    logmsg("   %d rays: hits = %d nearest mismatches = %d any hit mismatches = %d", ray_count,
+           hits, mismatches, any_mismatches);
+    logmsg("   Triangle batch mismatches = %d", batch_mismatches);
+
+    // Coherent picking grid: 4 ray packets against single rays
+    const uint32_t    grid = 256;
+    std::vector<Ray3> grid_rays;
+    Point3            eye(0.0f, -40.0f, 5.0f);
+    for(uint32_t j = 0; j < grid; ++j)
+    {
+        for(uint32_t i = 0; i < grid; ++i)
+        {
+            Point3 target(-12.0f + 24.0f * i / grid, 0.0f, -7.0f + 24.0f * j / grid);
+            grid_rays.emplace_back(eye, target, true);
+        }
+    }
+    std::vector<RayMeshIntersectResult> single(grid_rays.size());
+    for(size_t i = 0; i < grid_rays.size(); ++i) single[i] = grid_rays[i].intersect(bvh, 1000.0f);
+    std::vector<RayMeshIntersectResult> packet(grid_rays.size());
+    uint32_t                            any_mask_mismatches = 0;
+    for(size_t i = 0; i < grid_rays.size(); i += RayPacket4::WIDTH)
+    {
+        RayPacket4 rp(&grid_rays[i], RayPacket4::WIDTH);
+        bvh.intersect(rp, 1000.0f, &packet[i]);
+    }
+    for(size_t i = 0; i < grid_rays.size(); i += RayPacket4::WIDTH)
+    {
+        RayPacket4 rp(&grid_rays[i], RayPacket4::WIDTH);
+        uint32_t   mask = bvh.does_intersect_exist(rp, 1000.0f);
+        for(uint32_t lane = 0; lane < RayPacket4::WIDTH; ++lane)
+        {
+            if(((mask >> lane) & 1u) != (single[i + lane].intersects ? 1u : 0u))
+                ++any_mask_mismatches;
+        }
+    }
+    uint32_t grid_hits = 0, packet_mismatches = 0;
+    for(size_t i = 0; i < grid_rays.size(); ++i)
+    {
+        if(single[i].intersects) ++grid_hits;
+        if(single[i].intersects != packet[i].intersects ||
+           (single[i].intersects && (std::fabs(single[i].distance - packet[i].distance) > 1.0e-4f ||
+                                     single[i].face_index != packet[i].face_index)))
+        {
+            ++packet_mismatches;
+        }
+    }
+    logmsg("   Packet grid %d rays: hits = %d nearest mismatches = %d any hit mismatches = %d",
+           (int)grid_rays.size(), grid_hits, packet_mismatches, any_mask_mismatches);
+}
+
+} // namespace cg
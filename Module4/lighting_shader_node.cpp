@@ -5,46 +5,37 @@
 namespace cg
 {
 
-bool LightingShaderNode::get_locations()
+// Shader variable names (hashed at compile time)
+constexpr uint32_t VTX_POSITION = shader_name_hash("vtx_position");
+constexpr uint32_t VTX_NORMAL = shader_name_hash("vtx_normal");
+constexpr uint32_t MATERIAL_COLOR = shader_name_hash("material_color");
+constexpr uint32_t PVM_MATRIX = shader_name_hash("pvm_matrix");
+constexpr uint32_t MODEL_MATRIX = shader_name_hash("model_matrix");
+constexpr uint32_t NORMAL_MATRIX = shader_name_hash("normal_matrix");
+
+// Logs a shader variable that is not active in the program
+static GLint get_location(GLint location, const char *name)
 {
-    position_loc_ = glGetAttribLocation(shader_program_.get_program(), "vtx_position");
-    if(position_loc_ < 0)
-    {
-        std::cout << "Error getting vtx_position location\n";
-        return false;
-    }
-    vertex_normal_loc_ = glGetAttribLocation(shader_program_.get_program(), "vtx_normal");
-    if(vertex_normal_loc_ < 0)
-    {
-        std::cout << "Error getting vtx_normal location\n";
-        return false;
-    }
-    material_color_loc_ = glGetUniformLocation(shader_program_.get_program(), "material_color");
-    if(material_color_loc_ < 0)
-    {
-        std::cout << "Error getting material_color location\n";
-        return false;
-    }
-    pvm_matrix_loc_ = glGetUniformLocation(shader_program_.get_program(), "pvm_matrix");
-    if(pvm_matrix_loc_ < 0)
-    {
-        std::cout << "Error getting pvm_matrix location\n";
-        return false;
-    }
-    model_matrix_loc_ = glGetUniformLocation(shader_program_.get_program(), "model_matrix");
-    if(model_matrix_loc_ < 0)
-    {
-        std::cout << "Error getting model_matrix location\n";
-        return false;
-    }
+    if(location < 0) std::cout << "Error getting " << name << " location\n";
+    return location;
+}
 
-    normal_matrix_loc_ = glGetUniformLocation(shader_program_.get_program(), "normal_matrix");
-    if(normal_matrix_loc_ < 0)
-    {
-        std::cout << "Error getting normal_matrix location\n";
-        return false;
-    }
-    return true;
+bool LightingShaderNode::get_locations()
+{
+    position_loc_ = get_location(shader_program_.get_attribute_location(VTX_POSITION),
+                                 "vtx_position");
+    vertex_normal_loc_ = get_location(shader_program_.get_attribute_location(VTX_NORMAL),
+                                      "vtx_normal");
+    material_color_loc_ = get_location(shader_program_.get_uniform_location(MATERIAL_COLOR),
+                                       "material_color");
+    pvm_matrix_loc_ = get_location(shader_program_.get_uniform_location(PVM_MATRIX),
+                                   "pvm_matrix");
+    model_matrix_loc_ = get_location(shader_program_.get_uniform_location(MODEL_MATRIX),
+                                     "model_matrix");
+    normal_matrix_loc_ = get_location(shader_program_.get_uniform_location(NORMAL_MATRIX),
+                                      "normal_matrix");
+    return position_loc_ >= 0 && vertex_normal_loc_ >= 0 && material_color_loc_ >= 0 &&
+           pvm_matrix_loc_ >= 0 && model_matrix_loc_ >= 0 && normal_matrix_loc_ >= 0;
 }
 
 void LightingShaderNode::draw(SceneState &scene_state)
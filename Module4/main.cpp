@@ -15,6 +15,7 @@
 
 #include "filesystem_support/file_locator.hpp"
 #include "geometry/geometry.hpp"
+#include "logging/logger.hpp"
 #include "scene/graphics.hpp"
 #include "scene/scene.hpp"
 
@@ -30,18 +31,14 @@
 namespace cg
 {
 
-// Simple logging function, should be defined in the cg namespace
+// Simple logging function, should be defined in the cg namespace. Messages go
+// to the asynchronous logger (opened in main) at info level, and are truncated
+// to LOG_MESSAGE_SIZE - 1 characters
 void logmsg(const char *message, ...)
 {
-    // Open file if not already opened
-    static FILE *lfile = NULL;
-    if(lfile == NULL) { lfile = fopen("Module4.log", "w"); }
-
     va_list arg;
     va_start(arg, message);
-    vfprintf(lfile, message, arg);
-    putc('\n', lfile);
-    fflush(lfile);
+    log_message_v(LogLevel::INFO, message, arg);
     va_end(arg);
 }
 
@@ -321,6 +318,7 @@ void construct_scene()
 int main(int argc, char **argv)
 {
     cg::set_root_paths(argv[0]);
+    cg::get_logger().open("Module4.log");
 
     // Initialize SDL
     if(!SDL_Init(SDL_INIT_VIDEO))
@@ -5,7 +5,8 @@ namespace cg {
 
 BallTransform::BallTransform(float r, const Point3& pos, const Vector3& dir, float spd)
     : TransformNode(), radius(r), position(pos), speed(spd),
-      intersect_time(-1.0f), intersect_plane(nullptr), collision_occurred(false)
+      intersect_time(-1.0f), intersect_plane(nullptr), collision_occurred(false),
+      moved_by_solver(false), transform_dirty(false), sleeping(false), still_time(0.0f)
 {
     // Combine direction and speed into velocity vector
     Vector3 normalized_dir = dir;
@@ -21,7 +22,14 @@ BallTransform::BallTransform(float r, const Point3& pos, const Vector3& dir, flo
 void BallTransform::update(SceneState& scene_state) 
 {
     // Handle collision response first
-    if (collision_occurred && intersect_plane != nullptr) 
+    if (moved_by_solver)
+    {
+        // Position was already advanced by the solver. Sleeping balls are not
+        // moved, so their transform is only rebuilt when the position changes
+        if (!transform_dirty)
+            return;
+    }
+    else if (collision_occurred && intersect_plane != nullptr) 
     {
         // Move to collision point first
         Point3 movement = Point3(velocity.x * intersect_time, 
@@ -62,6 +70,7 @@ void BallTransform::update(SceneState& scene_state)
     load_identity();
     translate(position.x, position.y, position.z);
     scale(radius, radius, radius);
+    transform_dirty = false;
     
     // Call base class update for children
     TransformNode::update(scene_state);
@@ -20,6 +20,14 @@ private:
     float intersect_time;
     Plane* intersect_plane;
     bool collision_occurred;
+
+    // Position is set by a collision solver rather than integrated in update
+    bool moved_by_solver;
+    bool transform_dirty;   // Position changed since the transform was built
+
+    // Sleeping state, kept for the solver between frames
+    bool sleeping;
+    float still_time;       // Time spent below the solver's sleep speed
     
     // Time delta for movement (assuming 72 FPS = 1/72 seconds per frame)
     static constexpr float FRAME_TIME = 1.0f / 72.0f;
@@ -38,12 +46,24 @@ public:
     // Getters for collision detection system
     Point3 getPosition() const { return position; }
     float getRadius() const { return radius; }
+    // Mass of a ball of unit density, without the 4/3 pi (which cancels in collisions)
+    float getMass() const { return radius * radius * radius; }
     Vector3 getVelocity() const { return velocity; }
     BoundingSphere getBoundingSphere() const { return BoundingSphere(position, radius); }
     
     // Setter for sphere-to-sphere collision
     void setVelocity(const Vector3& vel) { velocity = vel; }
-    void setPosition(const Point3& pos) { position = pos; }
+    void setPosition(const Point3& pos) { position = pos; transform_dirty = true; }
+
+    // When moved by a solver (e.g. ContinuousCollisionSolver) update only
+    // rebuilds the transform from the position set by the solver
+    void setMovedBySolver(bool moved) { moved_by_solver = moved; }
+
+    // Sleeping balls are at rest and skipped by the solver until hit
+    bool isSleeping() const { return sleeping; }
+    void setSleeping(bool sleep) { sleeping = sleep; }
+    float getStillTime() const { return still_time; }
+    void setStillTime(float t) { still_time = t; }
 };
 
 } // namespace cg
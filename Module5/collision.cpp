@@ -0,0 +1,32 @@
+#include "Module5/collision.hpp"
+
+#include "geometry/geometry.hpp"
+
+namespace cg
+{
+
+// Initialize bounding planes for the room
+void initialize_bounding_planes(std::vector<Plane> &bounding_planes)
+{
+    bounding_planes.clear();
+    
+    // Floor (z = 0, normal pointing up)
+    bounding_planes.push_back(Plane(Point3(0, 0, 0), Vector3(0, 0, 1)));
+    
+    // Ceiling (z = 100, normal pointing down)  
+    bounding_planes.push_back(Plane(Point3(0, 0, 100), Vector3(0, 0, -1)));
+    
+    // Left wall (x = -50, normal pointing right)
+    bounding_planes.push_back(Plane(Point3(-50, 0, 0), Vector3(1, 0, 0)));
+    
+    // Right wall (x = 50, normal pointing left)
+    bounding_planes.push_back(Plane(Point3(50, 0, 0), Vector3(-1, 0, 0)));
+    
+    // Back wall (y = 50, normal pointing toward camera)
+    bounding_planes.push_back(Plane(Point3(0, 50, 0), Vector3(0, -1, 0)));
+    
+    // Front wall (y = -50, normal pointing away from camera) 
+    bounding_planes.push_back(Plane(Point3(0, -50, 0), Vector3(0, 1, 0)));
+}
+
+} // namespace cg
@@ -0,0 +1,20 @@
+#ifndef __MODULE5_COLLISION_HPP__
+#define __MODULE5_COLLISION_HPP__
+
+#include "geometry/plane.hpp"
+
+#include <vector>
+
+namespace cg
+{
+
+/**
+ * Set the 6 planes bounding the room (100 x 100 x 100, floor at z = 0).
+ * Normals point into the room.
+ * @param  bounding_planes  Planes to fill.
+ */
+void initialize_bounding_planes(std::vector<Plane> &bounding_planes);
+
+} // namespace cg
+
+#endif
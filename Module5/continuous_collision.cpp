@@ -0,0 +1,580 @@
+#include "Module5/continuous_collision.hpp"
+
+#include "geometry/geometry.hpp"
+#include "profiler/profiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace cg
+{
+
+// Events resolved per awake ball before giving up on an island (guards against
+// balls wedged between others generating events forever)
+constexpr uint32_t MAX_EVENTS_PER_BALL = 32;
+
+// Fewer awake balls than this are solved on the calling thread
+constexpr uint32_t MIN_PARALLEL_BALLS = 64;
+
+ContinuousCollisionSolver::ContinuousCollisionSolver()
+    : restitution_(1.0f), sleep_speed_(0.5f), sleep_delay_(0.5f),
+      thread_count_(std::max(std::thread::hardware_concurrency(), 1u)), dt_(0.0f),
+      max_sleeper_radius_(0.0f)
+{
+}
+
+ContinuousCollisionSolver::~ContinuousCollisionSolver() = default;
+
+void ContinuousCollisionSolver::set_restitution(float restitution)
+{
+    restitution_ = std::clamp(restitution, 0.0f, 1.0f);
+}
+
+void ContinuousCollisionSolver::set_sleep_threshold(float speed, float delay)
+{
+    sleep_speed_ = speed;
+    sleep_delay_ = delay;
+}
+
+void ContinuousCollisionSolver::set_thread_count(uint32_t thread_count)
+{
+    thread_count_ = std::max(thread_count, 1u);
+    thread_pool_.reset();
+}
+
+void ContinuousCollisionSolver::step(std::vector<std::shared_ptr<BallTransform>> &balls,
+                                     const std::vector<Plane> &bounding_planes,
+                                     float                     dt)
+{
+    CG_PROFILE_SCOPE("ContinuousCollisionSolver::step");
+
+    stats_ = ContinuousCollisionStats();
+    dt_ = dt;
+    update_sleepers(balls);
+    load(balls, 0.0f);
+    find_candidate_pairs();
+    build_islands();
+    if(!solve(bounding_planes))
+    {
+        // Redo the step with every ball bounded by the energy of all the balls.
+        // Sleeping balls are at rest, so the awake balls hold all of it
+        uint32_t escapes = stats_.escapes;
+        stats_ = ContinuousCollisionStats();
+        stats_.escapes = escapes;
+        stats_.energy_bound = true;
+        float energy = 0.0f;
+        for(uint32_t b : awake_balls_)
+            energy += balls[b]->getVelocity().norm_squared() * balls[b]->getMass();
+        load(balls, energy);
+        find_candidate_pairs();
+        build_islands();
+        solve(bounding_planes);
+    }
+
+    // Move the awake balls to the end of the step and put slow ones to sleep
+    for(uint32_t k : island_order_)
+    {
+        for(uint32_t m = island_start_[k]; m < island_start_[k + 1]; ++m)
+        {
+            uint32_t i = island_balls_[m];
+            if(!awake_[i]) continue;
+
+            BallTransform &ball = *balls[global_[i]];
+            advance(i, dt);
+            float still_time = 0.0f;
+            bool  sleeping = false;
+            if(velocity_[i].norm() < sleep_speed_)
+            {
+                still_time = ball.getStillTime() + dt;
+                sleeping = still_time >= sleep_delay_;
+                if(sleeping) velocity_[i].set(0.0f, 0.0f, 0.0f);
+            }
+            ball.setPosition(position_[i]);
+            ball.setVelocity(velocity_[i]);
+            ball.setStillTime(still_time);
+            ball.setSleeping(sleeping);
+            ball.clearCollision();
+            ++stats_.awake;
+            if(sleeping) ++stats_.sleeping;
+        }
+    }
+    stats_.sleeping += static_cast<uint32_t>(balls.size()) - stats_.awake;
+}
+
+const ContinuousCollisionStats &ContinuousCollisionSolver::get_stats() const { return stats_; }
+
+void ContinuousCollisionSolver::update_sleepers(
+    const std::vector<std::shared_ptr<BallTransform>> &balls)
+{
+    // A ball is indexed while it sleeps at the position it was indexed at.
+    // Entries of balls woken, moved or replaced since are removed
+    uint32_t n = static_cast<uint32_t>(balls.size());
+    bool     removed = n < indexed_.size();
+    indexed_.resize(n, nullptr);
+    indexed_at_.resize(n);
+    awake_balls_.clear();
+    new_sleepers_.clear();
+    for(uint32_t i = 0; i < n; ++i)
+    {
+        const BallTransform *ball = balls[i].get();
+        if(!ball->isSleeping())
+        {
+            awake_balls_.push_back(i);
+            if(indexed_[i] != nullptr)
+            {
+                indexed_[i] = nullptr;
+                removed = true;
+            }
+            continue;
+        }
+        Point3 position = ball->getPosition();
+        if(indexed_[i] == ball && indexed_at_[i] == position) continue;
+
+        removed = removed || indexed_[i] != nullptr;
+        indexed_[i] = ball;
+        indexed_at_[i] = position;
+        new_sleepers_.push_back({position, ball->getRadius(), i, ball});
+    }
+    if(!removed && new_sleepers_.empty()) return;
+
+    // Drop stale entries, then merge in the new sleepers sorted by x
+    auto by_x = [](const Sleeper &a, const Sleeper &b) { return a.position.x < b.position.x; };
+    if(removed)
+    {
+        auto stale = [this, n](const Sleeper &e)
+        {
+            return e.ball >= n || indexed_[e.ball] != e.transform ||
+                   !(indexed_at_[e.ball] == e.position);
+        };
+        sleepers_.erase(std::remove_if(sleepers_.begin(), sleepers_.end(), stale),
+                        sleepers_.end());
+    }
+    std::sort(new_sleepers_.begin(), new_sleepers_.end(), by_x);
+    size_t old_count = sleepers_.size();
+    sleepers_.insert(sleepers_.end(), new_sleepers_.begin(), new_sleepers_.end());
+    std::inplace_merge(sleepers_.begin(), sleepers_.begin() + old_count, sleepers_.end(), by_x);
+    max_sleeper_radius_ = 0.0f;
+    for(const auto &e : sleepers_) max_sleeper_radius_ = std::max(max_sleeper_radius_, e.radius);
+}
+
+void ContinuousCollisionSolver::add_ball(const BallTransform &ball, uint32_t index, bool awake,
+                                         float reach)
+{
+    local_[index] = static_cast<uint32_t>(global_.size());
+    global_.push_back(index);
+    position_.push_back(ball.getPosition());
+    velocity_.push_back(awake ? ball.getVelocity() : Vector3(0.0f, 0.0f, 0.0f));
+    radius_.push_back(ball.getRadius());
+    inv_mass_.push_back(1.0f / ball.getMass());
+    awake_.push_back(awake ? 1 : 0);
+    reach_.push_back(reach);
+}
+
+void ContinuousCollisionSolver::load(const std::vector<std::shared_ptr<BallTransform>> &balls,
+                                     float energy)
+{
+    // Forget the previous active set
+    uint32_t n = static_cast<uint32_t>(balls.size());
+    if(local_.size() != n)
+        local_.assign(n, UINT32_MAX);
+    else
+    {
+        for(uint32_t b : global_) local_[b] = UINT32_MAX;
+    }
+    global_.clear();
+    position_.clear();
+    velocity_.clear();
+    radius_.clear();
+    inv_mass_.clear();
+    awake_.clear();
+    reach_.clear();
+
+    // Distance each ball can reach this step. Without an energy bound an awake
+    // ball is bounded by its own speed, widened by its radius again to cover
+    // being pushed apart from an overlapping ball (at most its radius). A
+    // sleeping ball is bounded by twice the fastest awake ball, the most a
+    // collision can give a ball at rest. Balls sped up more escape their reach
+    // and the step is redone with every reach widened and sized by the energy
+    float max_speed = 0.0f;
+    for(uint32_t b : awake_balls_) max_speed = std::max(max_speed, balls[b]->getVelocity().norm());
+    auto reach = [this, energy, max_speed](const BallTransform &ball, bool awake)
+    {
+        if(energy > 0.0f)
+            return 2.0f * ball.getRadius() + std::sqrt(energy / ball.getMass()) * dt_;
+        if(awake) return 2.0f * ball.getRadius() + ball.getVelocity().norm() * dt_;
+        return ball.getRadius() + 2.0f * max_speed * dt_;
+    };
+    for(uint32_t b : awake_balls_) add_ball(*balls[b], b, true, reach(*balls[b], true));
+
+    // Add the sleeping balls an active ball can touch (one staying within its
+    // reach), and those they can touch in turn. Other sleeping balls stay at
+    // rest through the step, so they are not loaded
+    for(uint32_t i = 0; i < global_.size(); ++i)
+    {
+        Point3 p = position_[i];
+        float  window = reach_[i] + max_sleeper_radius_;
+        auto   e = std::lower_bound(sleepers_.begin(), sleepers_.end(), p.x - window,
+                                    [](const Sleeper &s, float x) { return s.position.x < x; });
+        for(; e != sleepers_.end() && e->position.x <= p.x + window; ++e)
+        {
+            if(local_[e->ball] != UINT32_MAX) continue;
+
+            float   touch = reach_[i] + e->radius;
+            Vector3 separation(p, e->position);
+            if(separation.norm_squared() > touch * touch) continue;
+
+            add_ball(*balls[e->ball], e->ball, false, reach(*balls[e->ball], false));
+        }
+    }
+
+    uint32_t count = static_cast<uint32_t>(global_.size());
+    time_.assign(count, 0.0f);
+    count_.assign(count, 0);
+    stats_.active = count;
+}
+
+void ContinuousCollisionSolver::find_candidate_pairs()
+{
+    uint32_t n = static_cast<uint32_t>(position_.size());
+    start_ = position_;
+    intervals_.resize(n);
+    for(uint32_t i = 0; i < n; ++i)
+        intervals_[i] = {position_[i].x - reach_[i], position_[i].x + reach_[i], i};
+    std::sort(intervals_.begin(), intervals_.end(),
+              [](const Interval &a, const Interval &b) { return a.min_x < b.min_x; });
+
+    // Sweep: each interval overlaps the following ones that start before it ends.
+    // Pairs overlapping in x are kept if the spheres they can reach overlap.
+    // Pairs of sleeping balls are kept so a ball woken in an island can only
+    // hit balls in the island
+    candidates_.resize(n);
+    for(auto &c : candidates_) c.clear();
+    stats_.candidate_pairs = 0;
+    for(uint32_t i = 0; i < n; ++i)
+    {
+        uint32_t a = intervals_[i].ball;
+        for(uint32_t j = i + 1; j < n && intervals_[j].min_x <= intervals_[i].max_x; ++j)
+        {
+            uint32_t b = intervals_[j].ball;
+            float   reach = reach_[a] + reach_[b];
+            Vector3 separation(start_[a], start_[b]);
+            if(separation.norm_squared() > reach * reach) continue;
+
+            candidates_[a].push_back(b);
+            candidates_[b].push_back(a);
+            ++stats_.candidate_pairs;
+        }
+    }
+}
+
+uint32_t ContinuousCollisionSolver::find_root(uint32_t i)
+{
+    // Path halving
+    while(parent_[i] != i)
+    {
+        parent_[i] = parent_[parent_[i]];
+        i = parent_[i];
+    }
+    return i;
+}
+
+void ContinuousCollisionSolver::build_islands()
+{
+    // Union the candidate pairs
+    uint32_t n = static_cast<uint32_t>(position_.size());
+    parent_.resize(n);
+    for(uint32_t i = 0; i < n; ++i) parent_[i] = i;
+    for(uint32_t i = 0; i < n; ++i)
+    {
+        for(uint32_t j : candidates_[i])
+        {
+            uint32_t root_i = find_root(i);
+            uint32_t root_j = find_root(j);
+            if(root_i != root_j) parent_[std::max(root_i, root_j)] = std::min(root_i, root_j);
+        }
+    }
+
+    // Number the islands and bucket their balls (counting sort by island)
+    island_of_.assign(n, UINT32_MAX);
+    island_start_.clear();
+    for(uint32_t i = 0; i < n; ++i)
+    {
+        uint32_t root = find_root(i);
+        if(island_of_[root] == UINT32_MAX)
+        {
+            island_of_[root] = static_cast<uint32_t>(island_start_.size());
+            island_start_.push_back(0);
+        }
+        island_of_[i] = island_of_[root];
+        ++island_start_[island_of_[i]];
+    }
+    uint32_t island_count = static_cast<uint32_t>(island_start_.size());
+    uint32_t total = 0;
+    for(auto &start : island_start_)
+    {
+        uint32_t size = start;
+        start = total;
+        total += size;
+    }
+    island_start_.push_back(total);
+    island_balls_.resize(n);
+    // The forest is no longer needed, so its storage holds the next slot of each island
+    std::vector<uint32_t> &next = parent_;
+    next.assign(island_start_.begin(), island_start_.end() - 1);
+    for(uint32_t i = 0; i < n; ++i) island_balls_[next[island_of_[i]]++] = i;
+
+    // Islands with an awake ball are solved
+    island_order_.clear();
+    stats_.islands = 0;
+    stats_.largest_island = 0;
+    stats_.island_sizes.fill(0);
+    for(uint32_t k = 0; k < island_count; ++k)
+    {
+        bool has_awake = false;
+        for(uint32_t m = island_start_[k]; m < island_start_[k + 1] && !has_awake; ++m)
+            has_awake = awake_[island_balls_[m]];
+        if(!has_awake) continue;
+
+        uint32_t size = island_start_[k + 1] - island_start_[k];
+        uint32_t bucket = 0;
+        while(bucket + 1 < ISLAND_SIZE_BUCKETS && (1u << bucket) < size) ++bucket;
+        ++stats_.island_sizes[bucket];
+        ++stats_.islands;
+        stats_.largest_island = std::max(stats_.largest_island, size);
+        island_order_.push_back(k);
+    }
+
+    // Largest first, so the thread pool finishes the long islands early
+    std::sort(island_order_.begin(), island_order_.end(),
+              [this](uint32_t a, uint32_t b)
+              {
+                  return island_start_[a + 1] - island_start_[a] >
+                         island_start_[b + 1] - island_start_[b];
+              });
+}
+
+bool ContinuousCollisionSolver::solve(const std::vector<Plane> &bounding_planes)
+{
+    if(!separate_overlaps()) return false;
+
+    // Solve the islands, in parallel when there is enough work
+    uint32_t awake_count = 0;
+    for(uint8_t awake : awake_) awake_count += awake;
+    uint32_t threads = (awake_count >= MIN_PARALLEL_BALLS) ? thread_count_ : 1;
+    if(threads > 1 && (!thread_pool_ || thread_pool_->get_worker_count() != threads))
+        thread_pool_ = std::make_unique<ThreadPool>(threads - 1);
+    work_.resize(threads);
+    for(auto &w : work_) w = IslandWork();
+    auto solve_item = [&](uint32_t k, uint32_t worker)
+    { solve_island(island_order_[k], work_[worker], bounding_planes); };
+    uint32_t island_count = static_cast<uint32_t>(island_order_.size());
+    if(threads > 1)
+        thread_pool_->parallel_for(island_count, solve_item);
+    else
+    {
+        for(uint32_t k = 0; k < island_count; ++k) solve_item(k, 0);
+    }
+
+    for(const auto &w : work_)
+    {
+        stats_.events += w.event_count;
+        stats_.stale_events += w.stale_events;
+        stats_.woken += w.woken;
+        stats_.escapes += w.escapes;
+        stats_.event_limit = stats_.event_limit || w.event_limit;
+    }
+    return stats_.escapes == 0;
+}
+
+bool ContinuousCollisionSolver::separate_overlaps()
+{
+    // Runs before the islands are solved, so it may wake balls in any island
+    uint32_t n = static_cast<uint32_t>(position_.size());
+    for(uint32_t i = 0; i < n; ++i)
+    {
+        for(uint32_t j : candidates_[i])
+        {
+            if(j < i || (!awake_[i] && !awake_[j])) continue;
+
+            Vector3 separation(position_[i], position_[j]);
+            float   distance = separation.norm();
+            float   overlap = radius_[i] + radius_[j] - distance;
+            if(overlap <= 0.0f || distance < 0.001f) continue;
+
+            // Move each ball half the overlap along the line of centers and
+            // bounce them if they are still approaching
+            ++stats_.overlaps;
+            if(!awake_[i] || !awake_[j])
+            {
+                awake_[i] = awake_[j] = 1;
+                ++stats_.woken;
+            }
+            separation *= 1.0f / distance;
+            Vector3 move = separation * (overlap * 0.5f);
+            position_[i] = position_[i] - move;
+            position_[j] = position_[j] + move;
+            if((velocity_[j] - velocity_[i]).dot(separation) < 0.0f) bounce(j, i, separation);
+            if(!in_reach(i, 0.0f) || !in_reach(j, 0.0f))
+            {
+                ++stats_.escapes;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void ContinuousCollisionSolver::solve_island(uint32_t                  island,
+                                             IslandWork               &work,
+                                             const std::vector<Plane> &bounding_planes)
+{
+    // Only this island's balls are read or written, so islands can be solved at once
+    work.events.clear();
+    uint32_t awake_count = 0;
+    for(uint32_t m = island_start_[island]; m < island_start_[island + 1]; ++m)
+    {
+        uint32_t i = island_balls_[m];
+        if(!awake_[i]) continue;
+        ++awake_count;
+        predict(i, 0.0f, bounding_planes, true, work);
+    }
+
+    uint32_t max_events = work.event_count + MAX_EVENTS_PER_BALL * awake_count;
+    while(!work.events.empty())
+    {
+        std::pop_heap(work.events.begin(), work.events.end(), std::greater<CollisionEvent>());
+        CollisionEvent e = work.events.back();
+        work.events.pop_back();
+        if(e.count_a != count_[e.a] || (!e.is_wall && e.count_b != count_[e.b]))
+        {
+            ++work.stale_events;
+            continue;
+        }
+        if(work.event_count == max_events)
+        {
+            work.event_limit = true;
+            break;
+        }
+        ++work.event_count;
+
+        if(e.is_wall)
+        {
+            // Replace the normal velocity toward the wall with the bounce
+            advance(e.a, e.time);
+            const Vector3 &normal = bounding_planes[e.b].get_normal();
+            float          approach = velocity_[e.a].dot(normal);
+            velocity_[e.a] -= normal * (approach - restitution_target(approach, restitution_));
+            ++count_[e.a];
+            predict(e.a, e.time, bounding_planes, false, work);
+        }
+        else
+        {
+            // A sleeping ball has been at rest since the start of the step
+            if(!awake_[e.b])
+            {
+                awake_[e.b] = 1;
+                time_[e.b] = e.time;
+                ++work.woken;
+            }
+            advance(e.a, e.time);
+            advance(e.b, e.time);
+            Vector3 normal(position_[e.b], position_[e.a]);
+            normal.normalize();
+            bounce(e.a, e.b, normal);
+            if(!in_reach(e.a, e.time) || !in_reach(e.b, e.time))
+            {
+                ++work.escapes;
+                break;
+            }
+            ++count_[e.a];
+            ++count_[e.b];
+            predict(e.a, e.time, bounding_planes, false, work);
+            predict(e.b, e.time, bounding_planes, false, work);
+        }
+    }
+}
+
+bool ContinuousCollisionSolver::in_reach(uint32_t i, float now) const
+{
+    // Farthest the ball can get from its start by the end of the step unless
+    // another ball speeds it up (bouncing off walls never does)
+    Vector3 moved(start_[i], position_at(i, now));
+    return radius_[i] + moved.norm() + velocity_[i].norm() * (dt_ - now) <= reach_[i];
+}
+
+void ContinuousCollisionSolver::bounce(uint32_t i, uint32_t j, const Vector3 &normal)
+{
+    // Impulse along the normal (from j to i) reaching the restitution target,
+    // pushing only. Elastic collisions of equal masses exchange their velocity
+    // components along the normal
+    float approach = (velocity_[i] - velocity_[j]).dot(normal);
+    float impulse = std::min(approach - restitution_target(approach, restitution_), 0.0f) /
+                    (inv_mass_[i] + inv_mass_[j]);
+    velocity_[i] -= normal * (impulse * inv_mass_[i]);
+    velocity_[j] += normal * (impulse * inv_mass_[j]);
+}
+
+Point3 ContinuousCollisionSolver::position_at(uint32_t i, float t) const
+{
+    return position_[i] + velocity_[i] * (t - time_[i]);
+}
+
+void ContinuousCollisionSolver::advance(uint32_t i, float t)
+{
+    position_[i] = position_at(i, t);
+    time_[i] = t;
+}
+
+void ContinuousCollisionSolver::predict(uint32_t                  i,
+                                        float                     now,
+                                        const std::vector<Plane> &bounding_planes,
+                                        bool                      pairs_above,
+                                        IslandWork               &work)
+{
+    auto push = [&work](const CollisionEvent &e)
+    {
+        work.events.push_back(e);
+        std::push_heap(work.events.begin(), work.events.end(), std::greater<CollisionEvent>());
+    };
+    Point3 p = position_at(i, now);
+
+    // Walls: time until the ball's surface reaches the plane, if moving toward it
+    for(uint32_t w = 0; w < bounding_planes.size(); ++w)
+    {
+        float approach = -velocity_[i].dot(bounding_planes[w].get_normal());
+        if(approach <= 0.0f) continue;
+
+        float gap = std::max(bounding_planes[w].solve(p) - radius_[i], 0.0f);
+        float t = now + gap / approach;
+        if(t <= dt_) push({t, i, w, true, count_[i], 0});
+    }
+
+    // Balls: smallest t >= 0 with |dp + dv * t| = r_i + r_j, if approaching.
+    // Sleeping balls are at rest at their position
+    for(uint32_t j : candidates_[i])
+    {
+        if(pairs_above && awake_[j] && j < i) continue;
+
+        Vector3 dp(p, awake_[j] ? position_at(j, now) : position_[j]);
+        Vector3 dv = velocity_[j] - velocity_[i];
+        float   b = dp.dot(dv);
+        if(b >= 0.0f) continue;
+
+        // Balls still overlapping (a pair only partly pushed apart at the start of
+        // the step) are skipped. Colliding them now could chatter without end
+        float r = radius_[i] + radius_[j];
+        float c = dp.dot(dp) - r * r;
+        if(c < 0.0f) continue;
+
+        float a = dv.dot(dv);
+        float discriminant = b * b - a * c;
+        if(discriminant < 0.0f) continue;
+
+        // Stable form of (-b - sqrt(discriminant)) / a
+        float t = now + c / (std::sqrt(discriminant) - b);
+        if(t <= dt_) push({t, i, j, false, count_[i], count_[j]});
+    }
+}
+
+} // namespace cg
@@ -0,0 +1,297 @@
+//============================================================================
+//	Johns Hopkins University Engineering Programs for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:	David W. Nesbitt
+//	File:    continuous_collision.hpp
+//	Purpose: Event driven continuous collision of the balls with each other
+//           and the walls of the room.
+//
+//============================================================================
+
+#ifndef __MODULE5_CONTINUOUS_COLLISION_HPP__
+#define __MODULE5_CONTINUOUS_COLLISION_HPP__
+
+#include "Module5/ball_transform.hpp"
+#include "Module5/thread_pool.hpp"
+#include "geometry/plane.hpp"
+
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace cg
+{
+
+// Contacts approaching slower than this (units/second) get no bounce, so balls
+// pressed together come to rest instead of jittering
+constexpr float RESTITUTION_SPEED = 0.5f;
+
+/**
+ * Normal velocity of a contact after the collision, given its normal velocity
+ * before (negative when approaching). Returns a fraction of the approach speed,
+ * or 0 for contacts approaching slower than RESTITUTION_SPEED.
+ * @param  approach     Normal velocity before the collision.
+ * @param  restitution  Fraction of the approach speed returned (0 to 1).
+ * @return  Returns the normal velocity after the collision.
+ */
+inline float restitution_target(float approach, float restitution)
+{
+    return approach < -RESTITUTION_SPEED ? -restitution * approach : 0.0f;
+}
+
+/**
+ * Predicted collision of a ball with another ball or a wall. The event is
+ * stale if either ball has collided since it was predicted.
+ */
+struct CollisionEvent
+{
+    float    time;    // Time of impact from the start of the step
+    uint32_t a;       // Ball index
+    uint32_t b;       // Other ball index, or wall index if is_wall
+    bool     is_wall;
+    uint32_t count_a; // Collision count of each ball when predicted
+    uint32_t count_b;
+
+    bool operator>(const CollisionEvent &e) const { return time > e.time; }
+};
+
+// Buckets of the island size histogram: sizes 1, 2, 3-4, 5-8, ..., 65 and up
+constexpr uint32_t ISLAND_SIZE_BUCKETS = 8;
+
+/**
+ * Counts from the last step.
+ */
+struct ContinuousCollisionStats
+{
+    uint32_t awake = 0;           // Balls simulated this step
+    uint32_t active = 0;          // Balls loaded: the awake balls and sleeping balls they can touch
+    uint32_t sleeping = 0;        // Balls asleep at the end of the step
+    uint32_t woken = 0;           // Sleeping balls woken by a contact
+    uint32_t candidate_pairs = 0; // Ball pairs passed by the broadphase
+    uint32_t overlaps = 0;        // Pairs found overlapping at the start of the step
+    uint32_t events = 0;          // Collisions resolved
+    uint32_t stale_events = 0;    // Events skipped because a ball collided first
+    bool     event_limit = false; // An island stopped early after too many events
+
+    uint32_t islands = 0;          // Islands solved (each has an awake ball)
+    uint32_t largest_island = 0;   // Balls in the largest island
+    uint32_t escapes = 0;          // Islands where a ball outran its reach
+    bool     energy_bound = false; // Step redone with reach sized by energy
+    std::array<uint32_t, ISLAND_SIZE_BUCKETS> island_sizes{}; // Island size histogram
+};
+
+/**
+ * Moves the balls through a time step, resolving every collision in time of
+ * impact order. Balls move in straight lines between events, so only the balls
+ * in an event are advanced and re-predicted when it is processed. Results do
+ * not depend on the step size, so the simulation can take large steps without
+ * balls tunnelling through walls or each other. Balls bounce off walls and
+ * off each other with an impulse along the contact normal, returning the
+ * restitution fraction of the approach speed (see restitution_target). Ball
+ * masses are proportional to their volume (see BallTransform::getMass), so
+ * collisions conserve momentum.
+ *
+ * Balls slower than the sleep speed for the sleep delay are put to sleep (at
+ * rest). Only awake balls are integrated and tested against the walls, and
+ * only pairs with an awake ball are tested. A sleeping ball wakes when an
+ * awake ball hits it.
+ *
+ * Each step works on an active set: the awake balls and the sleeping balls
+ * they can touch, found through an index of the sleeping balls sorted by x
+ * (kept between steps and updated as balls fall asleep or wake). Sleeping
+ * balls out of reach are not loaded, so a mostly settled room costs little
+ * more than its awake balls.
+ *
+ * The broadphase sweeps and prunes along x using, for each active ball, the
+ * sphere it can reach during the step at its current speed, then checks the
+ * distance.
+ * Union-find over the candidate pairs splits the balls into islands, which are
+ * solved independently on a thread pool. A ball sped up by a collision may
+ * outrun its sphere and reach another island; the step is then redone with
+ * spheres sized by the energy of all the balls (a ball of mass m cannot get
+ * faster than sqrt(sum of m v^2 / m)), which is slower but always safe.
+ */
+class ContinuousCollisionSolver
+{
+  public:
+    /**
+     * Constructor. Restitution 1 (elastic, except that contacts approaching
+     * slower than RESTITUTION_SPEED stop along the normal). Balls sleep after
+     * 0.5 seconds slower than 0.5 units/second. Islands are solved on one
+     * thread per hardware thread.
+     */
+    ContinuousCollisionSolver();
+
+    /**
+     * Destructor.
+     */
+    ~ContinuousCollisionSolver();
+
+    /**
+     * Set the restitution coefficient of ball and wall collisions.
+     * @param  restitution  Fraction of the approach speed returned (0 to 1).
+     */
+    void set_restitution(float restitution);
+
+    /**
+     * Set when balls go to sleep.
+     * @param  speed  Balls slower than this may sleep (0 disables sleeping).
+     * @param  delay  Time in seconds a ball must stay slower than speed to sleep.
+     */
+    void set_sleep_threshold(float speed, float delay);
+
+    /**
+     * Set the number of threads solving islands (including the caller).
+     * @param  thread_count  Number of threads (1 solves on the calling thread).
+     */
+    void set_thread_count(uint32_t thread_count);
+
+    /**
+     * Advance the balls by a time step. Sets the position, velocity and
+     * sleeping state of each awake ball; the balls should be set to be moved
+     * by the solver (see BallTransform::setMovedBySolver) so their update does
+     * not move them again.
+     * @param  balls            Balls to move.
+     * @param  bounding_planes  Walls of the room (normals point into the room).
+     * @param  dt               Time step in seconds.
+     */
+    void step(std::vector<std::shared_ptr<BallTransform>> &balls,
+              const std::vector<Plane>                    &bounding_planes,
+              float                                        dt);
+
+    /**
+     * Get the counts from the last step.
+     * @return  Returns the statistics of the last step.
+     */
+    const ContinuousCollisionStats &get_stats() const;
+
+  protected:
+    // Ball x interval for the broadphase
+    struct Interval
+    {
+        float    min_x;
+        float    max_x;
+        uint32_t ball;
+    };
+
+    // Sleeping ball in the sleeper index
+    struct Sleeper
+    {
+        Point3               position;
+        float                radius;
+        uint32_t             ball;      // Index in the ball list
+        const BallTransform *transform; // Ball indexed, to detect a replaced list
+    };
+
+    // Scratch data of a thread solving islands
+    struct IslandWork
+    {
+        std::vector<CollisionEvent> events; // Heap ordered by time
+        uint32_t                    event_count = 0;
+        uint32_t                    stale_events = 0;
+        uint32_t                    woken = 0;
+        uint32_t                    escapes = 0;
+        bool                        event_limit = false;
+    };
+
+    float                       restitution_;
+    float                       sleep_speed_;
+    float                       sleep_delay_;
+    uint32_t                    thread_count_;
+    std::unique_ptr<ThreadPool> thread_pool_;
+    float                       dt_;
+
+    // Sleeper index: sleeping balls sorted by x. Ball b is indexed while it
+    // sleeps at indexed_at_[b]
+    std::vector<Sleeper>               sleepers_;
+    std::vector<Sleeper>               new_sleepers_;
+    std::vector<const BallTransform *> indexed_;
+    std::vector<Point3>                indexed_at_;
+    float                              max_sleeper_radius_;
+    std::vector<uint32_t>              awake_balls_; // Indexes of the awake balls
+
+    // Active set. Ball state below is indexed by active ball; global_ maps it
+    // to the ball list and local_ back (UINT32_MAX if not active)
+    std::vector<uint32_t> global_;
+    std::vector<uint32_t> local_;
+
+    // Ball state. Position is at time_[i]; balls are advanced lazily
+    std::vector<Point3>   position_;
+    std::vector<Vector3>  velocity_;
+    std::vector<float>    radius_;
+    std::vector<float>    inv_mass_;
+    std::vector<float>    time_;
+    std::vector<uint32_t> count_;
+    std::vector<uint8_t>  awake_;
+
+    // Broadphase. Each ball must stay within reach_[i] of its start
+    std::vector<Point3>                start_;
+    std::vector<float>                 reach_;
+    std::vector<Interval>              intervals_;
+    std::vector<std::vector<uint32_t>> candidates_; // Broadphase neighbors of each ball
+
+    // Islands. Balls of island k are island_balls_[island_start_[k] to island_start_[k + 1])
+    std::vector<uint32_t>   parent_; // Union-find forest
+    std::vector<uint32_t>   island_of_;
+    std::vector<uint32_t>   island_start_;
+    std::vector<uint32_t>   island_balls_;
+    std::vector<uint32_t>   island_order_; // Islands with an awake ball, largest first
+    std::vector<IslandWork> work_;
+
+    ContinuousCollisionStats stats_;
+
+    // List the awake balls and bring the sleeper index up to date
+    void update_sleepers(const std::vector<std::shared_ptr<BallTransform>> &balls);
+
+    // Load the state of the active set at the start of the step. If energy is
+    // positive every reach is sized by it (sum of m v^2 over the balls)
+    void load(const std::vector<std::shared_ptr<BallTransform>> &balls, float energy);
+
+    // Add a ball to the active set
+    void add_ball(const BallTransform &ball, uint32_t index, bool awake, float reach);
+
+    // Find the pairs of balls that can reach each other
+    void find_candidate_pairs();
+
+    // Group balls joined by candidate pairs into islands
+    void build_islands();
+
+    // Find the root of a ball's union-find tree
+    uint32_t find_root(uint32_t i);
+
+    // Resolve the collisions of every island. Returns false if a ball escaped its reach
+    bool solve(const std::vector<Plane> &bounding_planes);
+
+    // Push apart balls that start the step overlapping, bouncing those approaching.
+    // Returns false if a ball escaped its reach
+    bool separate_overlaps();
+
+    // Resolve the collisions of an island, stopping if a ball escapes its reach
+    void solve_island(uint32_t island, IslandWork &work, const std::vector<Plane> &bounding_planes);
+
+    // Check that ball i, at time now, stays in its reach for the rest of the step
+    bool in_reach(uint32_t i, float now) const;
+
+    // Bounce 2 balls in contact off each other
+    void bounce(uint32_t i, uint32_t j, const Vector3 &normal);
+
+    // Position of ball i at time t
+    Point3 position_at(uint32_t i, float t) const;
+
+    // Move ball i to time t
+    void advance(uint32_t i, float t);
+
+    // Predict the collisions of awake ball i from time now. If pairs_above is true
+    // pairs with lower awake ball indexes are skipped (so each pair is predicted once)
+    void predict(uint32_t                  i,
+                 float                     now,
+                 const std::vector<Plane> &bounding_planes,
+                 bool                      pairs_above,
+                 IslandWork               &work);
+};
+
+} // namespace cg
+
+#endif
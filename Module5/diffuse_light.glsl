@@ -0,0 +1,15 @@
+// Diffuse lighting shared by the lighting shaders (include after the uniforms)
+
+// Fixed light position in world coordinates. Light is behind the camera in
+// world coordinates and is hard-coded here for now!
+const vec3 light_position = vec3(0.0, -100.0, 50.0f);
+
+// Diffuse color at a world position with world normal N
+vec4 diffuse_light(vec3 N, vec4 world_position)
+{
+    // Construct L - from vertex to light
+    vec3 L = normalize(vec3(light_position - vec3(world_position)));
+
+    // The diffuse shading equation. Intnesity depends on cos of L and N
+    return vec4(material_color * max(dot(L, N), 0.0), 1.0);
+}
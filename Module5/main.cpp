@@ -13,13 +13,18 @@
 //
 //============================================================================
 
+#include "filesystem_support/asset_archive.hpp"
 #include "filesystem_support/file_locator.hpp"
+#include "filesystem_support/file_watcher.hpp"
 #include "geometry/bounding_sphere.hpp"
 #include "geometry/geometry.hpp"
+#include "logging/logger.hpp"
+#include "profiler/profiler.hpp"
 #include "geometry/plane.hpp"
 #include "scene/color_node.hpp"
 #include "scene/graphics.hpp"
 #include "scene/scene.hpp"
+#include "shader_support/program_cache.hpp"
 
 #include "Module5/lighting_shader_node.hpp"
 #include "Module5/unit_square_node.hpp"
@@ -31,24 +36,22 @@
 #include <vector>
 #include "Module5/unit_sphere_node.hpp"
 #include <Module5/ball_transform.hpp>
+#include "Module5/collision.hpp"
+#include "Module5/continuous_collision.hpp"
 //for random
 #include <cstdlib>
 #include <ctime>
 namespace cg
 {
 
-// Simple logging function, should be defined in the cg namespace
+// Simple logging function, should be defined in the cg namespace. Messages go
+// to the asynchronous logger (opened in main) at info level, and are truncated
+// to LOG_MESSAGE_SIZE - 1 characters
 void logmsg(const char *message, ...)
 {
-    // Open file if not already opened
-    static FILE *lfile = NULL;
-    if(lfile == NULL) { lfile = fopen("Module5.log", "w"); }
-
     va_list arg;
     va_start(arg, message);
-    vfprintf(lfile, message, arg);
-    putc('\n', lfile);
-    fflush(lfile);
+    log_message_v(LogLevel::INFO, message, arg);
     va_end(arg);
 }
 
@@ -60,15 +63,32 @@ constexpr int32_t DRAWS_PER_SECOND = 72;
 constexpr int32_t DRAW_INTERVAL_MILLIS =
     static_cast<int32_t>(1000.0 / static_cast<double>(DRAWS_PER_SECOND));
 
+// Watches shader files for hot reload (declared before the scene so it outlives it)
+cg::FileWatcher g_file_watcher;
+
 // Root of the scene graph
 std::shared_ptr<cg::SceneNode> g_scene_root;
 
+// GPU and CPU time of each frame, and GPU time of the lighting subtree
+cg::GpuTimer                      g_frame_timer;
+std::shared_ptr<cg::GpuTimerNode> g_lighting_timer;
+float                             g_frame_cpu_ms = 0.0f;
+bool                              g_log_frame_times = false;
+uint32_t                          g_frame_count = 0;
+
 cg::SceneState g_scene_state;
 
 std::shared_ptr<cg::BallTransform> g_test_ball;
 std::vector<std::shared_ptr<cg::BallTransform>> g_balls;
 std::vector<cg::Plane> g_bounding_planes;
 
+// Moves the balls each frame, resolving collisions in time of impact order
+cg::ContinuousCollisionSolver g_collision_solver;
+
+// Fraction of the approach speed kept by a bounce. The room has no gravity or
+// other energy input, so below 1 the balls slow down until they all sleep
+constexpr float BALL_RESTITUTION = 1.0f;
+
 
 //function to assist in ball creation 
 void create_balls(std::shared_ptr<cg::UnitSphere> unit_sphere,
@@ -121,7 +141,8 @@ void create_balls(std::shared_ptr<cg::UnitSphere> unit_sphere,
          ball_color->add_child(ball_transform);
          ball_transform->add_child(unit_sphere);
 
-         //add to global list 
+         //add to global list (the collision solver moves the balls)
+         ball_transform->setMovedBySolver(true);
          g_balls.push_back(ball_transform);
       }
    }
@@ -137,12 +158,29 @@ void sleep(int32_t milliseconds)
  */
 void display()
 {
+    CG_PROFILE_SCOPE("display");
+
     // Clear the framebuffer and the depth buffer
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    // Init scene state and draw the scene graph
+    // Init scene state and draw the scene graph, timing it on the CPU and GPU
+    auto start = std::chrono::steady_clock::now();
+    g_frame_timer.begin();
     g_scene_state.init();
     g_scene_root->draw(g_scene_state);
+    g_frame_timer.end();
+    g_frame_cpu_ms =
+        std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    // GPU times lag a few frames behind
+    ++g_frame_count;
+    if(g_log_frame_times)
+    {
+        cg::logmsg("Frame %u: CPU %.3f ms GPU %.3f ms, %s GPU %.3f ms CPU %.3f ms",
+                   g_frame_count, g_frame_cpu_ms, g_frame_timer.get_elapsed_ms(),
+                   g_lighting_timer->get_name().c_str(), g_lighting_timer->get_gpu_ms(),
+                   g_lighting_timer->get_cpu_ms());
+    }
 
     // Swap buffers
     SDL_GL_SwapWindow(g_sdl_window);
@@ -158,6 +196,52 @@ bool handle_key_event(const SDL_Event &event)
     switch(event.key.key)
     {
         case SDLK_ESCAPE: cont_program = false; break;
+#ifdef CG_ENABLE_PROFILER
+        case SDLK_P:
+            // Toggle a profiler capture. Stopping writes the trace.
+            if(event.type == SDL_EVENT_KEY_DOWN)
+            {
+                if(!cg::is_profile_capture_running())
+                {
+                    cg::start_profile_capture();
+                    std::cout << "Profiler capture started\n";
+                }
+                else
+                {
+                    cg::stop_profile_capture();
+                    bool written = cg::write_profile_trace("Module5_trace.json");
+                    std::cout << "Profiler capture stopped"
+                              << (written ? ": wrote Module5_trace.json\n" : "\n");
+                }
+            }
+            break;
+#endif
+        case SDLK_T:
+            // Print the frame times and toggle logging them every frame
+            if(event.type == SDL_EVENT_KEY_DOWN)
+            {
+                g_log_frame_times = !g_log_frame_times;
+                std::cout << "Frame CPU " << g_frame_cpu_ms << " ms GPU "
+                          << g_frame_timer.get_elapsed_ms() << " ms, "
+                          << g_lighting_timer->get_name() << " GPU "
+                          << g_lighting_timer->get_gpu_ms() << " ms CPU "
+                          << g_lighting_timer->get_cpu_ms() << " ms (logging "
+                          << (g_log_frame_times ? "on" : "off") << "), balls awake "
+                          << g_collision_solver.get_stats().awake << " of " << g_balls.size()
+                          << " in " << g_collision_solver.get_stats().islands
+                          << " islands (largest "
+                          << g_collision_solver.get_stats().largest_island << ")\n";
+            }
+            break;
+        case SDLK_C:
+            if(event.type == SDL_EVENT_KEY_DOWN)
+            {
+                g_scene_state.frustum_culling = !g_scene_state.frustum_culling;
+                std::cout << "Frustum culling " << (g_scene_state.frustum_culling ? "on" : "off")
+                          << ": drawn = " << g_scene_state.nodes_drawn
+                          << " culled = " << g_scene_state.nodes_culled << '\n';
+            }
+            break;
         default: break;
     }
 
@@ -292,163 +376,6 @@ std::shared_ptr<cg::SceneNode> construct_unit_box(std::shared_ptr<cg::UnitSquare
     return box;
 }
 
-void check_ball_plane_collisions(std::shared_ptr<cg::BallTransform> ball)
-{
-   cg::Point3 position = ball->getPosition();
-   float radius  = ball->getRadius();
-   cg::Vector3 velocity = ball->getVelocity();
-
-   //assume frame time 
-   float frame_time = 1.0f / 72.0f;
-
-   float closest_collision_time = frame_time;
-   cg::Plane* collision_plane = nullptr;
-
-   for(auto& plane : g_bounding_planes)
-   {
-      //calculate signed distance from ball center to plane 
-      float signed_dist = plane.solve(position);
-
-      //if ball is moving toward plane
-      float velocity_toward_plane = -velocity.dot(plane.get_normal());
-
-      if(velocity_toward_plane > 0)
-      {
-         //calculate distance to collision 
-         float collisison_distance = signed_dist - radius;
-
-         if(collisison_distance <= velocity_toward_plane * frame_time 
-            && collisison_distance > 0)
-         {
-            float collision_time = collisison_distance / velocity_toward_plane;
-            if(collision_time < closest_collision_time 
-               &&collision_time >= 0)
-            {
-               closest_collision_time = collision_time;
-               collision_plane = &plane;
-            }
-         }
-      }
-   }
-
-   //set collision data in the ball transform 
-   if(collision_plane != nullptr)
-      ball->setCollision(closest_collision_time, collision_plane);
-   else 
-      ball->clearCollision();
-}
-
-bool check_ball_ball_collision(std::shared_ptr<cg::BallTransform> ball1,
-                               std::shared_ptr<cg::BallTransform> ball2)
-{
-   cg::Point3 pos1 = ball1->getPosition();
-   cg::Point3 pos2 = ball2->getPosition();
-   cg::Vector3 vel1 = ball1->getVelocity();
-   cg::Vector3 vel2 = ball2->getVelocity();
-
-   float radius1 = ball1->getRadius();
-   float radius2 = ball2->getRadius();
-
-   //see if they're stuck together
-   cg::Vector3 separation = pos2 - pos1;
-   float distance = separation.norm();
-   float combined_radius = radius1 + radius2;
-
-   //already intersecting reposition and move on 
-   if(distance < combined_radius)
-   {
-      if(distance > 0.001f) //avoid a zero div 
-      {
-         cg::Vector3 separation_unit = separation;
-         separation_unit.normalize();
-         float overlap = combined_radius - distance;
-
-         cg::Point3 new_pos1 = pos1 - separation_unit * (overlap * 0.5f);
-         cg::Point3 new_pos2 = pos2 + separation_unit * (overlap * 0.5f);
-
-         ball1->setPosition(new_pos1);
-         ball2->setPosition(new_pos2);
-         // Reflect velocities off the collision plane
-         cg::Vector3 new_vel1 = vel1.reflect(separation_unit);
-         cg::Vector3 new_vel2 = vel2.reflect(separation_unit * -1);
-            
-         ball1->setVelocity(new_vel1);
-         ball2->setVelocity(new_vel2);
-      }
-      return true;
-   }
-
-   cg::Vector3 relative_velocity = vel1 - vel2;
-   //no relative motion
-   if(relative_velocity.norm() < 0.001f) 
-      return false;
-   
-   cg::Ray3 ray(pos1, relative_velocity.normalize());
-   cg::BoundingSphere sphere(pos2, combined_radius);
-
-   float frame_time = 1.0f / 72.0f;
-
-   auto intersection = ray.intersect(sphere);
-
-   if(intersection.intersects && intersection.distance >= 0 &&
-      intersection.distance <= relative_velocity.norm() * frame_time)
-   {
-      //calculate collision point and normal 
-      cg::Point3 collision_point = ray.intersect(intersection.distance);
-      cg:: Vector3 collision_normal = (collision_point - pos2).normalize();
-
-      //reflect the velocity 
-      cg::Vector3 new_vel1 = vel1.reflect(collision_normal);
-      cg::Vector3 new_vel2 = vel2.reflect(collision_normal * -1);
-
-      ball1->setVelocity(new_vel1);
-      ball2->setVelocity(new_vel2);
-
-      return true;
-   }
-   return false;
-}
-// Initialize bounding planes for the room
-void initialize_bounding_planes()
-{
-    g_bounding_planes.clear();
-    
-    // Floor (z = 0, normal pointing up)
-    g_bounding_planes.push_back(cg::Plane(cg::Point3(0, 0, 0), cg::Vector3(0, 0, 1)));
-    
-    // Ceiling (z = 100, normal pointing down)  
-    g_bounding_planes.push_back(cg::Plane(cg::Point3(0, 0, 100), cg::Vector3(0, 0, -1)));
-    
-    // Left wall (x = -50, normal pointing right)
-    g_bounding_planes.push_back(cg::Plane(cg::Point3(-50, 0, 0), cg::Vector3(1, 0, 0)));
-    
-    // Right wall (x = 50, normal pointing left)
-    g_bounding_planes.push_back(cg::Plane(cg::Point3(50, 0, 0), cg::Vector3(-1, 0, 0)));
-    
-    // Back wall (y = 50, normal pointing toward camera)
-    g_bounding_planes.push_back(cg::Plane(cg::Point3(0, 50, 0), cg::Vector3(0, -1, 0)));
-    
-    // Front wall (y = -50, normal pointing away from camera) 
-    g_bounding_planes.push_back(cg::Plane(cg::Point3(0, -50, 0), cg::Vector3(0, 1, 0)));
-}
-
-void detect_collisions()
-{
-   //see if we hit a wall
-   for(auto& ball : g_balls)
-   {
-      check_ball_plane_collisions(ball);
-   }
-
-   //see if we hit our neighbors...this has to be so slow
-   for(size_t i=0; i < g_balls.size(); i++)
-   {
-      for(size_t j = i + 1; j < g_balls.size(); j++)
-      {
-         check_ball_ball_collision(g_balls[i], g_balls[j]);
-      }
-   }
-}
 // Updated construct_scene function
 void construct_scene()
 {
@@ -460,6 +387,9 @@ void construct_scene()
         exit(-1);
     }
 
+    // Pick up edits to the shader files while running
+    shader->enable_hot_reload(g_file_watcher);
+
     auto unit_square =
         std::make_shared<cg::UnitSquare>(shader->get_position_loc(), shader->get_normal_loc());
 
@@ -499,7 +429,9 @@ void construct_scene()
 
     // Construct the scene layout
     g_scene_root = std::make_shared<cg::SceneNode>();
-    g_scene_root->add_child(shader);
+    g_lighting_timer = std::make_shared<cg::GpuTimerNode>("lighting");
+    g_scene_root->add_child(g_lighting_timer);
+    g_lighting_timer->add_child(shader);
 
     // Add walls to scene
     shader->add_child(back_wall_color);
@@ -524,7 +456,8 @@ void construct_scene()
     create_balls(unit_sphere, shader);
     
     // Initialize bounding planes for collision detection
-    initialize_bounding_planes();
+    cg::initialize_bounding_planes(g_bounding_planes);
+    g_collision_solver.set_restitution(BALL_RESTITUTION);
 }
 
 /**
@@ -533,6 +466,16 @@ void construct_scene()
 int main(int argc, char **argv)
 {
     cg::set_root_paths(argv[0]);
+    cg::get_logger().open("Module5.log");
+
+    // Read assets (shaders) from the packed archive when one has been built with
+    // AssetPacker (AssetPacker Module5/module5.pak . Module5/simple_light.vert
+    // Module5/simple_light.frag Module5/diffuse_light.glsl). Otherwise they are
+    // loaded as separate files.
+    cg::mount_asset_archive("Module5/module5.pak");
+
+    // Cache linked shader programs so later runs skip compiling them
+    cg::set_program_cache_directory("shader_cache");
 
     // Initialize SDL
     if(!SDL_Init(SDL_INIT_VIDEO))
@@ -633,9 +576,12 @@ int main(int argc, char **argv)
     // Main loop
     while(handle_events())
     {
-        //detect collisions 
-        detect_collisions();
+        // Move the balls, resolving collisions in the order they happen
+        g_collision_solver.step(g_balls, g_bounding_planes,
+                                1.0f / static_cast<float>(DRAWS_PER_SECOND));
 
+        // Shader changes are swapped in by the update
+        g_file_watcher.dispatch_changes();
         g_scene_root->update(g_scene_state); 
         display();
         sleep(DRAW_INTERVAL_MILLIS);
@@ -1,9 +1,15 @@
 #version 410 core
 
+// Variants (defines):
+//   NORMAL_FROM_POSITION - normal is the vertex position (unit sphere), no
+//                          vertex normal attribute
+
 // Vertex position attribute
 layout (location = 0) in vec3 vtx_position;
+#ifndef NORMAL_FROM_POSITION
 // Vertex normal attribute
 layout (location = 1) in vec3 vtx_normal;
+#endif
 // Color passed to the fragment shader
 layout (location = 0) smooth out vec4 color;
 
@@ -12,19 +18,20 @@ uniform mat4 pvm_matrix;     // Composite projection, view, model matrix
 uniform mat4 model_matrix;   // Composite modeling matrix
 uniform mat4 normal_matrix;  // Normal transformation matrix
 
+#include "diffuse_light.glsl"
+
 void main() 
 {
-    // Fixed light position in world coordinates. Light is behind the camera in 
-    // world coordinates and is hard-coded here for now!
-    vec3 light_position = vec3(0.0, -100.0, 50.0f);
+#ifdef NORMAL_FROM_POSITION
+    vec3 normal = vtx_position;
+#else
+    vec3 normal = vtx_normal;
+#endif
 
-    // Convert normal and position to world coords. Construct L - from vertex to light
-    vec3 N = normalize(vec3(normal_matrix * vec4(vtx_normal, 0.0)));
+    // Convert normal and position to world coords
+    vec3 N = normalize(vec3(normal_matrix * vec4(normal, 0.0)));
     vec4 v = model_matrix * vec4(vtx_position, 1.0);
-    vec3 L = normalize(vec3(light_position - vec3(v)));
-
-    // The diffuse shading equation. Intnesity depends on cos of L and N
-    color = vec4(material_color * max(dot(L, N), 0.0), 1.0);
+    color = diffuse_light(N, v);
 
     // Convert position to clip coordinates and pass along
     gl_Position = pvm_matrix * vec4(vtx_position, 1.0);
@@ -0,0 +1,79 @@
+#include "Module5/thread_pool.hpp"
+
+namespace cg
+{
+
+ThreadPool::ThreadPool(uint32_t thread_count)
+    : generation_(0), busy_(0), stop_(false), function_(nullptr), count_(0), next_(0)
+{
+    for(uint32_t i = 0; i < thread_count; ++i)
+        threads_.emplace_back(&ThreadPool::thread_main, this, i + 1);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    start_.notify_all();
+    for(auto &t : threads_) t.join();
+}
+
+uint32_t ThreadPool::get_worker_count() const
+{
+    return static_cast<uint32_t>(threads_.size()) + 1;
+}
+
+void ThreadPool::parallel_for(uint32_t count, const ItemFunction &function)
+{
+    if(threads_.empty() || count < 2)
+    {
+        for(uint32_t i = 0; i < count; ++i) function(i, 0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        function_ = &function;
+        count_ = count;
+        next_.store(0);
+        busy_ = static_cast<uint32_t>(threads_.size());
+        ++generation_;
+    }
+    start_.notify_all();
+
+    // The caller is worker 0
+    run_items(0);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return busy_ == 0; });
+    function_ = nullptr;
+}
+
+void ThreadPool::run_items(uint32_t worker)
+{
+    for(uint32_t i = next_.fetch_add(1); i < count_; i = next_.fetch_add(1))
+        (*function_)(i, worker);
+}
+
+void ThreadPool::thread_main(uint32_t worker)
+{
+    uint64_t generation = 0;
+    while(true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            start_.wait(lock, [&] { return stop_ || generation_ != generation; });
+            if(stop_) return;
+            generation = generation_;
+        }
+
+        run_items(worker);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if(--busy_ == 0) done_.notify_one();
+    }
+}
+
+} // namespace cg
@@ -0,0 +1,90 @@
+//============================================================================
+//	Johns Hopkins University Engineering Programs for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:	David W. Nesbitt
+//	File:    thread_pool.hpp
+//	Purpose: Small pool of worker threads for parallel loops.
+//
+//============================================================================
+
+#ifndef __MODULE5_THREAD_POOL_HPP__
+#define __MODULE5_THREAD_POOL_HPP__
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cg
+{
+
+/**
+ * Worker threads that run the items of a parallel loop. The calling thread
+ * works on the loop too, so a pool with no threads runs loops inline.
+ */
+class ThreadPool
+{
+  public:
+    /**
+     * Function run for each item. Worker is in [0, get_worker_count()) and is
+     * unique among the functions running at once (use it to index scratch data).
+     */
+    using ItemFunction = std::function<void(uint32_t item, uint32_t worker)>;
+
+    /**
+     * Constructor. Starts the threads.
+     * @param  thread_count  Number of threads besides the caller.
+     */
+    explicit ThreadPool(uint32_t thread_count);
+
+    /**
+     * Destructor. Stops the threads.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /**
+     * Get the number of workers (threads plus the caller).
+     * @return  Returns the number of workers.
+     */
+    uint32_t get_worker_count() const;
+
+    /**
+     * Run function for items 0 to count - 1 and wait for them to finish. Items
+     * are handed out in order, one at a time, so put the largest first.
+     * @param  count     Number of items.
+     * @param  function  Function to run for each item.
+     */
+    void parallel_for(uint32_t count, const ItemFunction &function);
+
+  protected:
+    std::vector<std::thread> threads_;
+    std::mutex               mutex_;
+    std::condition_variable  start_;
+    std::condition_variable  done_;
+    uint64_t                 generation_; // Incremented for each loop
+    uint32_t                 busy_;       // Threads still working on the loop
+    bool                     stop_;
+
+    // Current loop
+    const ItemFunction   *function_;
+    uint32_t              count_;
+    std::atomic<uint32_t> next_;
+
+    // Run items until none remain
+    void run_items(uint32_t worker);
+
+    // Thread main loop
+    void thread_main(uint32_t worker);
+};
+
+} // namespace cg
+
+#endif
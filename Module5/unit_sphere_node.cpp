@@ -18,6 +18,10 @@ UnitSphere::UnitSphere(int32_t position_loc, int32_t normal_loc) : GeometryNode(
     
     vertex_count_ = static_cast<GLsizei>(vertex_list.size());
 
+    // Bounds for view frustum culling
+    set_bounds(BoundingSphere(Point3(0.0f, 0.0f, 0.0f), 1.0f),
+               AABB(Point3(-1.0f, -1.0f, -1.0f), Point3(1.0f, 1.0f, 1.0f)));
+
     // Create and bind VBO for vertex data
     glGenBuffers(1, &vbo_);
     glBindBuffer(GL_ARRAY_BUFFER, vbo_);
@@ -2,6 +2,7 @@
 
 #include "geometry/types.hpp"
 
+#include <cmath>
 #include <vector>
 
 namespace cg
@@ -29,6 +30,10 @@ UnitSquare::UnitSquare(int32_t position_loc, int32_t normal_loc) : GeometryNode(
     vertex_list.push_back(vtx);
     vertex_count_ = static_cast<GLsizei>(vertex_list.size());
 
+    // Bounds for view frustum culling
+    set_bounds(BoundingSphere(Point3(0.0f, 0.0f, 0.0f), std::sqrt(0.5f)),
+               AABB(Point3(-0.5f, -0.5f, 0.0f), Point3(0.5f, 0.5f, 0.0f)));
+
     // Create a buffer object and load the data
     glGenBuffers(1, &vbo_);
     glBindBuffer(GL_ARRAY_BUFFER, vbo_);
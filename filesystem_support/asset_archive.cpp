@@ -0,0 +1,246 @@
+
+
+#include "filesystem_support/asset_archive.hpp"
+#include "filesystem_support/file_locator.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+
+namespace cg
+{
+
+namespace
+{
+std::mutex                                 mounted_mutex;
+std::vector<std::unique_ptr<AssetArchive>> mounted_archives;
+
+std::string normalize_name(const std::string &name)
+{
+    std::string normalized(name);
+    std::replace(normalized.begin(), normalized.end(), '\\', '/');
+    return normalized;
+}
+
+uint64_t align_up(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+} // namespace
+
+uint64_t asset_name_hash(const std::string &name)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for(char c : name)
+    {
+        hash ^= static_cast<uint8_t>(c == '\\' ? '/' : c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+AssetArchive::AssetArchive() : entries_(nullptr), names_(nullptr), entry_count_(0) {}
+
+bool AssetArchive::open(const std::string &path)
+{
+    close();
+    if(!file_.open(path)) return false;
+
+    // Validate the header, index, and name table before trusting any offsets
+    uint64_t size = file_.size();
+    if(size < sizeof(AssetArchiveHeader))
+    {
+        close();
+        return false;
+    }
+    AssetArchiveHeader header;
+    std::memcpy(&header, file_.data(), sizeof(header));
+    uint64_t index_end = sizeof(header) + uint64_t(header.entry_count) * sizeof(AssetArchiveEntry);
+    if(header.magic != ASSET_ARCHIVE_MAGIC || header.version != ASSET_ARCHIVE_VERSION ||
+       index_end > size || header.names_offset < index_end || header.names_size == 0 ||
+       header.names_offset > size || header.names_size > size - header.names_offset ||
+       file_.data()[header.names_offset + header.names_size - 1] != '\0')
+    {
+        close();
+        return false;
+    }
+    entries_ = reinterpret_cast<const AssetArchiveEntry *>(file_.data() + sizeof(header));
+    names_ = file_.data() + header.names_offset;
+    for(uint32_t i = 0; i < header.entry_count; ++i)
+    {
+        const AssetArchiveEntry &entry = entries_[i];
+        // Compared without adding so huge offsets cannot wrap around
+        if(entry.offset > size || entry.stored_size > size - entry.offset ||
+           entry.name_offset >= header.names_size)
+        {
+            close();
+            return false;
+        }
+    }
+    entry_count_ = header.entry_count;
+    return true;
+}
+
+void AssetArchive::close()
+{
+    file_.close();
+    entries_ = nullptr;
+    names_ = nullptr;
+    entry_count_ = 0;
+}
+
+bool AssetArchive::is_open() const { return file_.is_open(); }
+
+uint32_t AssetArchive::get_entry_count() const { return entry_count_; }
+
+std::string AssetArchive::get_name(uint32_t index) const
+{
+    return (index < entry_count_) ? std::string(names_ + entries_[index].name_offset) : "";
+}
+
+bool AssetArchive::find(const std::string &name, FileView &view) const
+{
+    uint64_t hash = asset_name_hash(name);
+    auto     it = std::lower_bound(entries_, entries_ + entry_count_, hash,
+                                   [](const AssetArchiveEntry &entry, uint64_t h)
+                                   { return entry.name_hash < h; });
+
+    // Compare names in case of hash collisions
+    std::string normalized = normalize_name(name);
+    for(; it != entries_ + entry_count_ && it->name_hash == hash; ++it)
+    {
+        if(normalized != names_ + it->name_offset) continue;
+        if(it->compression != static_cast<uint32_t>(AssetCompression::NONE)) return false;
+        view = file_.view(it->offset, it->stored_size);
+        return true;
+    }
+    return false;
+}
+
+bool AssetArchive::load(const std::string &name, FileContents &file_contents) const
+{
+    FileView view;
+    if(!find(name, view)) return false;
+    file_contents.init(view.size);
+    std::memcpy(file_contents.data, view.data, view.size);
+    file_contents.data[view.size] = '\0';
+    return true;
+}
+
+bool AssetArchiveWriter::add_file(const std::string &name, const std::string &path)
+{
+    MappedFile file;
+    if(!file.open(path)) return false;
+    add(name, file.data(), file.size());
+    return true;
+}
+
+void AssetArchiveWriter::add(const std::string &name, const char *data, uint64_t size)
+{
+    std::string normalized = normalize_name(name);
+    auto        it = std::find_if(assets_.begin(), assets_.end(),
+                                  [&](const PendingAsset &a) { return a.name == normalized; });
+    if(it == assets_.end()) it = assets_.insert(assets_.end(), PendingAsset{normalized, {}});
+    it->data.assign(data, data + size);
+}
+
+bool AssetArchiveWriter::write(const std::string &path) const
+{
+    // Sort by hash (then name so the output is deterministic)
+    std::vector<const PendingAsset *> sorted;
+    for(const auto &asset : assets_) sorted.push_back(&asset);
+    std::sort(sorted.begin(), sorted.end(),
+              [](const PendingAsset *a, const PendingAsset *b)
+              {
+                  uint64_t ha = asset_name_hash(a->name);
+                  uint64_t hb = asset_name_hash(b->name);
+                  return (ha != hb) ? ha < hb : a->name < b->name;
+              });
+
+    // Lay out the index, name table, and data
+    AssetArchiveHeader header{};
+    header.magic = ASSET_ARCHIVE_MAGIC;
+    header.version = ASSET_ARCHIVE_VERSION;
+    header.entry_count = static_cast<uint32_t>(sorted.size());
+    header.names_offset = sizeof(header) + sorted.size() * sizeof(AssetArchiveEntry);
+
+    std::vector<AssetArchiveEntry> entries(sorted.size());
+    std::string                    names;
+    for(size_t i = 0; i < sorted.size(); ++i)
+    {
+        entries[i].name_hash = asset_name_hash(sorted[i]->name);
+        entries[i].size = entries[i].stored_size = sorted[i]->data.size();
+        entries[i].compression = static_cast<uint32_t>(AssetCompression::NONE);
+        entries[i].name_offset = static_cast<uint32_t>(names.size());
+        names += sorted[i]->name;
+        names += '\0';
+    }
+    if(names.empty()) names += '\0';
+    header.names_size = names.size();
+
+    uint64_t offset = header.names_offset + header.names_size;
+    for(auto &entry : entries)
+    {
+        offset = align_up(offset, ASSET_DATA_ALIGNMENT);
+        entry.offset = offset;
+        offset += entry.stored_size;
+    }
+
+    std::ofstream out(path, std::ios::binary);
+    if(!out) return false;
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(entries.data()),
+              static_cast<std::streamsize>(entries.size() * sizeof(AssetArchiveEntry)));
+    out.write(names.data(), static_cast<std::streamsize>(names.size()));
+    uint64_t position = header.names_offset + header.names_size;
+    for(size_t i = 0; i < sorted.size(); ++i)
+    {
+        static const char padding[ASSET_DATA_ALIGNMENT] = {};
+        out.write(padding, static_cast<std::streamsize>(entries[i].offset - position));
+        out.write(sorted[i]->data.data(), static_cast<std::streamsize>(entries[i].stored_size));
+        position = entries[i].offset + entries[i].stored_size;
+    }
+    return static_cast<bool>(out);
+}
+
+bool mount_asset_archive(const std::string &filename)
+{
+    FileInfo file_info = locate_path_for_filename(filename);
+    if(!file_info.found) return false;
+
+    auto archive = std::make_unique<AssetArchive>();
+    if(!archive->open(file_info.file_path)) return false;
+
+    {
+        std::lock_guard<std::mutex> lock(mounted_mutex);
+        mounted_archives.insert(mounted_archives.begin(), std::move(archive));
+    }
+
+    // Mounting usually comes with a change of content on disk (an install or
+    // patch), so forget earlier lookups, in particular misses
+    clear_located_paths();
+    return true;
+}
+
+void unmount_asset_archives()
+{
+    {
+        std::lock_guard<std::mutex> lock(mounted_mutex);
+        mounted_archives.clear();
+    }
+    clear_located_paths();
+}
+
+bool find_mounted_asset(const std::string &name, FileView &view)
+{
+    std::lock_guard<std::mutex> lock(mounted_mutex);
+    for(const auto &archive : mounted_archives)
+    {
+        if(archive->find(name, view)) return true;
+    }
+    return false;
+}
+
+} // namespace cg
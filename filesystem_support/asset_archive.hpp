@@ -0,0 +1,183 @@
+///============================================================================
+//	Johns Hopkins University Engineering Programs for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  Brian Russin
+//	File:    asset_archive.hpp
+//	Purpose: Packed asset archive. Many files stored in one file with a
+//           sorted index, read through a single memory mapping.
+//============================================================================
+
+#ifndef __FILESYSTEM_SUPPORT_ASSET_ARCHIVE_HPP__
+#define __FILESYSTEM_SUPPORT_ASSET_ARCHIVE_HPP__
+
+#include "filesystem_support/file_loader.hpp"
+#include "filesystem_support/mapped_file.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cg
+{
+
+// Archive layout (little endian):
+//   AssetArchiveHeader
+//   AssetArchiveEntry[entry_count]   sorted by name_hash
+//   names                            entry names, each null terminated
+//   data                             entry data, each aligned to ASSET_DATA_ALIGNMENT
+constexpr uint32_t ASSET_ARCHIVE_MAGIC = 0x4b504743; // "CGPK"
+constexpr uint32_t ASSET_ARCHIVE_VERSION = 1;
+constexpr uint32_t ASSET_DATA_ALIGNMENT = 16;
+
+// Compression of an entry. Only NONE is written or read at present; the field
+// reserves space so compressed entries can be added without a format change.
+enum class AssetCompression : uint32_t
+{
+    NONE = 0
+};
+
+struct AssetArchiveHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entry_count;
+    uint32_t reserved;
+    uint64_t names_offset; // Offset of the name table
+    uint64_t names_size;   // Size of the name table
+};
+
+struct AssetArchiveEntry
+{
+    uint64_t name_hash;   // asset_name_hash of the name
+    uint64_t offset;      // Offset of the data from the start of the archive
+    uint64_t size;        // Size of the data once decompressed
+    uint64_t stored_size; // Size of the data in the archive
+    uint32_t compression; // AssetCompression
+    uint32_t name_offset; // Offset of the name within the name table
+};
+
+/**
+ * Hash of an asset name (64 bit FNV-1a). Backslashes are treated as forward
+ * slashes so names match on every platform.
+ * @param  name  Asset name (relative path).
+ * @return  Returns the hash.
+ */
+uint64_t asset_name_hash(const std::string &name);
+
+/**
+ * Read-only asset archive. Opening maps the archive; lookups binary search
+ * the index and return views into the mapping, so no data is copied.
+ */
+class AssetArchive
+{
+  public:
+    AssetArchive();
+
+    /**
+     * Open (map) an archive and validate its header and index.
+     * @param  path  Path to the archive.
+     * @return  Returns true if the archive was opened.
+     */
+    bool open(const std::string &path);
+
+    void close();
+
+    bool is_open() const;
+
+    uint32_t get_entry_count() const;
+
+    /**
+     * Get the name of an entry.
+     * @param  index  Entry index (0 to entry count - 1).
+     */
+    std::string get_name(uint32_t index) const;
+
+    /**
+     * Find an asset.
+     * @param  name  Asset name (relative path).
+     * @param  view  Output: view of the asset data (valid while the archive is open).
+     * @return  Returns true if the asset is in the archive and can be read.
+     */
+    bool find(const std::string &name, FileView &view) const;
+
+    /**
+     * Copy an asset into FileContents (null terminated, caller destroys).
+     * @param  name           Asset name (relative path).
+     * @param  file_contents  Output: asset data.
+     * @return  Returns true if the asset was found.
+     */
+    bool load(const std::string &name, FileContents &file_contents) const;
+
+  protected:
+    MappedFile               file_;
+    const AssetArchiveEntry *entries_;
+    const char              *names_;
+    uint32_t                 entry_count_;
+};
+
+/**
+ * Builds an asset archive.
+ */
+class AssetArchiveWriter
+{
+  public:
+    /**
+     * Add an asset from a file on disk.
+     * @param  name  Asset name (relative path used for lookup).
+     * @param  path  Path of the file to read.
+     * @return  Returns true if the file was read.
+     */
+    bool add_file(const std::string &name, const std::string &path);
+
+    /**
+     * Add an asset from memory.
+     * @param  name  Asset name (relative path used for lookup).
+     * @param  data  Asset data.
+     * @param  size  Size of the data.
+     */
+    void add(const std::string &name, const char *data, uint64_t size);
+
+    /**
+     * Write the archive. Duplicate names keep the last data added.
+     * @param  path  Path of the archive to write.
+     * @return  Returns true if the archive was written.
+     */
+    bool write(const std::string &path) const;
+
+  protected:
+    struct PendingAsset
+    {
+        std::string       name;
+        std::vector<char> data;
+    };
+    std::vector<PendingAsset> assets_;
+};
+
+/**
+ * Mount an archive so find_mounted_asset searches it. The archive is found
+ * with locate_path_for_filename. Archives mounted later are searched first.
+ * Clears the file locator cache (see clear_located_paths).
+ * @param  filename  Archive file name.
+ * @return  Returns true if the archive was found and opened.
+ */
+bool mount_asset_archive(const std::string &filename);
+
+/**
+ * Unmount all archives. Views returned by find_mounted_asset become invalid.
+ * Clears the file locator cache (see clear_located_paths).
+ */
+void unmount_asset_archives();
+
+/**
+ * Find an asset in the mounted archives.
+ * @param  name  Asset name (relative path).
+ * @param  view  Output: view of the asset data (valid until unmounted).
+ * @return  Returns true if a mounted archive holds the asset.
+ */
+bool find_mounted_asset(const std::string &name, FileView &view);
+
+} // namespace cg
+
+#endif
@@ -0,0 +1,123 @@
+
+
+#include "filesystem_support/async_loader.hpp"
+#include "filesystem_support/asset_archive.hpp"
+#include "filesystem_support/file_locator.hpp"
+
+#include <algorithm>
+
+namespace cg
+{
+
+AsyncLoader::AsyncLoader(uint32_t thread_count) : in_flight_(0), stop_(false), pending_(0)
+{
+    if(thread_count == 0) thread_count = std::max(1u, std::thread::hardware_concurrency());
+    for(uint32_t i = 0; i < thread_count; ++i)
+        workers_.emplace_back(&AsyncLoader::run_worker, this);
+}
+
+AsyncLoader::~AsyncLoader()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    work_cv_.notify_all();
+    for(auto &worker : workers_) worker.join();
+
+    for(Job *job : work_) delete job;
+    while(MpscNode *node = completed_.pop()) delete static_cast<Job *>(node);
+}
+
+void AsyncLoader::load(const std::string &filename,
+                       ProcessFunction    process,
+                       CompleteFunction   complete)
+{
+    Job *job = new Job;
+    job->filename = filename;
+    job->process = std::move(process);
+    job->complete = std::move(complete);
+    pending_.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        work_.push_back(job);
+        ++in_flight_;
+    }
+    work_cv_.notify_one();
+}
+
+uint32_t AsyncLoader::drain(uint32_t max_count)
+{
+    uint32_t count = 0;
+    while(count < max_count)
+    {
+        MpscNode *node = completed_.pop();
+        if(node == nullptr) break;
+
+        Job *job = static_cast<Job *>(node);
+        if(job->complete) job->complete(job->success);
+        delete job;
+        pending_.fetch_sub(1, std::memory_order_relaxed);
+        ++count;
+    }
+    return count;
+}
+
+void AsyncLoader::wait_idle()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_cv_.wait(lock, [this]() { return in_flight_ == 0; });
+}
+
+uint32_t AsyncLoader::get_pending_count() const
+{
+    return pending_.load(std::memory_order_relaxed);
+}
+
+uint32_t AsyncLoader::get_thread_count() const { return static_cast<uint32_t>(workers_.size()); }
+
+void AsyncLoader::run_worker()
+{
+    while(true)
+    {
+        Job *job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_cv_.wait(lock, [this]() { return stop_ || !work_.empty(); });
+            if(stop_) return;
+            job = work_.front();
+            work_.pop_front();
+        }
+
+        // Find (in an archive or on disk), map, and process the file. The
+        // mapping is released before the job is handed back. An exception
+        // (from the process function or allocation) fails the job rather than
+        // ending the worker, so the job still completes and wait_idle returns.
+        try
+        {
+            FileView   view;
+            MappedFile file;
+            bool       found = find_mounted_asset(job->filename, view);
+            if(!found)
+            {
+                FileInfo file_info = locate_path_for_filename(job->filename);
+                found = file_info.found && file.open(file_info.file_path);
+                view = file.view();
+            }
+            job->success = found && (!job->process || job->process(view));
+        }
+        catch(...)
+        {
+            job->success = false;
+        }
+        completed_.push(job);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --in_flight_;
+        }
+        idle_cv_.notify_all();
+    }
+}
+
+} // namespace cg
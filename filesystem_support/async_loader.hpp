@@ -0,0 +1,128 @@
+///============================================================================
+//	Johns Hopkins University Engineering Programs for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  Brian Russin
+//	File:    async_loader.hpp
+//	Purpose: Loads and processes files on background threads.
+//============================================================================
+
+#ifndef __FILESYSTEM_SUPPORT_ASYNC_LOADER_HPP__
+#define __FILESYSTEM_SUPPORT_ASYNC_LOADER_HPP__
+
+#include "filesystem_support/mapped_file.hpp"
+#include "filesystem_support/mpsc_queue.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace cg
+{
+
+/**
+ * Loads files on a pool of worker threads. Each load locates and maps the
+ * file, then runs a process function on the worker (parsing, decoding, any
+ * CPU work). Finished loads are handed back through a lock-free queue and
+ * their complete functions run on the thread calling drain - typically the
+ * render thread once per frame, where GL uploads are done.
+ */
+class AsyncLoader
+{
+  public:
+    /**
+     * Runs on a worker thread with the file contents. The view is only valid
+     * during the call, so copy out whatever is needed. Return false (or throw)
+     * to report failure.
+     */
+    using ProcessFunction = std::function<bool(const FileView &file)>;
+
+    /**
+     * Runs on the thread calling drain with whether the load succeeded.
+     */
+    using CompleteFunction = std::function<void(bool success)>;
+
+    /**
+     * Constructor. Starts the worker threads.
+     * @param  thread_count  Number of workers (0 uses all hardware threads).
+     */
+    explicit AsyncLoader(uint32_t thread_count = 0);
+
+    /**
+     * Destructor. Stops the workers. Loads not yet drained are discarded
+     * without running their complete functions.
+     */
+    ~AsyncLoader();
+
+    AsyncLoader(const AsyncLoader &) = delete;
+    AsyncLoader &operator=(const AsyncLoader &) = delete;
+
+    /**
+     * Queue a file to load. Mounted asset archives are searched first, then the
+     * file is found with locate_path_for_filename.
+     * @param  filename  File to load.
+     * @param  process   Function run on the worker with the file (may be empty).
+     * @param  complete  Function run by drain when finished (may be empty).
+     */
+    void load(const std::string &filename, ProcessFunction process, CompleteFunction complete);
+
+    /**
+     * Run the complete functions of finished loads. Call from one thread only.
+     * @param  max_count  Maximum number of loads to complete in this call.
+     * @return  Returns the number of loads completed.
+     */
+    uint32_t drain(uint32_t max_count = UINT32_MAX);
+
+    /**
+     * Block until every queued load has been processed. Complete functions
+     * still need to be run with drain.
+     */
+    void wait_idle();
+
+    /**
+     * Get the number of loads queued but not yet completed by drain.
+     * @return  Returns the pending load count.
+     */
+    uint32_t get_pending_count() const;
+
+    /**
+     * Get the number of worker threads.
+     * @return  Returns the thread count.
+     */
+    uint32_t get_thread_count() const;
+
+  protected:
+    struct Job : public MpscNode
+    {
+        std::string      filename;
+        ProcessFunction  process;
+        CompleteFunction complete;
+        bool             success = false;
+    };
+
+    std::vector<std::thread> workers_;
+    std::mutex               mutex_;
+    std::condition_variable  work_cv_;   // Signals workers that jobs are queued
+    std::condition_variable  idle_cv_;   // Signals wait_idle that a job finished
+    std::deque<Job *>        work_;      // Jobs waiting for a worker
+    uint32_t                 in_flight_; // Jobs queued or being processed
+    bool                     stop_;
+    MpscQueue                completed_; // Processed jobs waiting for drain
+    std::atomic<uint32_t>    pending_;   // Jobs not yet drained
+
+    /**
+     * Worker thread loop.
+     */
+    void run_worker();
+};
+
+} // namespace cg
+
+#endif
@@ -2,6 +2,7 @@
 
 #include "filesystem_support/file_loader.hpp"
 
+#include <filesystem>
 #include <fstream>
 
 namespace cg
@@ -9,7 +10,7 @@ namespace cg
 
 FileContents::FileContents() : size{0}, data{nullptr} {}
 
-void FileContents::init(uint32_t size_in)
+void FileContents::init(uint64_t size_in)
 {
     size = size_in;
     data = new char[size + 1];
@@ -24,17 +25,24 @@ void FileContents::destroy()
 
 bool load_file_contents(const std::string &path, FileContents &file_contents)
 {
+    // Directories can open as streams, and seeking to their end reports a
+    // meaningless size (or fails, with tellg returning -1)
+    std::error_code error;
+    if(!std::filesystem::is_regular_file(path, error)) return false;
+
     std::ifstream ifs;
-    ifs.open(path);
+    ifs.open(path, std::ios::binary);
     if(!ifs.is_open()) return false;
 
     ifs.seekg(0, std::ios::end);
+    std::streamoff end = ifs.tellg();
+    if(end < 0) return false;
 
-    uint32_t size = static_cast<uint32_t>(ifs.tellg());
+    uint64_t size = static_cast<uint64_t>(end);
     file_contents.init(size);
 
     ifs.seekg(0, std::ios::beg);
-    ifs.read(file_contents.data, size);
+    ifs.read(file_contents.data, static_cast<std::streamsize>(size));
     file_contents.data[size] = (char)0x0;
     ifs.close();
     return true;
@@ -19,12 +19,12 @@ namespace cg
 
 struct FileContents
 {
-    uint32_t size;
+    uint64_t size;
     char    *data;
 
     FileContents();
 
-    void init(uint32_t size_in);
+    void init(uint64_t size_in);
     void destroy();
 };
 
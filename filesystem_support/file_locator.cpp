@@ -5,7 +5,12 @@
 
 #include <algorithm>
 #include <cstring>
-#include <fstream>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <sys/stat.h>
+#include <sys/types.h>
 
 namespace cg
 {
@@ -14,6 +19,80 @@ namespace
 {
 std::string executable_path;
 std::string source_path;
+
+// Paths resolved by locate_path_for_filename, keyed by directory count and filename.
+// Only the path is kept: sizes are read again on each lookup so they never go stale.
+// Names that were not found are kept too, so repeated misses do not probe every
+// directory. Both are cleared by clear_located_paths (and so when the root paths
+// change or archives are mounted or unmounted).
+std::mutex                                   located_mutex;
+std::unordered_map<std::string, std::string> located_paths;
+std::unordered_set<std::string>              missing_paths;
+
+// Test for a regular file with stat rather than opening it. Sets the size if found.
+bool file_exists(const std::string &path, uint64_t &size)
+{
+#ifdef _WIN32
+    struct _stat64 st;
+    if(_stat64(path.c_str(), &st) != 0 || (st.st_mode & _S_IFREG) == 0) return false;
+#else
+    struct stat st;
+    if(stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) return false;
+#endif
+    size = static_cast<uint64_t>(st.st_size);
+    return true;
+}
+
+std::string located_key(const std::string &filename, uint16_t num_directories)
+{
+    return std::to_string(num_directories) + ':' + filename;
+}
+
+// Searches local, executable, then source paths. Caller holds located_mutex.
+FileInfo locate_uncached(const std::string &filename, uint16_t num_directories)
+{
+    // Look for the file locally first
+    FileInfo result = locate_path_for_filename_with_prefix("", filename, num_directories);
+
+    // if not found, try looking at the executable path
+    if(!result.found)
+        result = locate_path_for_filename_with_prefix(executable_path, filename, num_directories);
+
+    // if still not found, try looking at the source path
+    if(!result.found)
+        result = locate_path_for_filename_with_prefix(source_path, filename, num_directories);
+
+    return result;
+}
+
+// Cached lookup. Caller holds located_mutex.
+FileInfo locate_cached(const std::string &filename, uint16_t num_directories)
+{
+    std::string key = located_key(filename, num_directories);
+    auto        it = located_paths.find(key);
+    if(it != located_paths.end())
+    {
+        FileInfo result;
+        result.found = file_exists(it->second, result.file_size);
+        if(result.found)
+        {
+            result.file_path = it->second;
+            return result;
+        }
+        located_paths.erase(it); // Moved or deleted - search again
+    }
+    else if(missing_paths.count(key) != 0)
+    {
+        return FileInfo();
+    }
+
+    FileInfo result = locate_uncached(filename, num_directories);
+    if(result.found)
+        located_paths.emplace(key, result.file_path);
+    else
+        missing_paths.insert(key);
+    return result;
+}
 } // namespace
 
 std::string correct_path_separators(const std::string &path)
@@ -49,6 +128,7 @@ void set_root_paths(const char *exec_name)
 
     executable_path = std::string(exec_path) + std::string("/");
     free(exec_path);
+    clear_located_paths();
 }
 
 FileInfo locate_path_for_filename_with_prefix(const std::string &prefix,
@@ -58,14 +138,13 @@ FileInfo locate_path_for_filename_with_prefix(const std::string &prefix,
     FileInfo result;
     result.found = false;
 
-    std::string   rel_path = filename;
-    std::ifstream ifs;
+    // Correct separators once, then probe each parent directory with stat
+    std::string corrected_prefix = correct_path_separators(prefix);
+    std::string rel_path = correct_path_separators(filename);
     for(int i = 0; i < num_directories && !result.found; ++i)
     {
-        std::string t_str = prefix + rel_path;
-        std::string abs_path = correct_path_separators(t_str);
-        ifs.open(abs_path);
-        result.found = ifs.is_open();
+        std::string abs_path = corrected_prefix + rel_path;
+        result.found = file_exists(abs_path, result.file_size);
         if(result.found) result.file_path = abs_path;
         rel_path.insert(0, "../");
     }
@@ -75,31 +154,28 @@ FileInfo locate_path_for_filename_with_prefix(const std::string &prefix,
 
 FileInfo locate_path_for_filename(const std::string &filename, uint16_t num_directories)
 {
-    FileInfo result;
-    result.found = false;
-
-    std::string rel_path = filename;
-
-    // Look for the file locally first
-    result = locate_path_for_filename_with_prefix("", filename, num_directories);
-
-    // if not found, try looking at the executable path
-    if(!result.found)
-        result = locate_path_for_filename_with_prefix(executable_path, filename, num_directories);
-
-    // if still not found, try looking at the source path
-    if(!result.found)
-        result = locate_path_for_filename_with_prefix(source_path, filename, num_directories);
-
-    if(!result.found) return result;
+    std::lock_guard<std::mutex> lock(located_mutex);
+    return locate_cached(filename, num_directories);
+}
 
-    std::ifstream ifs;
-    ifs.open(result.file_path);
-    ifs.seekg(0, std::ios::end);
-    result.file_size = static_cast<uint32_t>(ifs.tellg());
-    ifs.close();
+std::vector<FileInfo> locate_paths_for_filenames(const std::vector<std::string> &filenames,
+                                                 uint16_t                         num_directories)
+{
+    // Resolve all under one lock. Names already looked up (even earlier in the list) are not
+    // searched again.
+    std::vector<FileInfo>       results;
+    results.reserve(filenames.size());
+    std::lock_guard<std::mutex> lock(located_mutex);
+    for(const auto &filename : filenames)
+        results.push_back(locate_cached(filename, num_directories));
+    return results;
+}
 
-    return result;
+void clear_located_paths()
+{
+    std::lock_guard<std::mutex> lock(located_mutex);
+    located_paths.clear();
+    missing_paths.clear();
 }
 
 } // namespace cg
@@ -13,6 +13,7 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
 
 namespace cg
 {
@@ -34,6 +35,14 @@ FileInfo locate_path_for_filename_with_prefix(const std::string &prefix,
 
 FileInfo locate_path_for_filename(const std::string &filename, uint16_t num_directories = 5);
 
+// Locates many files at once (e.g. an asset manifest). Results are in the same order as filenames.
+std::vector<FileInfo> locate_paths_for_filenames(const std::vector<std::string> &filenames,
+                                                 uint16_t num_directories = 5);
+
+// Forgets paths resolved by locate_path_for_filename and names it did not find (call if
+// files are created or moved). Found paths are checked again on each lookup.
+void clear_located_paths();
+
 } // namespace cg
 
 #endif
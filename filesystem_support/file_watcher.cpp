@@ -0,0 +1,180 @@
+
+
+#include "filesystem_support/file_watcher.hpp"
+
+#include <algorithm>
+#include <sys/stat.h>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace cg
+{
+
+// Changes are reported once a file has been quiet this long
+static constexpr auto SETTLE_TIME = std::chrono::milliseconds(50);
+
+// How often the thread checks for stop (inotify) or modification times (polling)
+static constexpr int32_t WAIT_MILLIS = 100;
+
+static int64_t modification_time(const std::string &path)
+{
+    struct stat info;
+    if(stat(path.c_str(), &info) != 0) return -1;
+    return static_cast<int64_t>(info.st_mtime);
+}
+
+static void split_path(const std::string &path, std::string &directory, std::string &name)
+{
+    size_t pos = path.find_last_of("/\\");
+    directory = (pos == std::string::npos) ? std::string(".") : path.substr(0, pos);
+    name = (pos == std::string::npos) ? path : path.substr(pos + 1);
+}
+
+FileWatcher::FileWatcher() : next_id_(1), notify_fd_(-1), stop_(false)
+{
+#ifdef __linux__
+    notify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+}
+
+FileWatcher::~FileWatcher()
+{
+    stop_ = true;
+    if(thread_.joinable()) thread_.join();
+#ifdef __linux__
+    if(notify_fd_ >= 0) close(notify_fd_);
+#endif
+}
+
+uint32_t FileWatcher::watch(const std::string &path, ChangedFunction on_changed)
+{
+    Watch watch;
+    watch.path = path;
+    watch.handle = -1;
+    watch.mtime = modification_time(path);
+    watch.on_changed = std::move(on_changed);
+    if(watch.mtime < 0) return 0;
+
+    std::string directory;
+    split_path(path, directory, watch.name);
+#ifdef __linux__
+    // Watching the same directory again returns its existing descriptor
+    if(notify_fd_ >= 0)
+    {
+        watch.handle = inotify_add_watch(notify_fd_, directory.c_str(),
+                                         IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+        if(watch.handle < 0) return 0;
+    }
+#endif
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    watch.id = next_id_++;
+    watches_.push_back(std::move(watch));
+    if(!thread_.joinable()) thread_ = std::thread(&FileWatcher::run, this);
+    return watches_.back().id;
+}
+
+void FileWatcher::unwatch(uint32_t id)
+{
+    // The directory stays watched; events for it no longer match a file
+    std::lock_guard<std::mutex> lock(mutex_);
+    watches_.erase(std::remove_if(watches_.begin(), watches_.end(),
+                                  [id](const Watch &watch) { return watch.id == id; }),
+                   watches_.end());
+}
+
+uint32_t FileWatcher::dispatch_changes()
+{
+    // Take settled changes and copy their callbacks, then run them unlocked
+    auto                                                now = std::chrono::steady_clock::now();
+    std::vector<std::pair<FileChange, ChangedFunction>> ready;
+    uint32_t                                            count = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto                        itr = changes_.begin();
+        while(itr != changes_.end())
+        {
+            if(now - itr->time < SETTLE_TIME)
+            {
+                ++itr;
+                continue;
+            }
+            for(const auto &watch : watches_)
+            {
+                if(watch.path == itr->path) ready.emplace_back(*itr, watch.on_changed);
+            }
+            ++count;
+            itr = changes_.erase(itr);
+        }
+    }
+    for(const auto &change : ready) change.second(change.first);
+    return count;
+}
+
+bool FileWatcher::is_native() const { return notify_fd_ >= 0; }
+
+void FileWatcher::add_change(const std::string &path)
+{
+    // Restart the settle time of a pending change rather than adding another
+    auto now = std::chrono::steady_clock::now();
+    for(auto &change : changes_)
+    {
+        if(change.path == path)
+        {
+            change.time = now;
+            return;
+        }
+    }
+    changes_.push_back({path, now});
+}
+
+void FileWatcher::run()
+{
+    while(!stop_)
+    {
+#ifdef __linux__
+        if(notify_fd_ >= 0)
+        {
+            pollfd fd = {notify_fd_, POLLIN, 0};
+            if(poll(&fd, 1, WAIT_MILLIS) <= 0) continue;
+
+            alignas(inotify_event) char buffer[4096];
+            ssize_t                     length;
+            while((length = read(notify_fd_, buffer, sizeof(buffer))) > 0)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                for(ssize_t offset = 0; offset < length;)
+                {
+                    const inotify_event *event =
+                        reinterpret_cast<const inotify_event *>(buffer + offset);
+                    offset += sizeof(inotify_event) + event->len;
+                    if(event->len == 0) continue;
+                    for(const auto &watch : watches_)
+                    {
+                        if(watch.handle == event->wd && watch.name == event->name)
+                            add_change(watch.path);
+                    }
+                }
+            }
+            continue;
+        }
+#endif
+        std::this_thread::sleep_for(std::chrono::milliseconds(WAIT_MILLIS));
+        std::lock_guard<std::mutex> lock(mutex_);
+        for(auto &watch : watches_)
+        {
+            int64_t mtime = modification_time(watch.path);
+            if(mtime >= 0 && mtime != watch.mtime)
+            {
+                watch.mtime = mtime;
+                add_change(watch.path);
+            }
+        }
+    }
+}
+
+} // namespace cg
@@ -0,0 +1,115 @@
+///============================================================================
+//	Johns Hopkins University Engineering Programs for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  Brian Russin
+//	File:    file_watcher.hpp
+//	Purpose: Watches files for changes on a background thread.
+//============================================================================
+
+#ifndef __FILESYSTEM_SUPPORT_FILE_WATCHER_HPP__
+#define __FILESYSTEM_SUPPORT_FILE_WATCHER_HPP__
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace cg
+{
+
+/**
+ * A change to a watched file.
+ */
+struct FileChange
+{
+    std::string                           path; // Path as passed to watch
+    std::chrono::steady_clock::time_point time; // When the change was detected
+};
+
+/**
+ * Watches files for changes. On Linux a background thread waits on inotify
+ * (watching the directories, so editors that save by replacing the file are
+ * seen); elsewhere the thread polls modification times. Changes are queued
+ * and the callbacks run on the thread calling dispatch_changes - typically
+ * the render thread once per frame. Changes to a file within a short window
+ * (an editor writing in pieces) are reported once.
+ */
+class FileWatcher
+{
+  public:
+    /**
+     * Runs on the thread calling dispatch_changes.
+     */
+    using ChangedFunction = std::function<void(const FileChange &change)>;
+
+    FileWatcher();
+
+    /**
+     * Destructor. Stops the watch thread.
+     */
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher &) = delete;
+    FileWatcher &operator=(const FileWatcher &) = delete;
+
+    /**
+     * Watch a file. The thread is started by the first watch.
+     * @param  path        Path to the file (e.g. from locate_path_for_filename).
+     * @param  on_changed  Function run by dispatch_changes when the file changes.
+     * @return  Returns an id for unwatch, or 0 if the file cannot be watched.
+     */
+    uint32_t watch(const std::string &path, ChangedFunction on_changed);
+
+    /**
+     * Stop a watch. Do not call from a callback.
+     * @param  id  Id returned by watch.
+     */
+    void unwatch(uint32_t id);
+
+    /**
+     * Run the callbacks for changes detected since the last call. Call from
+     * one thread only.
+     * @return  Returns the number of changed files.
+     */
+    uint32_t dispatch_changes();
+
+    /**
+     * Check if changes are reported by the OS (inotify) rather than polling.
+     * @return  Returns true if the OS reports changes.
+     */
+    bool is_native() const;
+
+  protected:
+    struct Watch
+    {
+        uint32_t        id;
+        std::string     path;
+        std::string     name;       // File name part of path
+        int32_t         handle;     // inotify watch descriptor of the directory
+        int64_t         mtime;      // Last modification time (polling)
+        ChangedFunction on_changed;
+    };
+
+    std::mutex               mutex_; // Guards watches_ and changes_
+    std::vector<Watch>       watches_;
+    std::vector<FileChange>  changes_;
+    uint32_t                 next_id_;
+    int32_t                  notify_fd_; // inotify instance, -1 when polling
+    std::atomic<bool>        stop_;
+    std::thread              thread_;
+
+    void run();
+
+    // Queue a change unless the path already has one pending (call with mutex_ held)
+    void add_change(const std::string &path);
+};
+
+} // namespace cg
+
+#endif
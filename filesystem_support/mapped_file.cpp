@@ -0,0 +1,184 @@
+
+
+#include "filesystem_support/mapped_file.hpp"
+
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace cg
+{
+
+MappedFile::MappedFile() :
+    data_(nullptr),
+    size_(0),
+    open_(false),
+    mapped_(false)
+#ifdef _WIN32
+    ,
+    file_handle_(nullptr),
+    mapping_handle_(nullptr)
+#endif
+{
+}
+
+MappedFile::MappedFile(const std::string &path) : MappedFile() { open(path); }
+
+MappedFile::~MappedFile() { close(); }
+
+MappedFile::MappedFile(MappedFile &&other) noexcept : MappedFile() { move_from(other); }
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+{
+    if(this != &other)
+    {
+        close();
+        move_from(other);
+    }
+    return *this;
+}
+
+void MappedFile::move_from(MappedFile &other)
+{
+    data_ = other.data_;
+    size_ = other.size_;
+    open_ = other.open_;
+    mapped_ = other.mapped_;
+    fallback_ = other.fallback_;
+#ifdef _WIN32
+    file_handle_ = other.file_handle_;
+    mapping_handle_ = other.mapping_handle_;
+    other.file_handle_ = nullptr;
+    other.mapping_handle_ = nullptr;
+#endif
+    other.data_ = nullptr;
+    other.size_ = 0;
+    other.open_ = false;
+    other.mapped_ = false;
+    other.fallback_ = FileContents();
+}
+
+bool MappedFile::open(const std::string &path)
+{
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER file_size;
+    if(!GetFileSizeEx(file, &file_size))
+    {
+        CloseHandle(file);
+        return false;
+    }
+    size_ = static_cast<uint64_t>(file_size.QuadPart);
+    if(size_ == 0)
+    {
+        // Nothing to map
+        CloseHandle(file);
+        data_ = "";
+        open_ = true;
+        return true;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if(mapping != nullptr)
+    {
+        void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if(view != nullptr)
+        {
+            file_handle_ = file;
+            mapping_handle_ = mapping;
+            data_ = static_cast<const char *>(view);
+            open_ = mapped_ = true;
+            return true;
+        }
+        CloseHandle(mapping);
+    }
+    CloseHandle(file);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0) return false;
+    struct stat st;
+    if(fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+    {
+        // Directories, devices and pipes have no size to map or read
+        ::close(fd);
+        return false;
+    }
+    size_ = static_cast<uint64_t>(st.st_size);
+    if(size_ == 0)
+    {
+        // Nothing to map
+        ::close(fd);
+        data_ = "";
+        open_ = true;
+        return true;
+    }
+    void *addr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(addr != MAP_FAILED)
+    {
+        // The mapping stays valid after the descriptor is closed
+        ::close(fd);
+        data_ = static_cast<const char *>(addr);
+        open_ = mapped_ = true;
+        return true;
+    }
+    ::close(fd);
+#endif
+
+    // Mapping failed - read the file into memory instead
+    size_ = 0;
+    if(!load_file_contents(path, fallback_)) return false;
+    data_ = fallback_.data;
+    size_ = fallback_.size;
+    open_ = true;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if(mapped_)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(data_);
+        CloseHandle(static_cast<HANDLE>(mapping_handle_));
+        CloseHandle(static_cast<HANDLE>(file_handle_));
+        mapping_handle_ = nullptr;
+        file_handle_ = nullptr;
+#else
+        munmap(const_cast<char *>(data_), size_);
+#endif
+    }
+    fallback_.destroy();
+    data_ = nullptr;
+    size_ = 0;
+    open_ = false;
+    mapped_ = false;
+}
+
+bool MappedFile::is_open() const { return open_; }
+
+bool MappedFile::is_mapped() const { return mapped_; }
+
+const char *MappedFile::data() const { return data_; }
+
+uint64_t MappedFile::size() const { return size_; }
+
+FileView MappedFile::view() const { return FileView{data_, size_}; }
+
+FileView MappedFile::view(uint64_t offset, uint64_t length) const
+{
+    offset = std::min(offset, size_);
+    length = std::min(length, size_ - offset);
+    return FileView{data_ + offset, length};
+}
+
+} // namespace cg
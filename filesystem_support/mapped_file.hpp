@@ -0,0 +1,108 @@
+///============================================================================
+//	Johns Hopkins University Engineering Programs for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  Brian Russin
+//	File:    mapped_file.hpp
+//	Purpose: Read-only memory mapped file access.
+//============================================================================
+
+#ifndef __FILESYSTEM_SUPPORT_MAPPED_FILE_HPP__
+#define __FILESYSTEM_SUPPORT_MAPPED_FILE_HPP__
+
+#include "filesystem_support/file_loader.hpp"
+
+#include <cstdint>
+#include <string>
+
+namespace cg
+{
+
+/**
+ * Read-only view of a range of bytes. Does not own the data and is not null
+ * terminated.
+ */
+struct FileView
+{
+    const char *data = nullptr;
+    uint64_t    size = 0;
+};
+
+/**
+ * Read-only file contents. The file is memory mapped so pages load lazily
+ * and nothing is copied. If mapping fails the file is read into memory
+ * instead (through load_file_contents). The mapping or buffer is released
+ * on close or destruction.
+ */
+class MappedFile
+{
+  public:
+    MappedFile();
+
+    /**
+     * Constructor. Opens the file.
+     * @param  path  Path to the file.
+     */
+    explicit MappedFile(const std::string &path);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+
+    /**
+     * Open a file. Closes any file already open.
+     * @param  path  Path to the file.
+     * @return  Returns true if the file was opened (false if it is missing
+     *          or is not a regular file, e.g. a directory).
+     */
+    bool open(const std::string &path);
+
+    /**
+     * Release the mapping (or buffer).
+     */
+    void close();
+
+    bool is_open() const;
+
+    /**
+     * Is the file memory mapped (false if it was read into memory)?
+     */
+    bool is_mapped() const;
+
+    const char *data() const;
+
+    uint64_t size() const;
+
+    /**
+     * Get a view of the whole file.
+     */
+    FileView view() const;
+
+    /**
+     * Get a view of part of the file. The range is clamped to the file size.
+     * @param  offset  Offset of the first byte.
+     * @param  length  Number of bytes.
+     */
+    FileView view(uint64_t offset, uint64_t length) const;
+
+  protected:
+    const char  *data_;
+    uint64_t     size_;
+    bool         open_;
+    bool         mapped_;
+    FileContents fallback_; // Used when the file could not be mapped
+#ifdef _WIN32
+    void *file_handle_;
+    void *mapping_handle_;
+#endif
+
+    void move_from(MappedFile &other);
+};
+
+} // namespace cg
+
+#endif
@@ -0,0 +1,50 @@
+
+
+#include "filesystem_support/mpsc_queue.hpp"
+
+namespace cg
+{
+
+MpscQueue::MpscQueue() : head_(&stub_), tail_(&stub_) {}
+
+void MpscQueue::push(MpscNode *node)
+{
+    node->next.store(nullptr, std::memory_order_relaxed);
+    MpscNode *prev = head_.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+}
+
+MpscNode *MpscQueue::pop()
+{
+    MpscNode *tail = tail_;
+    MpscNode *next = tail->next.load(std::memory_order_acquire);
+
+    // Skip over the stub
+    if(tail == &stub_)
+    {
+        if(next == nullptr) return nullptr;
+        tail_ = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+    if(next != nullptr)
+    {
+        tail_ = next;
+        return tail;
+    }
+
+    // tail is the last item unless a producer is partway through a push
+    if(tail != head_.load(std::memory_order_acquire)) return nullptr;
+
+    // Re-insert the stub so the last item can be removed
+    push(&stub_);
+    next = tail->next.load(std::memory_order_acquire);
+    if(next != nullptr)
+    {
+        tail_ = next;
+        return tail;
+    }
+    return nullptr;
+}
+
+} // namespace cg
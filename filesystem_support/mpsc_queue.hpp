@@ -0,0 +1,60 @@
+///============================================================================
+//	Johns Hopkins University Engineering Programs for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  Brian Russin
+//	File:    mpsc_queue.hpp
+//	Purpose: Lock-free intrusive multiple producer / single consumer queue.
+//============================================================================
+
+#ifndef __FILESYSTEM_SUPPORT_MPSC_QUEUE_HPP__
+#define __FILESYSTEM_SUPPORT_MPSC_QUEUE_HPP__
+
+#include <atomic>
+
+namespace cg
+{
+
+/**
+ * Link embedded in items placed on an MpscQueue. Derive queued items from it.
+ */
+struct MpscNode
+{
+    std::atomic<MpscNode *> next{nullptr};
+};
+
+/**
+ * Lock-free intrusive queue (Vyukov). Any number of threads may push; a
+ * single thread pops. Push is wait-free. The queue does not own its items.
+ */
+class MpscQueue
+{
+  public:
+    MpscQueue();
+
+    MpscQueue(const MpscQueue &) = delete;
+    MpscQueue &operator=(const MpscQueue &) = delete;
+
+    /**
+     * Add an item. Safe to call from any thread.
+     * @param  node  Item to add.
+     */
+    void push(MpscNode *node);
+
+    /**
+     * Remove the oldest item. Call only from the consumer thread. May return
+     * null while a push is partway through even if the queue is not empty.
+     * @return  Returns the item or null if none is available.
+     */
+    MpscNode *pop();
+
+  protected:
+    std::atomic<MpscNode *> head_; // Most recently pushed (producers)
+    MpscNode               *tail_; // Next to pop (consumer)
+    MpscNode                stub_;
+};
+
+} // namespace cg
+
+#endif
@@ -2,56 +2,70 @@
 
 #include "geometry/geometry.hpp"
 
+#include <algorithm>
+#include <limits>
+
 namespace cg
 {
 
-// NOTE - this is not required until 605.767!
-
 AABB::AABB()
 {
-    // Complete in 605.767
+    constexpr float big = std::numeric_limits<float>::max();
+    minpt.set(big, big, big);
+    maxpt.set(-big, -big, -big);
+    center.set(0.0f, 0.0f, 0.0f);
+    half_diag.set(0.0f, 0.0f, 0.0f);
 }
 
-AABB::AABB(const Point3 &min, const Point3 &max)
-{
-    // Complete in 605.767
-}
+AABB::AABB(const Point3 &min, const Point3 &max) { update(min, max); }
 
-AABB::AABB(const std::vector<Point3> &vertex_list)
-{
-    // Complete in 605.767
-}
+AABB::AABB(const std::vector<Point3> &vertex_list) { create(vertex_list); }
 
 void AABB::create(const std::vector<Point3> &vertex_list)
 {
-    // Complete in 605.767
+    *this = AABB();
+    for(const auto &v : vertex_list)
+    {
+        minpt.x = std::min(minpt.x, v.x);
+        minpt.y = std::min(minpt.y, v.y);
+        minpt.z = std::min(minpt.z, v.z);
+        maxpt.x = std::max(maxpt.x, v.x);
+        maxpt.y = std::max(maxpt.y, v.y);
+        maxpt.z = std::max(maxpt.z, v.z);
+    }
+    if(!is_empty()) compute_center();
 }
 
 void AABB::update(const Point3 &min, const Point3 &max)
 {
-    // Complete in 605.767
+    minpt = min;
+    maxpt = max;
+    compute_center();
 }
 
 void AABB::merge(const AABB &box)
 {
-    // Complete in 605.767
-}
+    if(box.is_empty()) return;
 
-Point3 AABB::min_pt() const
-{
-    // Complete in 605.767
-    return Point3();
+    minpt.x = std::min(minpt.x, box.minpt.x);
+    minpt.y = std::min(minpt.y, box.minpt.y);
+    minpt.z = std::min(minpt.z, box.minpt.z);
+    maxpt.x = std::max(maxpt.x, box.maxpt.x);
+    maxpt.y = std::max(maxpt.y, box.maxpt.y);
+    maxpt.z = std::max(maxpt.z, box.maxpt.z);
+    compute_center();
 }
 
-Point3 AABB::max_pt() const
-{
-    // Complete in 605.767
-    return Point3();
-}
+Point3 AABB::min_pt() const { return minpt; }
+
+Point3 AABB::max_pt() const { return maxpt; }
+
+bool AABB::is_empty() const { return minpt.x > maxpt.x || minpt.y > maxpt.y || minpt.z > maxpt.z; }
 
-void compute_center()
+void AABB::compute_center()
 {
-    // Complete in 605.767
+    center = minpt.mid_point(maxpt);
+    half_diag.set(center, maxpt);
 }
 
 } // namespace cg
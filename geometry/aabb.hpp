@@ -12,6 +12,7 @@
 #define __GEOMETRY_AABB_HPP__
 
 #include "geometry/point3.hpp"
+#include "geometry/vector3.hpp"
 
 #include <vector>
 
@@ -23,8 +24,14 @@ namespace cg
  */
 struct AABB
 {
+    Point3  minpt;     // Minimum x,y,z
+    Point3  maxpt;     // Maximum x,y,z
+    Point3  center;    // Center of the box
+    Vector3 half_diag; // Half diagonal (extent along each axis from the center)
+
     /**
-     * Default constructor.
+     * Default constructor. Creates an empty (inverted) box so that the first
+     * merge or update sets the extents.
      */
     AABB();
 
@@ -72,6 +79,12 @@ struct AABB
      */
     Point3 max_pt() const;
 
+    /**
+     * Is the box empty (no points have been added)?
+     * @return  Returns true if the box is empty.
+     */
+    bool is_empty() const;
+
     /**
      * Compute center and half diagonal
      */
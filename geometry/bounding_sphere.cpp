@@ -9,16 +9,83 @@ BoundingSphere::BoundingSphere() : center{0.0f, 0.0f, 0.0f}, radius(1.0f) {}
 
 BoundingSphere::BoundingSphere(const BoundingSphere &s) : center(s.center), radius(s.radius) {}
 
+BoundingSphere &BoundingSphere::operator=(const BoundingSphere &s)
+{
+    center = s.center;
+    radius = s.radius;
+    return *this;
+}
+
 BoundingSphere::BoundingSphere(const Point3 &c, float r) : center(c), radius(r) {}
 
-BoundingSphere::BoundingSphere(std::vector<Point3> &vertex_list)
+BoundingSphere::BoundingSphere(std::vector<Point3> &vertex_list) :
+    center{0.0f, 0.0f, 0.0f}, radius(0.0f)
 {
-    // Complete in 605.767
+    if(vertex_list.empty()) return;
+
+    // Find the points with min and max x, y, and z
+    const Point3 *min_x = &vertex_list[0], *max_x = &vertex_list[0];
+    const Point3 *min_y = &vertex_list[0], *max_y = &vertex_list[0];
+    const Point3 *min_z = &vertex_list[0], *max_z = &vertex_list[0];
+    for(const auto &v : vertex_list)
+    {
+        if(v.x < min_x->x) min_x = &v;
+        if(v.x > max_x->x) max_x = &v;
+        if(v.y < min_y->y) min_y = &v;
+        if(v.y > max_y->y) max_y = &v;
+        if(v.z < min_z->z) min_z = &v;
+        if(v.z > max_z->z) max_z = &v;
+    }
+
+    // Start with the sphere through the most distant pair of extreme points
+    const Point3 *p1 = min_x, *p2 = max_x;
+    float         d = (*max_x - *min_x).norm_squared();
+    if((*max_y - *min_y).norm_squared() > d)
+    {
+        p1 = min_y;
+        p2 = max_y;
+        d = (*max_y - *min_y).norm_squared();
+    }
+    if((*max_z - *min_z).norm_squared() > d)
+    {
+        p1 = min_z;
+        p2 = max_z;
+    }
+    center = p1->mid_point(*p2);
+    radius = (*p2 - center).norm();
+
+    // Grow the sphere to include any points outside it
+    for(const auto &v : vertex_list)
+    {
+        Vector3 to_v = v - center;
+        float   dist_sq = to_v.norm_squared();
+        if(dist_sq > radius * radius)
+        {
+            float dist = std::sqrt(dist_sq);
+            float new_radius = 0.5f * (radius + dist);
+            center = center + to_v * ((new_radius - radius) / dist);
+            radius = new_radius;
+        }
+    }
 }
 
 BoundingSphere &BoundingSphere::merge_with(const BoundingSphere &s2)
 {
-    // Complete in 605.767
+    Vector3 d = s2.center - center;
+    float   dist = d.norm();
+
+    // One sphere already encloses the other
+    if(dist + s2.radius <= radius) return *this;
+    if(dist + radius <= s2.radius)
+    {
+        *this = s2;
+        return *this;
+    }
+
+    // Sphere spanning the far sides of both spheres along the line of centers
+    float new_radius = 0.5f * (dist + radius + s2.radius);
+    center = center + d * ((new_radius - radius) / dist);
+    radius = new_radius;
     return *this;
 }
 
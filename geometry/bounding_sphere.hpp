@@ -38,6 +38,13 @@ struct BoundingSphere
      */
     BoundingSphere(const BoundingSphere &s);
 
+    /**
+     * Assignment operator
+     * @param   s   Sphere to assign to this sphere.
+     * @return  Returns the address of this sphere.
+     */
+    BoundingSphere &operator=(const BoundingSphere &s);
+
     /**
      * Constructor given a center point and radius.
      * @param  c  Center point.
@@ -0,0 +1,142 @@
+#include "geometry/cooked_mesh.hpp"
+
+#include "geometry/geometry.hpp"
+
+#include <cstring>
+#include <fstream>
+
+namespace cg
+{
+
+static_assert(sizeof(VertexAndNormal) == 6 * sizeof(float),
+              "VertexAndNormal must be tightly packed to upload directly");
+
+namespace
+{
+
+constexpr uint64_t BLOCK_ALIGNMENT = 16;
+
+uint64_t align_up(uint64_t value)
+{
+    return (value + BLOCK_ALIGNMENT - 1) / BLOCK_ALIGNMENT * BLOCK_ALIGNMENT;
+}
+
+bool write_mesh(const std::string                  &filename,
+                const std::vector<VertexAndNormal> &vertex_list,
+                const void                         *indices,
+                uint32_t                            index_count,
+                uint32_t                            index_size)
+{
+    // Bounds from the vertex positions
+    std::vector<Point3> positions;
+    positions.reserve(vertex_list.size());
+    for(const auto &v : vertex_list) positions.push_back(v.vertex);
+    AABB           box = positions.empty() ? AABB() : AABB(positions);
+    BoundingSphere sphere = positions.empty() ? BoundingSphere() : BoundingSphere(positions);
+
+    CookedMeshHeader header{};
+    header.magic = COOKED_MESH_MAGIC;
+    header.version = COOKED_MESH_VERSION;
+    header.vertex_count = static_cast<uint32_t>(vertex_list.size());
+    header.index_count = index_count;
+    header.index_size = (index_count > 0) ? index_size : 0;
+    header.vertex_offset = align_up(sizeof(header));
+    uint64_t vertex_end = header.vertex_offset + vertex_list.size() * sizeof(VertexAndNormal);
+    header.index_offset = align_up(vertex_end);
+    std::memcpy(header.aabb_min, &box.minpt.x, sizeof(header.aabb_min));
+    std::memcpy(header.aabb_max, &box.maxpt.x, sizeof(header.aabb_max));
+    std::memcpy(header.sphere_center, &sphere.center.x, sizeof(header.sphere_center));
+    header.sphere_radius = sphere.radius;
+
+    std::ofstream out(filename, std::ios::binary);
+    if(!out) return false;
+    static const char padding[BLOCK_ALIGNMENT] = {};
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(padding, static_cast<std::streamsize>(header.vertex_offset - sizeof(header)));
+    out.write(reinterpret_cast<const char *>(vertex_list.data()),
+              static_cast<std::streamsize>(vertex_list.size() * sizeof(VertexAndNormal)));
+    if(header.index_size > 0)
+    {
+        out.write(padding, static_cast<std::streamsize>(header.index_offset - vertex_end));
+        out.write(static_cast<const char *>(indices),
+                  static_cast<std::streamsize>(uint64_t(index_count) * index_size));
+    }
+    return static_cast<bool>(out);
+}
+
+// Whether count elements of stride bytes at offset lie within size bytes. Written
+// so that no term can wrap for offsets and counts read from a corrupt header.
+bool block_fits(uint64_t offset, uint64_t count, uint64_t stride, uint64_t size)
+{
+    return offset <= size && count <= (size - offset) / stride;
+}
+
+template <typename T>
+bool indices_in_range(const char *data, uint32_t index_count, uint32_t vertex_count)
+{
+    const T *indices = reinterpret_cast<const T *>(data);
+    for(uint32_t i = 0; i < index_count; ++i)
+    {
+        if(indices[i] >= vertex_count) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool parse_cooked_mesh(const char *data, uint64_t size, CookedMeshView &view)
+{
+    if(data == nullptr || size < sizeof(CookedMeshHeader)) return false;
+
+    CookedMeshHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if(header.magic != COOKED_MESH_MAGIC || header.version != COOKED_MESH_VERSION) return false;
+    if(header.index_size != 0 && header.index_size != 2 && header.index_size != 4) return false;
+    if(header.vertex_offset % alignof(float) != 0) return false;
+    if(header.index_size > 0 && header.index_offset % header.index_size != 0) return false;
+    if(!block_fits(header.vertex_offset, header.vertex_count, sizeof(VertexAndNormal), size))
+        return false;
+    if(header.index_size > 0 &&
+       !block_fits(header.index_offset, header.index_count, header.index_size, size))
+        return false;
+
+    // Indices must refer to vertices in the file
+    if(header.index_size == 2 &&
+       !indices_in_range<uint16_t>(data + header.index_offset, header.index_count,
+                                   header.vertex_count))
+        return false;
+    if(header.index_size == 4 &&
+       !indices_in_range<uint32_t>(data + header.index_offset, header.index_count,
+                                   header.vertex_count))
+        return false;
+
+    view.vertices = reinterpret_cast<const VertexAndNormal *>(data + header.vertex_offset);
+    view.indices = (header.index_size > 0) ? data + header.index_offset : nullptr;
+    view.vertex_count = header.vertex_count;
+    view.index_count = (header.index_size > 0) ? header.index_count : 0;
+    view.index_size = header.index_size;
+    view.box = AABB(Point3(header.aabb_min[0], header.aabb_min[1], header.aabb_min[2]),
+                    Point3(header.aabb_max[0], header.aabb_max[1], header.aabb_max[2]));
+    view.sphere = BoundingSphere(
+        Point3(header.sphere_center[0], header.sphere_center[1], header.sphere_center[2]),
+        header.sphere_radius);
+    return true;
+}
+
+bool write_cooked_mesh(const std::string                  &filename,
+                       const std::vector<VertexAndNormal> &vertex_list,
+                       const std::vector<uint16_t>        &face_list)
+{
+    return write_mesh(filename, vertex_list, face_list.data(),
+                      static_cast<uint32_t>(face_list.size()), sizeof(uint16_t));
+}
+
+bool write_cooked_mesh(const std::string                  &filename,
+                       const std::vector<VertexAndNormal> &vertex_list,
+                       const std::vector<uint32_t>        &face_list)
+{
+    return write_mesh(filename, vertex_list, face_list.data(),
+                      static_cast<uint32_t>(face_list.size()), sizeof(uint32_t));
+}
+
+} // namespace cg
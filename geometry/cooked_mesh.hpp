@@ -0,0 +1,100 @@
+//============================================================================
+//	Johns Hopkins University Engineering for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  David W. Nesbitt
+//	File:    cooked_mesh.hpp
+//	Purpose: Binary (cooked) mesh format. Laid out so vertex and index
+//           blocks can be uploaded straight from a mapped file.
+//============================================================================
+
+#ifndef __GEOMETRY_COOKED_MESH_HPP__
+#define __GEOMETRY_COOKED_MESH_HPP__
+
+#include "geometry/aabb.hpp"
+#include "geometry/bounding_sphere.hpp"
+#include "geometry/types.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cg
+{
+
+// Cooked mesh layout (little endian):
+//   CookedMeshHeader
+//   VertexAndNormal[vertex_count]   at vertex_offset (16 byte aligned)
+//   uint16_t or uint32_t indices    at index_offset (16 byte aligned), absent if index_size is 0
+constexpr uint32_t COOKED_MESH_MAGIC = 0x534d4743; // "CGMS"
+constexpr uint32_t COOKED_MESH_VERSION = 1;
+
+struct CookedMeshHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vertex_count;
+    uint32_t index_count;
+    uint32_t index_size; // Bytes per index: 2, 4, or 0 for non-indexed triangles
+    uint32_t reserved;
+    uint64_t vertex_offset;
+    uint64_t index_offset;
+    float    aabb_min[3];
+    float    aabb_max[3];
+    float    sphere_center[3];
+    float    sphere_radius;
+};
+
+/**
+ * View of a cooked mesh held in memory (e.g. a mapped file). Points into the
+ * memory, nothing is copied.
+ */
+struct CookedMeshView
+{
+    const VertexAndNormal *vertices = nullptr;
+    const void            *indices = nullptr;
+    uint32_t               vertex_count = 0;
+    uint32_t               index_count = 0;
+    uint32_t               index_size = 0;
+    AABB                   box;
+    BoundingSphere         sphere;
+};
+
+/**
+ * Validate a cooked mesh in memory and set up a view of it. Checks that the
+ * vertex and index blocks lie within the data and that every index refers to
+ * a vertex.
+ * @param  data  Cooked mesh data (must be 4 byte aligned).
+ * @param  size  Size of the data in bytes.
+ * @param  view  Output: view of the mesh.
+ * @return  Returns true if the data is a valid cooked mesh.
+ */
+bool parse_cooked_mesh(const char *data, uint64_t size, CookedMeshView &view);
+
+/**
+ * Write a cooked mesh with 16 bit indices. Bounds are computed from the vertices.
+ * @param  filename     File to write.
+ * @param  vertex_list  Vertex list.
+ * @param  face_list    Face index list (3 indices per triangle). Empty for
+ *                      non-indexed triangles (3 vertices per triangle).
+ * @return  Returns true if the file was written.
+ */
+bool write_cooked_mesh(const std::string                  &filename,
+                       const std::vector<VertexAndNormal> &vertex_list,
+                       const std::vector<uint16_t>        &face_list);
+
+/**
+ * Write a cooked mesh with 32 bit indices. Bounds are computed from the vertices.
+ * @param  filename     File to write.
+ * @param  vertex_list  Vertex list.
+ * @param  face_list    Face index list (3 indices per triangle).
+ * @return  Returns true if the file was written.
+ */
+bool write_cooked_mesh(const std::string                  &filename,
+                       const std::vector<VertexAndNormal> &vertex_list,
+                       const std::vector<uint32_t>        &face_list);
+
+} // namespace cg
+
+#endif
@@ -0,0 +1,64 @@
+#include "geometry/frustum.hpp"
+
+#include "geometry/geometry.hpp"
+
+#include <cmath>
+
+namespace cg
+{
+
+Frustum::Frustum() {}
+
+Frustum::Frustum(const Matrix4x4 &pv) { set(pv); }
+
+void Frustum::set(const Matrix4x4 &pv)
+{
+    // Each clip plane is the 4th row of the matrix plus or minus one of the
+    // other rows. Our plane equation is ax + by + cz - d, so d is negated.
+    auto set_plane = [&pv](Plane &plane, uint32_t row, float sign)
+    {
+        plane.a = pv.m(3, 0) + sign * pv.m(row, 0);
+        plane.b = pv.m(3, 1) + sign * pv.m(row, 1);
+        plane.c = pv.m(3, 2) + sign * pv.m(row, 2);
+        plane.d = -(pv.m(3, 3) + sign * pv.m(row, 3));
+        plane.normalize();
+    };
+    set_plane(planes[LEFT], 0, 1.0f);
+    set_plane(planes[RIGHT], 0, -1.0f);
+    set_plane(planes[BOTTOM], 1, 1.0f);
+    set_plane(planes[TOP], 1, -1.0f);
+    set_plane(planes[NEAR_PLANE], 2, 1.0f);
+    set_plane(planes[FAR_PLANE], 2, -1.0f);
+}
+
+FrustumTestResult Frustum::test(const BoundingSphere &sphere) const
+{
+    FrustumTestResult result = FrustumTestResult::INSIDE;
+    for(const auto &plane : planes)
+    {
+        float dist = plane.solve(sphere.center);
+        if(dist < -sphere.radius) return FrustumTestResult::OUTSIDE;
+        if(dist < sphere.radius) result = FrustumTestResult::INTERSECT;
+    }
+    return result;
+}
+
+FrustumTestResult Frustum::test(const AABB &box) const
+{
+    if(box.is_empty()) return FrustumTestResult::OUTSIDE;
+
+    // Project the half diagonal onto each plane normal to get the box "radius"
+    // along the normal, then compare with the signed distance to the center.
+    FrustumTestResult result = FrustumTestResult::INSIDE;
+    const Vector3    &h = box.half_diag;
+    for(const auto &plane : planes)
+    {
+        float dist = plane.solve(box.center);
+        float r = std::abs(plane.a) * h.x + std::abs(plane.b) * h.y + std::abs(plane.c) * h.z;
+        if(dist < -r) return FrustumTestResult::OUTSIDE;
+        if(dist < r) result = FrustumTestResult::INTERSECT;
+    }
+    return result;
+}
+
+} // namespace cg
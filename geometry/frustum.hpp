@@ -0,0 +1,89 @@
+//============================================================================
+//	Johns Hopkins University Engineering for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  David W. Nesbitt
+//	File:    frustum.hpp
+//	Purpose: View frustum (6 planes) extracted from a composite projection
+//           and view matrix. Supports culling of bounding volumes.
+//============================================================================
+
+#ifndef __GEOMETRY_FRUSTUM_HPP__
+#define __GEOMETRY_FRUSTUM_HPP__
+
+#include "geometry/aabb.hpp"
+#include "geometry/bounding_sphere.hpp"
+#include "geometry/matrix.hpp"
+#include "geometry/plane.hpp"
+
+#include <array>
+
+namespace cg
+{
+
+/**
+ * Result of testing a bounding volume against the view frustum.
+ */
+enum class FrustumTestResult
+{
+    OUTSIDE,   // Completely outside the frustum
+    INTERSECT, // Straddles one or more frustum planes
+    INSIDE     // Completely inside the frustum
+};
+
+/**
+ * View frustum. Plane normals point into the frustum, so a point p is inside
+ * a plane when plane.solve(p) >= 0.
+ */
+struct Frustum
+{
+    enum PlaneId
+    {
+        LEFT = 0,
+        RIGHT,
+        BOTTOM,
+        TOP,
+        NEAR_PLANE,
+        FAR_PLANE
+    };
+
+    std::array<Plane, 6> planes;
+
+    /**
+     * Default constructor.
+     */
+    Frustum();
+
+    /**
+     * Construct the frustum from a composite projection and view matrix.
+     * @param  pv  Composite projection * view matrix.
+     */
+    Frustum(const Matrix4x4 &pv);
+
+    /**
+     * Extract the 6 frustum planes (world coordinates) from a composite
+     * projection and view matrix (Gribb and Hartmann). Planes are normalized
+     * so that solving a plane equation gives the signed distance.
+     * @param  pv  Composite projection * view matrix.
+     */
+    void set(const Matrix4x4 &pv);
+
+    /**
+     * Test a bounding sphere against the frustum.
+     * @param  sphere  Bounding sphere (world coordinates).
+     * @return  Returns whether the sphere is outside, intersects, or is inside the frustum.
+     */
+    FrustumTestResult test(const BoundingSphere &sphere) const;
+
+    /**
+     * Test an axis aligned bounding box against the frustum.
+     * @param  box  Bounding box (world coordinates).
+     * @return  Returns whether the box is outside, intersects, or is inside the frustum.
+     */
+    FrustumTestResult test(const AABB &box) const;
+};
+
+} // namespace cg
+
+#endif
@@ -73,8 +73,14 @@ float fast_inv_sqrt(float x);
 #include "geometry/aabb.hpp"
 #include "geometry/bounding_sphere.hpp"
 #include "geometry/ray3.hpp"
+#include "geometry/ray_packet.hpp"
+#include "geometry/triangle_batch.hpp"
+#include "geometry/mesh_bvh.hpp"
+#include "geometry/cooked_mesh.hpp"
 #include "geometry/noise.hpp"
+#include "geometry/noise_baker.hpp"
 #include "geometry/matrix.hpp"
+#include "geometry/frustum.hpp"
 #include "geometry/types.hpp"
 // clang-format on
 
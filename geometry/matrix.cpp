@@ -2,6 +2,7 @@
 
 #include "geometry/geometry.hpp"
 
+#include <algorithm>
 #include <cmath>
 
 namespace cg
@@ -210,6 +211,29 @@ Vector3 Matrix4x4::operator*(const Vector3 &v) const
 
 Ray3 Matrix4x4::operator*(const Ray3 &ray) const { return Ray3(*this * ray.o, *this * ray.d); }
 
+BoundingSphere Matrix4x4::operator*(const BoundingSphere &sphere) const
+{
+    // Largest squared length of the basis vectors (columns of the upper 3x3)
+    float sx = a_[0] * a_[0] + a_[1] * a_[1] + a_[2] * a_[2];
+    float sy = a_[4] * a_[4] + a_[5] * a_[5] + a_[6] * a_[6];
+    float sz = a_[8] * a_[8] + a_[9] * a_[9] + a_[10] * a_[10];
+    float s = std::sqrt(std::max(sx, std::max(sy, sz)));
+    return BoundingSphere(*this * sphere.center, sphere.radius * s);
+}
+
+AABB Matrix4x4::operator*(const AABB &box) const
+{
+    if(box.is_empty()) return box;
+
+    // Transform the center and project the half diagonal onto each axis
+    const Vector3 &h = box.half_diag;
+    Point3         c = *this * box.center;
+    Vector3        e(std::abs(a_[0]) * h.x + std::abs(a_[4]) * h.y + std::abs(a_[8]) * h.z,
+                     std::abs(a_[1]) * h.x + std::abs(a_[5]) * h.y + std::abs(a_[9]) * h.z,
+                     std::abs(a_[2]) * h.x + std::abs(a_[6]) * h.y + std::abs(a_[10]) * h.z);
+    return AABB(c - e, c + e);
+}
+
 Matrix4x4 &Matrix4x4::transpose()
 {
     *this = get_transpose();
@@ -11,6 +11,8 @@
 #ifndef __GEOMETRY_MATRIX_HPP__
 #define __GEOMETRY_MATRIX_HPP__
 
+#include "aabb.hpp"
+#include "bounding_sphere.hpp"
 #include "hpoint3.hpp"
 #include "point3.hpp"
 #include "ray3.hpp"
@@ -178,6 +180,23 @@ class Matrix4x4
      */
     Ray3 operator*(const Ray3 &ray) const;
 
+    /**
+     * Transforms a bounding sphere by the matrix. The center is transformed
+     * and the radius is scaled by the largest scale factor of the upper 3x3
+     * portion of the matrix, so the result always encloses the transformed sphere.
+     * @param   sphere  Bounding sphere to transform
+     * @return  Returns the transformed bounding sphere.
+     */
+    BoundingSphere operator*(const BoundingSphere &sphere) const;
+
+    /**
+     * Transforms an axis aligned bounding box by the matrix. Returns the
+     * axis aligned box that encloses the transformed box (Arvo's method).
+     * @param   box  Bounding box to transform
+     * @return  Returns the axis aligned box enclosing the transformed box.
+     */
+    AABB operator*(const AABB &box) const;
+
     /**
      * Transposes the current matrix.
      * @return   Returns the address of the current matrix.
@@ -0,0 +1,466 @@
+#include "geometry/mesh_bvh.hpp"
+
+#include "geometry/geometry.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+namespace cg
+{
+
+namespace
+{
+
+constexpr uint32_t SAH_BINS = 12;              // Number of bins used to evaluate split planes
+constexpr uint32_t MAX_LEAF_TRIANGLES = 4;     // Leaves up to the batch test width are not split
+constexpr uint32_t STACK_SIZE = 64;            // Traversal stack depth
+constexpr uint32_t MAX_DEPTH = STACK_SIZE - 1; // Deepest node the build creates
+constexpr float    TRAVERSAL_COST = 1.0f;      // Cost of a node visit relative to a triangle test
+constexpr float    INF = std::numeric_limits<float>::infinity();
+
+struct Bounds
+{
+    float bmin[3] = {INF, INF, INF};
+    float bmax[3] = {-INF, -INF, -INF};
+
+    void grow(const float *p)
+    {
+        for(uint32_t a = 0; a < 3; ++a)
+        {
+            bmin[a] = std::min(bmin[a], p[a]);
+            bmax[a] = std::max(bmax[a], p[a]);
+        }
+    }
+
+    void grow(const Bounds &b)
+    {
+        for(uint32_t a = 0; a < 3; ++a)
+        {
+            bmin[a] = std::min(bmin[a], b.bmin[a]);
+            bmax[a] = std::max(bmax[a], b.bmax[a]);
+        }
+    }
+
+    float area() const
+    {
+        float ex = bmax[0] - bmin[0];
+        float ey = bmax[1] - bmin[1];
+        float ez = bmax[2] - bmin[2];
+        return (ex < 0.0f) ? 0.0f : ex * ey + ey * ez + ez * ex;
+    }
+};
+
+struct BuildTriangle
+{
+    Bounds bounds;
+    float  centroid[3];
+};
+
+struct Bin
+{
+    Bounds   bounds;
+    uint32_t count = 0;
+};
+
+/**
+ * Slab test of a ray against a node's box. Returns the entry distance, or
+ * infinity if the box is missed or is entered beyond t_max. Each slab is
+ * ordered by the sign of the inverse direction and merged with comparisons
+ * that are false for NaN, so a zero direction component with the origin on
+ * one of that axis's planes (0 * inf) leaves the interval unchanged.
+ */
+inline float intersect_node(const MeshBVHNode &node,
+                            const Point3      &o,
+                            const Vector3     &inv_d,
+                            float              t_max)
+{
+    const float *origin = &o.x;
+    const float *inv = &inv_d.x;
+    float        t_near = -INF;
+    float        t_far = INF;
+    for(uint32_t a = 0; a < 3; ++a)
+    {
+        bool  neg = inv[a] < 0.0f;
+        float t_enter = ((neg ? node.bmax[a] : node.bmin[a]) - origin[a]) * inv[a];
+        float t_exit = ((neg ? node.bmin[a] : node.bmax[a]) - origin[a]) * inv[a];
+        if(t_enter > t_near) t_near = t_enter;
+        if(t_exit < t_far) t_far = t_exit;
+    }
+    return (t_far >= t_near && t_far > 0.0f && t_near < t_max) ? t_near : INF;
+}
+
+} // namespace
+
+MeshBVH::MeshBVH() {}
+
+MeshBVH::MeshBVH(const std::vector<Point3> &vertex_list, const std::vector<uint16_t> &face_list)
+{
+    build(vertex_list, face_list);
+}
+
+MeshBVH::MeshBVH(const std::vector<VertexAndNormal> &vertex_list,
+                 const std::vector<uint16_t>        &face_list)
+{
+    build(vertex_list, face_list);
+}
+
+void MeshBVH::build(const std::vector<Point3> &vertex_list, const std::vector<uint16_t> &face_list)
+{
+    std::vector<Point3> positions;
+    positions.reserve(face_list.size());
+    for(auto idx : face_list) positions.push_back(vertex_list[idx]);
+    build_from_positions(positions);
+}
+
+void MeshBVH::build(const std::vector<VertexAndNormal> &vertex_list,
+                    const std::vector<uint16_t>        &face_list)
+{
+    std::vector<Point3> positions;
+    positions.reserve(face_list.size());
+    for(auto idx : face_list) positions.push_back(vertex_list[idx].vertex);
+    build_from_positions(positions);
+}
+
+void MeshBVH::build_from_positions(const std::vector<Point3> &positions)
+{
+    nodes_.clear();
+    triangles_.clear();
+    face_index_.clear();
+
+    uint32_t n = static_cast<uint32_t>(positions.size() / 3);
+    if(n == 0) return;
+
+    // Per triangle bounds and centroids
+    std::vector<BuildTriangle> tris(n);
+    std::vector<uint32_t>      order(n);
+    for(uint32_t i = 0; i < n; ++i)
+    {
+        for(uint32_t k = 0; k < 3; ++k) tris[i].bounds.grow(&positions[i * 3 + k].x);
+        for(uint32_t a = 0; a < 3; ++a)
+            tris[i].centroid[a] = 0.5f * (tris[i].bounds.bmin[a] + tris[i].bounds.bmax[a]);
+        order[i] = i;
+    }
+
+    // Root node holds all triangles. Subdivide nodes using an explicit stack of
+    // (node, depth) pairs.
+    nodes_.reserve(2 * n);
+    nodes_.push_back(MeshBVHNode{{0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}, 0, n});
+    std::vector<std::pair<uint32_t, uint32_t>> work{{0, 0}};
+    while(!work.empty())
+    {
+        auto [node_idx, depth] = work.back();
+        work.pop_back();
+        uint32_t first = nodes_[node_idx].left_or_first;
+        uint32_t count = nodes_[node_idx].count;
+
+        // Node bounds and centroid bounds
+        Bounds bounds, centroid_bounds;
+        for(uint32_t i = first; i < first + count; ++i)
+        {
+            bounds.grow(tris[order[i]].bounds);
+            centroid_bounds.grow(tris[order[i]].centroid);
+        }
+        std::copy(bounds.bmin, bounds.bmin + 3, nodes_[node_idx].bmin);
+        std::copy(bounds.bmax, bounds.bmax + 3, nodes_[node_idx].bmax);
+        if(count <= MAX_LEAF_TRIANGLES) continue;
+
+        // Traversal pushes at most one node per level plus the two children of
+        // the current node, so capping the depth keeps it within STACK_SIZE.
+        // Only degenerate meshes reach the cap; the leaf is larger instead.
+        if(depth >= MAX_DEPTH) continue;
+
+        // Find the lowest cost split plane over all axes using binned SAH
+        float    best_cost = INF;
+        uint32_t best_axis = 0;
+        uint32_t best_split = 0;
+        for(uint32_t a = 0; a < 3; ++a)
+        {
+            float extent = centroid_bounds.bmax[a] - centroid_bounds.bmin[a];
+            if(extent <= 0.0f) continue;
+
+            std::array<Bin, SAH_BINS> bins;
+            float                     scale = SAH_BINS / extent;
+            for(uint32_t i = first; i < first + count; ++i)
+            {
+                const BuildTriangle &t = tris[order[i]];
+                float                offset = (t.centroid[a] - centroid_bounds.bmin[a]) * scale;
+                uint32_t             b = std::min(SAH_BINS - 1, static_cast<uint32_t>(offset));
+                bins[b].count++;
+                bins[b].bounds.grow(t.bounds);
+            }
+
+            // Sweep from the left and right to get the cost of each split plane
+            std::array<float, SAH_BINS - 1>    left_area, right_area;
+            std::array<uint32_t, SAH_BINS - 1> left_count, right_count;
+            Bounds                             left_box, right_box;
+            uint32_t                           left_sum = 0, right_sum = 0;
+            for(uint32_t i = 0; i < SAH_BINS - 1; ++i)
+            {
+                left_sum += bins[i].count;
+                left_box.grow(bins[i].bounds);
+                left_count[i] = left_sum;
+                left_area[i] = left_box.area();
+                right_sum += bins[SAH_BINS - 1 - i].count;
+                right_box.grow(bins[SAH_BINS - 1 - i].bounds);
+                right_count[SAH_BINS - 2 - i] = right_sum;
+                right_area[SAH_BINS - 2 - i] = right_box.area();
+            }
+            for(uint32_t i = 0; i < SAH_BINS - 1; ++i)
+            {
+                if(left_count[i] == 0 || right_count[i] == 0) continue;
+                float cost = left_count[i] * left_area[i] + right_count[i] * right_area[i];
+                if(cost < best_cost)
+                {
+                    best_cost = cost;
+                    best_axis = a;
+                    best_split = i;
+                }
+            }
+        }
+
+        // Make a leaf if no split is better than testing all the triangles
+        float leaf_cost = count * bounds.area();
+        float split_cost = TRAVERSAL_COST * bounds.area() + best_cost;
+        if(best_cost == INF || split_cost >= leaf_cost) continue;
+
+        // Partition the triangles about the split plane
+        float extent = centroid_bounds.bmax[best_axis] - centroid_bounds.bmin[best_axis];
+        float scale = SAH_BINS / extent;
+        auto  mid = std::partition(order.begin() + first,
+                                  order.begin() + first + count,
+                                  [&](uint32_t t)
+                                  {
+                                      float c = tris[t].centroid[best_axis];
+                                      uint32_t b = std::min(
+                                          SAH_BINS - 1,
+                                          static_cast<uint32_t>(
+                                              (c - centroid_bounds.bmin[best_axis]) * scale));
+                                      return b <= best_split;
+                                  });
+        uint32_t left_count = static_cast<uint32_t>(mid - order.begin()) - first;
+        if(left_count == 0 || left_count == count) continue;
+
+        // Children are allocated as a pair so the right child is left + 1
+        uint32_t left_idx = static_cast<uint32_t>(nodes_.size());
+        nodes_.push_back(MeshBVHNode{{0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}, first, left_count});
+        nodes_.push_back(MeshBVHNode{
+            {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}, first + left_count, count - left_count});
+        nodes_[node_idx].left_or_first = left_idx;
+        nodes_[node_idx].count = 0;
+        work.push_back({left_idx + 1, depth + 1});
+        work.push_back({left_idx, depth + 1});
+    }
+
+    // Store the triangles in leaf order
+    triangles_.reserve(n);
+    face_index_.resize(n);
+    for(uint32_t i = 0; i < n; ++i)
+    {
+        uint32_t t = order[i];
+        triangles_.add(positions[t * 3], positions[t * 3 + 1], positions[t * 3 + 2]);
+        face_index_[i] = t;
+    }
+}
+
+RayMeshIntersectResult MeshBVH::intersect(const Ray3 &ray, float t_min) const
+{
+    RayMeshIntersectResult result{false, 0.0f, 0.0f, 0.0f, 0};
+    if(nodes_.empty()) return result;
+
+    Vector3 inv_d(1.0f / ray.d.x, 1.0f / ray.d.y, 1.0f / ray.d.z);
+    float   t_best = t_min;
+    if(intersect_node(nodes_[0], ray.o, inv_d, t_best) == INF) return result;
+
+    uint32_t stack[STACK_SIZE];
+    uint32_t sp = 0;
+    uint32_t node_idx = 0;
+    while(true)
+    {
+        const MeshBVHNode &node = nodes_[node_idx];
+        if(node.is_leaf())
+        {
+            auto hit = triangles_.intersect(ray, node.left_or_first, node.count, t_best);
+            if(hit.intersects)
+            {
+                t_best = hit.distance;
+                result = hit;
+                result.face_index = face_index_[hit.face_index];
+            }
+            if(sp == 0) break;
+            node_idx = stack[--sp];
+            continue;
+        }
+
+        // Visit the nearer child first, defer the farther one
+        uint32_t near_idx = node.left_or_first;
+        uint32_t far_idx = near_idx + 1;
+        float    t_near = intersect_node(nodes_[near_idx], ray.o, inv_d, t_best);
+        float    t_far = intersect_node(nodes_[far_idx], ray.o, inv_d, t_best);
+        if(t_far < t_near)
+        {
+            std::swap(t_near, t_far);
+            std::swap(near_idx, far_idx);
+        }
+        if(t_near == INF)
+        {
+            if(sp == 0) break;
+            node_idx = stack[--sp];
+            continue;
+        }
+        node_idx = near_idx;
+        if(t_far != INF) stack[sp++] = far_idx;
+    }
+    return result;
+}
+
+bool MeshBVH::does_intersect_exist(const Ray3 &ray, float t_min) const
+{
+    if(nodes_.empty()) return false;
+
+    Vector3 inv_d(1.0f / ray.d.x, 1.0f / ray.d.y, 1.0f / ray.d.z);
+    uint32_t stack[STACK_SIZE];
+    uint32_t sp = 0;
+    stack[sp++] = 0;
+    while(sp > 0)
+    {
+        const MeshBVHNode &node = nodes_[stack[--sp]];
+        if(intersect_node(node, ray.o, inv_d, t_min) == INF) continue;
+
+        if(node.is_leaf())
+        {
+            // Any hit will do - return as soon as one is found
+            if(triangles_.does_intersect_exist(ray, node.left_or_first, node.count, t_min))
+                return true;
+        }
+        else
+        {
+            stack[sp++] = node.left_or_first + 1;
+            stack[sp++] = node.left_or_first;
+        }
+    }
+    return false;
+}
+
+void MeshBVH::intersect(const RayPacket4       &packet,
+                        float                   t_min,
+                        RayMeshIntersectResult *results) const
+{
+    alignas(16) float t[RayPacket4::WIDTH];
+    alignas(16) float u[RayPacket4::WIDTH];
+    alignas(16) float v[RayPacket4::WIDTH];
+    uint32_t          face[RayPacket4::WIDTH];
+    for(uint32_t i = 0; i < RayPacket4::WIDTH; ++i)
+    {
+        t[i] = t_min;
+        u[i] = v[i] = 0.0f;
+        face[i] = 0;
+    }
+
+    uint32_t hit_mask = 0;
+    uint32_t stack[STACK_SIZE];
+    uint32_t sp = 0;
+    if(!nodes_.empty()) stack[sp++] = 0;
+    while(sp > 0)
+    {
+        // Rays whose nearest hit is closer than the box entry drop out of the test
+        const MeshBVHNode &node = nodes_[stack[--sp]];
+        if(packet.intersect_box(node.bmin, node.bmax, t, nullptr) == 0) continue;
+
+        if(node.is_leaf())
+        {
+            for(uint32_t i = node.left_or_first; i < node.left_or_first + node.count; ++i)
+            {
+                uint32_t mask = packet.intersect(
+                    triangles_.v0(i), triangles_.e1(i), triangles_.e2(i), t, u, v);
+                for(uint32_t lane = 0; lane < RayPacket4::WIDTH; ++lane)
+                {
+                    if(mask & (1u << lane)) face[lane] = face_index_[i];
+                }
+                hit_mask |= mask;
+            }
+        }
+        else
+        {
+            // Order children by the entry distance of the first ray that hits them
+            uint32_t          left = node.left_or_first;
+            alignas(16) float t_left[RayPacket4::WIDTH], t_right[RayPacket4::WIDTH];
+            uint32_t left_mask =
+                packet.intersect_box(nodes_[left].bmin, nodes_[left].bmax, t, t_left);
+            uint32_t right_mask =
+                packet.intersect_box(nodes_[left + 1].bmin, nodes_[left + 1].bmax, t, t_right);
+            float near_left = INF, near_right = INF;
+            for(uint32_t lane = 0; lane < RayPacket4::WIDTH; ++lane)
+            {
+                if(left_mask & (1u << lane)) near_left = std::min(near_left, t_left[lane]);
+                if(right_mask & (1u << lane)) near_right = std::min(near_right, t_right[lane]);
+            }
+            if(near_left <= near_right)
+            {
+                if(right_mask) stack[sp++] = left + 1;
+                if(left_mask) stack[sp++] = left;
+            }
+            else
+            {
+                if(left_mask) stack[sp++] = left;
+                if(right_mask) stack[sp++] = left + 1;
+            }
+        }
+    }
+
+    for(uint32_t lane = 0; lane < RayPacket4::WIDTH; ++lane)
+    {
+        if(hit_mask & (1u << lane))
+            results[lane] = {true, t[lane], u[lane], v[lane], face[lane]};
+        else
+            results[lane] = {false, 0.0f, 0.0f, 0.0f, 0};
+    }
+}
+
+uint32_t MeshBVH::does_intersect_exist(const RayPacket4 &packet, float t_min) const
+{
+    if(nodes_.empty()) return 0;
+
+    alignas(16) float t_max[RayPacket4::WIDTH];
+    alignas(16) float t[RayPacket4::WIDTH];
+    alignas(16) float u[RayPacket4::WIDTH];
+    alignas(16) float v[RayPacket4::WIDTH];
+    for(uint32_t i = 0; i < RayPacket4::WIDTH; ++i) t_max[i] = t_min;
+
+    // Rays that find a hit are removed from the working packet
+    RayPacket4 active = packet;
+    uint32_t   hit_mask = 0;
+    uint32_t   stack[STACK_SIZE];
+    uint32_t   sp = 0;
+    stack[sp++] = 0;
+    while(sp > 0 && active.active_mask != 0)
+    {
+        const MeshBVHNode &node = nodes_[stack[--sp]];
+        if(active.intersect_box(node.bmin, node.bmax, t_max, nullptr) == 0) continue;
+
+        if(node.is_leaf())
+        {
+            for(uint32_t i = node.left_or_first; i < node.left_or_first + node.count; ++i)
+            {
+                std::copy(t_max, t_max + RayPacket4::WIDTH, t);
+                uint32_t mask = active.intersect(
+                    triangles_.v0(i), triangles_.e1(i), triangles_.e2(i), t, u, v);
+                hit_mask |= mask;
+                active.active_mask &= ~mask;
+                if(active.active_mask == 0) break;
+            }
+        }
+        else
+        {
+            stack[sp++] = node.left_or_first + 1;
+            stack[sp++] = node.left_or_first;
+        }
+    }
+    return hit_mask;
+}
+
+uint32_t MeshBVH::node_count() const { return static_cast<uint32_t>(nodes_.size()); }
+
+uint32_t MeshBVH::triangle_count() const { return triangles_.size(); }
+
+} // namespace cg
@@ -0,0 +1,149 @@
+//============================================================================
+//	Johns Hopkins University Engineering for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  David W. Nesbitt
+//	File:    mesh_bvh.hpp
+//	Purpose: Bounding volume hierarchy over an indexed triangle mesh.
+//           Accelerates ray / mesh intersection queries.
+//============================================================================
+
+#ifndef __GEOMETRY_MESH_BVH_HPP__
+#define __GEOMETRY_MESH_BVH_HPP__
+
+#include "geometry/point3.hpp"
+#include "geometry/ray3.hpp"
+#include "geometry/ray_packet.hpp"
+#include "geometry/triangle_batch.hpp"
+#include "geometry/types.hpp"
+#include "geometry/vector3.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace cg
+{
+
+/**
+ * BVH node, 32 bytes. Interior nodes store the index of the left child (the
+ * right child immediately follows it). Leaf nodes store the first triangle
+ * and the triangle count.
+ */
+struct MeshBVHNode
+{
+    float    bmin[3];       // Bounding box minimum
+    float    bmax[3];       // Bounding box maximum
+    uint32_t left_or_first; // Left child (interior) or first triangle (leaf)
+    uint32_t count;         // Number of triangles (0 for interior nodes)
+
+    bool is_leaf() const { return count > 0; }
+};
+
+/**
+ * Bounding volume hierarchy over an indexed triangle mesh. Built with the
+ * surface area heuristic (binned) into a flat node array. Triangles are
+ * copied in leaf order into a SoA TriangleBatch so each leaf is tested as
+ * one contiguous block and traversal does not touch the original lists.
+ */
+class MeshBVH
+{
+  public:
+    /**
+     * Constructor. Creates an empty BVH.
+     */
+    MeshBVH();
+
+    /**
+     * Construct a BVH over a triangle mesh.
+     * @param  vertex_list  Vertex list of the triangle mesh.
+     * @param  face_list    Face index list (3 indices per triangle).
+     */
+    MeshBVH(const std::vector<Point3> &vertex_list, const std::vector<uint16_t> &face_list);
+
+    /**
+     * Construct a BVH over a triangle mesh.
+     * @param  vertex_list  Vertex list (with normals) of the triangle mesh.
+     * @param  face_list    Face index list (3 indices per triangle).
+     */
+    MeshBVH(const std::vector<VertexAndNormal> &vertex_list,
+            const std::vector<uint16_t>        &face_list);
+
+    /**
+     * Build the BVH over a triangle mesh. Replaces any prior contents.
+     * @param  vertex_list  Vertex list of the triangle mesh.
+     * @param  face_list    Face index list (3 indices per triangle).
+     */
+    void build(const std::vector<Point3> &vertex_list, const std::vector<uint16_t> &face_list);
+
+    /**
+     * Build the BVH over a triangle mesh. Replaces any prior contents.
+     * @param  vertex_list  Vertex list (with normals) of the triangle mesh.
+     * @param  face_list    Face index list (3 indices per triangle).
+     */
+    void build(const std::vector<VertexAndNormal> &vertex_list,
+               const std::vector<uint16_t>        &face_list);
+
+    /**
+     * Find the nearest intersection of a ray with the mesh that occurs before t_min.
+     * @param  ray    Ray to intersect.
+     * @param  t_min  Current minimum intersection (t) value along the ray.
+     * @return Returns whether or not there is an intersection, the distance,
+     *         the barycentric coordinates of intersection, and the face index.
+     */
+    RayMeshIntersectResult intersect(const Ray3 &ray, float t_min) const;
+
+    /**
+     * Does any intersection exist between the ray and the mesh prior to t_min?
+     * Terminates at the first intersection found.
+     * @param  ray    Ray to intersect.
+     * @param  t_min  t value for intersection.
+     * @return Returns true if an intersection exists, false if not.
+     */
+    bool does_intersect_exist(const Ray3 &ray, float t_min) const;
+
+    /**
+     * Find the nearest intersection of each ray in a packet with the mesh. Nodes
+     * are visited once for the whole packet, so coherent rays share traversal.
+     * @param  packet   Packet of rays to intersect.
+     * @param  t_min    Current minimum intersection (t) value along the rays.
+     * @param  results  Output: one result per packet lane (4 entries).
+     */
+    void intersect(const RayPacket4 &packet, float t_min, RayMeshIntersectResult *results) const;
+
+    /**
+     * Does any intersection exist between each ray in a packet and the mesh prior
+     * to t_min? Rays drop out of the traversal once they find an intersection.
+     * @param  packet  Packet of rays to intersect.
+     * @param  t_min   t value for intersection.
+     * @return Returns the mask of rays (bit per lane) that intersect the mesh.
+     */
+    uint32_t does_intersect_exist(const RayPacket4 &packet, float t_min) const;
+
+    /**
+     * Get the number of nodes in the hierarchy.
+     * @return  Returns the node count.
+     */
+    uint32_t node_count() const;
+
+    /**
+     * Get the number of triangles in the hierarchy.
+     * @return  Returns the triangle count.
+     */
+    uint32_t triangle_count() const;
+
+  protected:
+    std::vector<MeshBVHNode> nodes_;
+    TriangleBatch            triangles_;  // Triangles in leaf order
+    std::vector<uint32_t>    face_index_; // Original face index of each triangle
+
+    /**
+     * Build the hierarchy from per-triangle vertex positions.
+     * @param  positions  3 vertex positions per triangle.
+     */
+    void build_from_positions(const std::vector<Point3> &positions);
+};
+
+} // namespace cg
+
+#endif
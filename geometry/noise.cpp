@@ -1,24 +1,289 @@
 #include "geometry/noise.hpp"
 
 #include "geometry/geometry.hpp"
+#include "geometry/simd.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
 
 namespace cg
 {
 
-// NOTE - not required until 605.767!
+namespace
+{
+
+constexpr uint32_t DEFAULT_SEED = 0x9e3779b9;
+constexpr int32_t  LATTICE_MASK = 255;
+
+/**
+ * Split a coordinate into its lattice cell and position within the cell.
+ */
+inline void split(float x, int32_t &cell, float &frac)
+{
+    float f = std::floor(x);
+    cell = static_cast<int32_t>(f) & LATTICE_MASK;
+    frac = x - f;
+}
+
+/**
+ * Derive the lattice cell and position of the next octave (double the
+ * frequency) from the current octave. Exact since scaling by 2 is exact.
+ */
+inline void next_octave(int32_t &cell, float &frac)
+{
+    float   f2 = frac * 2.0f;
+    int32_t bit = (f2 >= 1.0f) ? 1 : 0;
+    cell = (cell * 2 + bit) & LATTICE_MASK;
+    frac = f2 - static_cast<float>(bit);
+}
+
+inline float fade(float t) { return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f); }
+
+inline float lerp(float t, float a, float b) { return a + t * (b - a); }
+
+/**
+ * Dot product of the position with one of 12 gradient directions (edges of a cube).
+ */
+inline float grad(int32_t hash, float x, float y, float z)
+{
+    int32_t h = hash & 15;
+    float   u = (h < 8) ? x : y;
+    float   v = (h < 4) ? y : ((h == 12 || h == 14) ? x : z);
+    return ((h & 1) ? -u : u) + ((h & 2) ? -v : v);
+}
+
+inline float to_unit(float n) { return std::min(1.0f, std::max(0.0f, 0.5f * (n + 1.0f))); }
+
+#ifdef CG_SIMD_SSE2
+
+inline __m128 select(__m128 mask, __m128 a, __m128 b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+inline __m128 fade4(__m128 t)
+{
+    __m128 r = _mm_sub_ps(_mm_mul_ps(t, _mm_set1_ps(6.0f)), _mm_set1_ps(15.0f));
+    r = _mm_add_ps(_mm_mul_ps(t, r), _mm_set1_ps(10.0f));
+    return _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(t, t), t), r);
+}
 
-Noise::Noise() {}
+inline __m128 lerp4(__m128 t, __m128 a, __m128 b)
+{
+    return _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(b, a)));
+}
 
-float Noise::noise(const Point3 &p, float scale)
+inline __m128 grad4(const int32_t *hash, __m128 x, __m128 y, __m128 z)
 {
-    // Complete in 605.767
-    return 1.0f;
+    __m128i h = _mm_and_si128(_mm_load_si128(reinterpret_cast<const __m128i *>(hash)),
+                              _mm_set1_epi32(15));
+    __m128  lt8 = _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(8)));
+    __m128  lt4 = _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(4)));
+    __m128  h12_14 = _mm_castsi128_ps(_mm_or_si128(_mm_cmpeq_epi32(h, _mm_set1_epi32(12)),
+                                                  _mm_cmpeq_epi32(h, _mm_set1_epi32(14))));
+    __m128  u = select(lt8, x, y);
+    __m128  v = select(lt4, y, select(h12_14, x, z));
+
+    // Bit 0 of the hash negates u, bit 1 negates v (moved into the sign bit)
+    __m128 sign_u = _mm_castsi128_ps(_mm_slli_epi32(h, 31));
+    __m128 sign_v = _mm_castsi128_ps(
+        _mm_and_si128(_mm_slli_epi32(h, 30), _mm_set1_epi32(static_cast<int32_t>(0x80000000))));
+    return _mm_add_ps(_mm_xor_ps(u, sign_u), _mm_xor_ps(v, sign_v));
 }
 
-float Noise::turbulence(float scale, const Point3 &p)
+#endif
+
+} // namespace
+
+Noise::Noise() { init(DEFAULT_SEED); }
+
+Noise::Noise(uint32_t seed) { init(seed); }
+
+void Noise::init(uint32_t seed)
 {
-    // Complete in 605.767
-    return 1.0f;
+    for(int32_t i = 0; i < 256; ++i) perm_[i] = i;
+    std::mt19937 rng(seed);
+    std::shuffle(perm_, perm_ + 256, rng);
+    for(int32_t i = 0; i < 256; ++i) perm_[256 + i] = perm_[i];
+}
+
+float Noise::lattice_noise(int32_t xi, int32_t yi, int32_t zi, float fx, float fy, float fz) const
+{
+    // Hash the 8 corners of the cell
+    int32_t a = perm_[xi] + yi;
+    int32_t aa = perm_[a] + zi;
+    int32_t ab = perm_[a + 1] + zi;
+    int32_t b = perm_[xi + 1] + yi;
+    int32_t ba = perm_[b] + zi;
+    int32_t bb = perm_[b + 1] + zi;
+
+    float u = fade(fx);
+    float v = fade(fy);
+    float w = fade(fz);
+    float x0 = lerp(u, grad(perm_[aa], fx, fy, fz), grad(perm_[ba], fx - 1.0f, fy, fz));
+    float x1 =
+        lerp(u, grad(perm_[ab], fx, fy - 1.0f, fz), grad(perm_[bb], fx - 1.0f, fy - 1.0f, fz));
+    float x2 = lerp(u, grad(perm_[aa + 1], fx, fy, fz - 1.0f),
+                    grad(perm_[ba + 1], fx - 1.0f, fy, fz - 1.0f));
+    float x3 = lerp(u, grad(perm_[ab + 1], fx, fy - 1.0f, fz - 1.0f),
+                    grad(perm_[bb + 1], fx - 1.0f, fy - 1.0f, fz - 1.0f));
+    return lerp(w, lerp(v, x0, x1), lerp(v, x2, x3));
+}
+
+#ifdef CG_SIMD_SSE2
+
+void Noise::lattice_noise4(const int32_t *xi,
+                           const int32_t *yi,
+                           const int32_t *zi,
+                           const float   *fx,
+                           const float   *fy,
+                           const float   *fz,
+                           float         *out) const
+{
+    // Corner hashes are table lookups (no gather in SSE2) - do them per lane
+    alignas(16) int32_t h[8][4];
+    for(uint32_t lane = 0; lane < 4; ++lane)
+    {
+        int32_t a = perm_[xi[lane]] + yi[lane];
+        int32_t aa = perm_[a] + zi[lane];
+        int32_t ab = perm_[a + 1] + zi[lane];
+        int32_t b = perm_[xi[lane] + 1] + yi[lane];
+        int32_t ba = perm_[b] + zi[lane];
+        int32_t bb = perm_[b + 1] + zi[lane];
+        h[0][lane] = perm_[aa];
+        h[1][lane] = perm_[ba];
+        h[2][lane] = perm_[ab];
+        h[3][lane] = perm_[bb];
+        h[4][lane] = perm_[aa + 1];
+        h[5][lane] = perm_[ba + 1];
+        h[6][lane] = perm_[ab + 1];
+        h[7][lane] = perm_[bb + 1];
+    }
+
+    __m128 one = _mm_set1_ps(1.0f);
+    __m128 x = _mm_loadu_ps(fx), y = _mm_loadu_ps(fy), z = _mm_loadu_ps(fz);
+    __m128 x1 = _mm_sub_ps(x, one), y1 = _mm_sub_ps(y, one), z1 = _mm_sub_ps(z, one);
+    __m128 u = fade4(x), v = fade4(y), w = fade4(z);
+
+    __m128 c0 = lerp4(u, grad4(h[0], x, y, z), grad4(h[1], x1, y, z));
+    __m128 c1 = lerp4(u, grad4(h[2], x, y1, z), grad4(h[3], x1, y1, z));
+    __m128 c2 = lerp4(u, grad4(h[4], x, y, z1), grad4(h[5], x1, y, z1));
+    __m128 c3 = lerp4(u, grad4(h[6], x, y1, z1), grad4(h[7], x1, y1, z1));
+    _mm_storeu_ps(out, lerp4(w, lerp4(v, c0, c1), lerp4(v, c2, c3)));
+}
+
+#else
+
+void Noise::lattice_noise4(const int32_t *xi,
+                           const int32_t *yi,
+                           const int32_t *zi,
+                           const float   *fx,
+                           const float   *fy,
+                           const float   *fz,
+                           float         *out) const
+{
+    for(uint32_t lane = 0; lane < 4; ++lane)
+        out[lane] = lattice_noise(xi[lane], yi[lane], zi[lane], fx[lane], fy[lane], fz[lane]);
+}
+
+#endif
+
+float Noise::noise(const Point3 &p, float scale) const
+{
+    int32_t xi, yi, zi;
+    float   fx, fy, fz;
+    split(p.x * scale, xi, fx);
+    split(p.y * scale, yi, fy);
+    split(p.z * scale, zi, fz);
+    return to_unit(lattice_noise(xi, yi, zi, fx, fy, fz));
+}
+
+float Noise::turbulence(float scale, const Point3 &p, uint32_t octaves) const
+{
+    int32_t xi, yi, zi;
+    float   fx, fy, fz;
+    split(p.x * scale, xi, fx);
+    split(p.y * scale, yi, fy);
+    split(p.z * scale, zi, fz);
+
+    float sum = 0.0f, amplitude = 1.0f, total = 0.0f;
+    for(uint32_t octave = 0; octave < octaves; ++octave)
+    {
+        if(octave > 0)
+        {
+            next_octave(xi, fx);
+            next_octave(yi, fy);
+            next_octave(zi, fz);
+        }
+        sum += amplitude * std::fabs(lattice_noise(xi, yi, zi, fx, fy, fz));
+        total += amplitude;
+        amplitude *= 0.5f;
+    }
+    return (total > 0.0f) ? std::min(1.0f, sum / total) : 0.0f;
+}
+
+void Noise::noise(const Point3 *points, uint32_t count, float scale, float *values) const
+{
+    alignas(16) int32_t xi[4], yi[4], zi[4];
+    alignas(16) float   fx[4], fy[4], fz[4];
+    uint32_t            i = 0;
+    for(; i + 4 <= count; i += 4)
+    {
+        for(uint32_t lane = 0; lane < 4; ++lane)
+        {
+            split(points[i + lane].x * scale, xi[lane], fx[lane]);
+            split(points[i + lane].y * scale, yi[lane], fy[lane]);
+            split(points[i + lane].z * scale, zi[lane], fz[lane]);
+        }
+        lattice_noise4(xi, yi, zi, fx, fy, fz, &values[i]);
+        for(uint32_t lane = 0; lane < 4; ++lane) values[i + lane] = to_unit(values[i + lane]);
+    }
+    for(; i < count; ++i) values[i] = noise(points[i], scale);
+}
+
+void Noise::turbulence(float         scale,
+                       const Point3 *points,
+                       uint32_t      count,
+                       float        *values,
+                       uint32_t      octaves) const
+{
+    float total = 0.0f, amplitude = 1.0f;
+    for(uint32_t octave = 0; octave < octaves; ++octave, amplitude *= 0.5f) total += amplitude;
+
+    alignas(16) int32_t xi[4], yi[4], zi[4];
+    alignas(16) float   fx[4], fy[4], fz[4];
+    alignas(16) float   n[4];
+    uint32_t            i = 0;
+    for(; i + 4 <= count; i += 4)
+    {
+        for(uint32_t lane = 0; lane < 4; ++lane)
+        {
+            split(points[i + lane].x * scale, xi[lane], fx[lane]);
+            split(points[i + lane].y * scale, yi[lane], fy[lane]);
+            split(points[i + lane].z * scale, zi[lane], fz[lane]);
+        }
+
+        float sum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        amplitude = 1.0f;
+        for(uint32_t octave = 0; octave < octaves; ++octave, amplitude *= 0.5f)
+        {
+            if(octave > 0)
+            {
+                for(uint32_t lane = 0; lane < 4; ++lane)
+                {
+                    next_octave(xi[lane], fx[lane]);
+                    next_octave(yi[lane], fy[lane]);
+                    next_octave(zi[lane], fz[lane]);
+                }
+            }
+            lattice_noise4(xi, yi, zi, fx, fy, fz, n);
+            for(uint32_t lane = 0; lane < 4; ++lane) sum[lane] += amplitude * std::fabs(n[lane]);
+        }
+        for(uint32_t lane = 0; lane < 4; ++lane)
+            values[i + lane] = (total > 0.0f) ? std::min(1.0f, sum[lane] / total) : 0.0f;
+    }
+    for(; i < count; ++i) values[i] = turbulence(scale, points[i], octaves);
 }
 
 } // namespace cg
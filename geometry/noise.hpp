@@ -13,38 +13,116 @@
 
 #include "geometry/point3.hpp"
 
+#include <cstdint>
+
 namespace cg
 {
 
-// NOTE - not required until 605.767!
-
 /**
- * Noise generation methods
+ * Noise generation methods. Gradient (Perlin) noise over an integer lattice
+ * using a permutation table built at construction. The batch methods
+ * evaluate arrays of points 4 at a time with SSE (scalar elsewhere) and give
+ * the same values as the single point methods.
  */
 class Noise
 {
   public:
+    static constexpr uint32_t DEFAULT_OCTAVES = 4;
+
     /**
-     * Constructor
+     * Constructor. Builds the permutation table with a fixed seed so noise
+     * is repeatable between runs.
      */
     Noise();
 
     /**
-     * Finds the noise at a specific 3D position. Linearly interpolates
-     * lattice noise.
+     * Constructor. Builds the permutation table from the given seed.
+     * @param  seed  Seed used to shuffle the permutation table.
+     */
+    explicit Noise(uint32_t seed);
+
+    /**
+     * Finds the noise at a specific 3D position. Interpolates gradient noise
+     * between the surrounding lattice points.
      * @param  p       Position
      * @param  scale   Scale
-     * @return  Returns linearly interpolated noise value.
+     * @return  Returns the noise value (0 to 1).
      */
-    float noise(const Point3 &p, float scale);
+    float noise(const Point3 &p, float scale) const;
 
     /**
-     * Find turbelence value.
+     * Find turbulence value: sum of absolute noise over octaves of doubling
+     * frequency and halving amplitude.
+     * @param  scale    Scale (frequency of the first octave)
+     * @param  p        Position
+     * @param  octaves  Number of octaves
+     * @return  Returns a turbulence value (0 to 1)
+     */
+    float turbulence(float scale, const Point3 &p, uint32_t octaves = DEFAULT_OCTAVES) const;
+
+    /**
+     * Finds the noise at an array of positions.
+     * @param  points  Positions
+     * @param  count   Number of positions
      * @param  scale   Scale
-     * @param  p       Position
-     * @return  Returns a turbulence value
+     * @param  values  Output: noise value (0 to 1) for each position
+     */
+    void noise(const Point3 *points, uint32_t count, float scale, float *values) const;
+
+    /**
+     * Find turbulence values at an array of positions. Each octave's lattice
+     * cell is derived from the previous octave's rather than recomputed.
+     * @param  scale    Scale (frequency of the first octave)
+     * @param  points   Positions
+     * @param  count    Number of positions
+     * @param  values   Output: turbulence value (0 to 1) for each position
+     * @param  octaves  Number of octaves
+     */
+    void turbulence(float         scale,
+                    const Point3 *points,
+                    uint32_t      count,
+                    float        *values,
+                    uint32_t      octaves = DEFAULT_OCTAVES) const;
+
+  protected:
+    int32_t perm_[512]; // Permutation table, repeated so lookups need not wrap
+
+    /**
+     * Build the permutation table.
+     * @param  seed  Seed used to shuffle the table.
+     */
+    void init(uint32_t seed);
+
+    /**
+     * Signed gradient noise within a lattice cell.
+     * @param  xi  Lattice cell (masked to 0-255)
+     * @param  yi  Lattice cell (masked to 0-255)
+     * @param  zi  Lattice cell (masked to 0-255)
+     * @param  fx  Position within the cell (0 to 1)
+     * @param  fy  Position within the cell (0 to 1)
+     * @param  fz  Position within the cell (0 to 1)
+     * @return  Returns noise (about -1 to 1).
+     */
+    float lattice_noise(int32_t xi, int32_t yi, int32_t zi, float fx, float fy, float fz) const;
+
+    /**
+     * Signed gradient noise for 4 positions (SSE where available). Arguments
+     * as for lattice_noise, one entry per position.
+     * @param  xi   Lattice cells (masked to 0-255)
+     * @param  yi   Lattice cells (masked to 0-255)
+     * @param  zi   Lattice cells (masked to 0-255)
+     * @param  fx   Positions within the cells
+     * @param  fy   Positions within the cells
+     * @param  fz   Positions within the cells
+     * @param  out  Output: noise for each position
      */
-    float turbulence(float scale, const Point3 &p);
+    void lattice_noise4(const int32_t *xi,
+                        const int32_t *yi,
+                        const int32_t *zi,
+                        const float   *fx,
+                        const float   *fy,
+                        const float   *fz,
+                        float         *out) const;
 };
 
 } // namespace cg
@@ -0,0 +1,170 @@
+#include "geometry/noise_baker.hpp"
+
+#include "geometry/geometry.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+namespace cg
+{
+
+NoiseVolume::NoiseVolume() : width(0), height(0), depth(0), format(NoiseFormat::FLOAT32) {}
+
+uint64_t NoiseVolume::sample_count() const
+{
+    return static_cast<uint64_t>(width) * height * depth;
+}
+
+const void *NoiseVolume::data() const
+{
+    return (format == NoiseFormat::FLOAT32) ? static_cast<const void *>(values.data())
+                                            : static_cast<const void *>(texels.data());
+}
+
+uint64_t NoiseVolume::size_bytes() const
+{
+    return (format == NoiseFormat::FLOAT32) ? values.size() * sizeof(float) : texels.size();
+}
+
+bool NoiseVolume::write_raw(const std::string &filename) const
+{
+    std::ofstream out(filename, std::ios::binary);
+    if(!out) return false;
+    out.write(static_cast<const char *>(data()), static_cast<std::streamsize>(size_bytes()));
+    return static_cast<bool>(out);
+}
+
+NoiseBaker::NoiseBaker(const Noise &noise) :
+    noise_(noise),
+    scale_(4.0f),
+    octaves_(Noise::DEFAULT_OCTAVES),
+    thread_count_(0),
+    stats_{0, 0, 0, 0.0, 0.0}
+{
+}
+
+void NoiseBaker::set_scale(float scale) { scale_ = scale; }
+
+void NoiseBaker::set_octaves(uint32_t octaves) { octaves_ = octaves; }
+
+void NoiseBaker::set_thread_count(uint32_t count) { thread_count_ = count; }
+
+void NoiseBaker::set_progress_callback(std::function<void(float)> callback)
+{
+    progress_callback_ = std::move(callback);
+}
+
+NoiseVolume NoiseBaker::bake(uint32_t width, uint32_t height, uint32_t depth, NoiseFormat format)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    NoiseVolume volume;
+    volume.width = width;
+    volume.height = height;
+    volume.depth = std::max(depth, 1u);
+    volume.format = format;
+    if(format == NoiseFormat::FLOAT32)
+        volume.values.resize(volume.sample_count());
+    else
+        volume.texels.resize(volume.sample_count() * 4);
+
+    uint32_t tiles_per_slice = (height + TILE_ROWS - 1) / TILE_ROWS;
+    uint32_t tile_count = tiles_per_slice * volume.depth;
+    uint32_t threads = (thread_count_ > 0) ? thread_count_
+                                           : std::max(1u, std::thread::hardware_concurrency());
+    threads = std::max(1u, std::min(threads, tile_count));
+
+    // Workers take the next tile until none remain. The calling thread waits
+    // and reports progress.
+    std::atomic<uint32_t>    next_tile{0};
+    uint32_t                 tiles_done = 0;
+    std::mutex               mutex;
+    std::condition_variable  cv;
+    std::vector<std::thread> workers;
+    for(uint32_t i = 0; i < threads; ++i)
+    {
+        workers.emplace_back(
+            [&]()
+            {
+                uint32_t tile;
+                while((tile = next_tile.fetch_add(1)) < tile_count)
+                {
+                    bake_tile(volume, tile);
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        ++tiles_done;
+                    }
+                    cv.notify_one();
+                }
+            });
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        uint32_t                     reported = 0;
+        while(tiles_done < tile_count)
+        {
+            cv.wait(lock, [&]() { return tiles_done != reported; });
+            reported = tiles_done;
+            if(progress_callback_)
+            {
+                lock.unlock();
+                progress_callback_(static_cast<float>(reported) / tile_count);
+                lock.lock();
+            }
+        }
+    }
+    for(auto &worker : workers) worker.join();
+
+    double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    stats_.samples = volume.sample_count();
+    stats_.tiles = tile_count;
+    stats_.threads = threads;
+    stats_.seconds = seconds;
+    stats_.samples_per_second = (seconds > 0.0) ? stats_.samples / seconds : 0.0;
+    return volume;
+}
+
+const NoiseBakeStats &NoiseBaker::get_stats() const { return stats_; }
+
+void NoiseBaker::bake_tile(NoiseVolume &volume, uint32_t tile) const
+{
+    uint32_t tiles_per_slice = (volume.height + TILE_ROWS - 1) / TILE_ROWS;
+    uint32_t z = tile / tiles_per_slice;
+    uint32_t y_start = (tile % tiles_per_slice) * TILE_ROWS;
+    uint32_t y_end = std::min(y_start + TILE_ROWS, volume.height);
+
+    // Evaluate a row at a time with the batch turbulence
+    std::vector<Point3> points(volume.width);
+    std::vector<float>  row(volume.width);
+    float               inv_w = 1.0f / volume.width;
+    float               inv_h = 1.0f / volume.height;
+    float               pz = static_cast<float>(z) / volume.depth;
+    for(uint32_t y = y_start; y < y_end; ++y)
+    {
+        for(uint32_t x = 0; x < volume.width; ++x) points[x].set(x * inv_w, y * inv_h, pz);
+
+        uint64_t offset = (static_cast<uint64_t>(z) * volume.height + y) * volume.width;
+        bool     is_float = volume.format == NoiseFormat::FLOAT32;
+        float   *out = is_float ? &volume.values[offset] : row.data();
+        noise_.turbulence(scale_, points.data(), volume.width, out, octaves_);
+        if(!is_float)
+        {
+            uint8_t *texel = &volume.texels[offset * 4];
+            for(uint32_t x = 0; x < volume.width; ++x, texel += 4)
+            {
+                uint8_t grey = static_cast<uint8_t>(row[x] * 255.0f + 0.5f);
+                texel[0] = texel[1] = texel[2] = grey;
+                texel[3] = 255;
+            }
+        }
+    }
+}
+
+} // namespace cg
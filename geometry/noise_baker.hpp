@@ -0,0 +1,164 @@
+//============================================================================
+//	Johns Hopkins University Engineering for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  David W. Nesbitt
+//	File:    noise_baker.hpp
+//	Purpose: Bakes turbulence into 2D / 3D volumes using all cores.
+//============================================================================
+
+#ifndef __GEOMETRY_NOISE_BAKER_HPP__
+#define __GEOMETRY_NOISE_BAKER_HPP__
+
+#include "geometry/noise.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace cg
+{
+
+/**
+ * Sample format of a baked volume.
+ */
+enum class NoiseFormat
+{
+    FLOAT32, // One float per sample
+    RGBA8    // Grey RGB with opaque alpha, 4 bytes per sample
+};
+
+/**
+ * Baked noise volume. Samples are tightly packed with x varying fastest,
+ * then y, then z. A 2D volume has depth 1.
+ */
+struct NoiseVolume
+{
+    uint32_t             width;
+    uint32_t             height;
+    uint32_t             depth;
+    NoiseFormat          format;
+    std::vector<float>   values; // Samples (FLOAT32 format)
+    std::vector<uint8_t> texels; // Samples (RGBA8 format)
+
+    /**
+     * Constructor. Creates an empty volume.
+     */
+    NoiseVolume();
+
+    /**
+     * Get the number of samples.
+     * @return  Returns width * height * depth.
+     */
+    uint64_t sample_count() const;
+
+    /**
+     * Get the sample data.
+     * @return  Returns a pointer to the values or texels (depending on format).
+     */
+    const void *data() const;
+
+    /**
+     * Get the size of the sample data in bytes.
+     * @return  Returns the data size.
+     */
+    uint64_t size_bytes() const;
+
+    /**
+     * Write the sample data (no header) to a file.
+     * @param  filename  File to write.
+     * @return  Returns true if the file was written.
+     */
+    bool write_raw(const std::string &filename) const;
+};
+
+/**
+ * Statistics from the most recent bake.
+ */
+struct NoiseBakeStats
+{
+    uint64_t samples;
+    uint32_t tiles;
+    uint32_t threads;
+    double   seconds;
+    double   samples_per_second;
+};
+
+/**
+ * Fills volumes with turbulence. The volume is split into tiles (a few rows
+ * of one z slice) which worker threads take in turn. Sample positions map
+ * the volume onto the unit cube and are then multiplied by the scale.
+ */
+class NoiseBaker
+{
+  public:
+    static constexpr uint32_t TILE_ROWS = 8;
+
+    /**
+     * Constructor.
+     * @param  noise  Noise to bake (must outlive the baker).
+     */
+    NoiseBaker(const Noise &noise);
+
+    /**
+     * Set the turbulence scale (frequency of the first octave).
+     * @param  scale  Scale.
+     */
+    void set_scale(float scale);
+
+    /**
+     * Set the number of turbulence octaves.
+     * @param  octaves  Number of octaves.
+     */
+    void set_octaves(uint32_t octaves);
+
+    /**
+     * Set the number of worker threads.
+     * @param  count  Thread count (0 uses all hardware threads).
+     */
+    void set_thread_count(uint32_t count);
+
+    /**
+     * Set a callback for progress reporting. Called on the thread calling bake
+     * with the fraction of tiles completed (ending with 1).
+     * @param  callback  Progress callback.
+     */
+    void set_progress_callback(std::function<void(float)> callback);
+
+    /**
+     * Bake a volume.
+     * @param  width   Width in samples.
+     * @param  height  Height in samples.
+     * @param  depth   Depth in samples (1 for a 2D texture).
+     * @param  format  Sample format.
+     * @return  Returns the baked volume.
+     */
+    NoiseVolume bake(uint32_t width, uint32_t height, uint32_t depth, NoiseFormat format);
+
+    /**
+     * Get statistics from the most recent bake.
+     * @return  Returns the bake statistics.
+     */
+    const NoiseBakeStats &get_stats() const;
+
+  protected:
+    const Noise               &noise_;
+    float                      scale_;
+    uint32_t                   octaves_;
+    uint32_t                   thread_count_;
+    std::function<void(float)> progress_callback_;
+    NoiseBakeStats             stats_;
+
+    /**
+     * Bake one tile.
+     * @param  volume  Volume being baked.
+     * @param  tile    Tile index.
+     */
+    void bake_tile(NoiseVolume &volume, uint32_t tile) const;
+};
+
+} // namespace cg
+
+#endif
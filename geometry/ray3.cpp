@@ -2,11 +2,28 @@
 
 #include "geometry/geometry.hpp"
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
 
 namespace cg
 {
 
+namespace
+{
+
+// Clips [t_near, t_far] to one slab given the offsets of its planes from the
+// ray origin. NaN distances (see Ray3::intersect(AABB)) fail both comparisons.
+inline void clip_slab(float lo, float hi, float inv_d, float &t_near, float &t_far)
+{
+    float t_enter = ((inv_d < 0.0f) ? hi : lo) * inv_d;
+    float t_exit = ((inv_d < 0.0f) ? lo : hi) * inv_d;
+    if(t_enter > t_near) t_near = t_enter;
+    if(t_exit < t_far) t_far = t_exit;
+}
+
+} // namespace
+
 Ray3::Ray3() : o{0.0f, 0.0f, 0.0f}, d{1.0f, 0.0f, 0.0f} {}
 
 Ray3::Ray3(const Point3 &p1, const Point3 &p2, bool normalize)
@@ -46,9 +63,16 @@ Point3 Ray3::intersect(float t) const
 
 RayObjectIntersectResult Ray3::intersect(const Plane &p) const
 {
-    // Required in 605.767
-    return RayObjectIntersectResult{false, 0.0f};
+    // No intersection if the ray is parallel to the plane
+    float denom = p.a * d.x + p.b * d.y + p.c * d.z;
+    if(std::fabs(denom) < EPSILON) return {false, 0.0f};
+
+    // Solve the plane equation at o + t * d. Only count intersections in front of the ray
+    float t = -p.solve(o) / denom;
+    if(t < 0.0f) return {false, 0.0f};
+    return {true, t};
 }
+
 RayObjectIntersectResult Ray3::intersect(const BoundingSphere &sphere) const
 {
    //vector from ray origin to sphere center
@@ -87,8 +111,29 @@ RayObjectIntersectResult Ray3::intersect(const BoundingSphere &sphere) const
 
 RayObjectIntersectResult Ray3::intersect(const AABB &box) const
 {
-    // Required in 605.767
-    return {false, 0.0f};
+    return intersect(box, Vector3(1.0f / d.x, 1.0f / d.y, 1.0f / d.z));
+}
+
+RayObjectIntersectResult Ray3::intersect(const AABB &box, const Vector3 &inv_d) const
+{
+    if(box.is_empty()) return {false, 0.0f};
+
+    // Slab test. A zero direction component gives an infinite inverse, and if the
+    // origin also lies on one of that axis's planes the product is 0 * inf = NaN.
+    // Each slab is ordered by the sign of the inverse (not by comparing the
+    // distances) and merged with comparisons that are false for NaN, so a NaN
+    // bound leaves the interval unchanged: a ray running in a face plane counts as
+    // inside that slab.
+    float t_near = -std::numeric_limits<float>::infinity();
+    float t_far = std::numeric_limits<float>::infinity();
+    clip_slab(box.minpt.x - o.x, box.maxpt.x - o.x, inv_d.x, t_near, t_far);
+    clip_slab(box.minpt.y - o.y, box.maxpt.y - o.y, inv_d.y, t_near, t_far);
+    clip_slab(box.minpt.z - o.z, box.maxpt.z - o.z, inv_d.z, t_near, t_far);
+
+    // Nearest intersection in front of the ray (the exit if the origin is inside)
+    bool  hit = t_far >= t_near && t_far >= 0.0f;
+    float t = (t_near >= 0.0f) ? t_near : t_far;
+    return {hit, hit ? t : 0.0f};
 }
 
 RayObjectIntersectResult Ray3::intersect(const std::vector<Point3> &polygon,
@@ -101,29 +146,68 @@ RayObjectIntersectResult Ray3::intersect(const std::vector<Point3> &polygon,
 RayTriangleIntersectResult
     Ray3::intersect(const Point3 &v0, const Point3 &v1, const Point3 &v2) const
 {
-    // Required in 605.767
-    return {false, 0.0f, 0.0f, 0.0f};
+    return intersect(v0, v1 - v0, v2 - v0);
+}
+
+RayTriangleIntersectResult
+    Ray3::intersect(const Point3 &v0, const Vector3 &e1, const Vector3 &e2) const
+{
+    // Moller-Trumbore. Triangles are two sided.
+    Vector3 p = d.cross(e2);
+    float   det = e1.dot(p);
+    if(std::fabs(det) < EPSILON) return {false, 0.0f, 0.0f, 0.0f};
+
+    float   inv_det = 1.0f / det;
+    Vector3 s = o - v0;
+    float   u = s.dot(p) * inv_det;
+    if(u < 0.0f || u > 1.0f) return {false, 0.0f, 0.0f, 0.0f};
+
+    Vector3 q = s.cross(e1);
+    float   v = d.dot(q) * inv_det;
+    if(v < 0.0f || u + v > 1.0f) return {false, 0.0f, 0.0f, 0.0f};
+
+    float t = e2.dot(q) * inv_det;
+    if(t < EPSILON) return {false, 0.0f, 0.0f, 0.0f};
+    return {true, t, u, v};
 }
 
 bool Ray3::does_intersect_exist(const Point3 &v0, const Point3 &v1, const Point3 &v2) const
 {
-    // Required in 605.767
-    return false;
+    return intersect(v0, v1, v2).intersects;
 }
 
 RayMeshIntersectResult Ray3::intersect(const std::vector<Point3>   &vertex_list,
                                        const std::vector<uint16_t> &face_list,
                                        float                        t_min) const
 {
-    // Required in 605.767
-    return {false, 0.0f, 0.0f, 0.0f, 0};
+    // Brute force over all faces. Use a MeshBVH for large meshes that are queried often.
+    RayMeshIntersectResult result{false, 0.0f, 0.0f, 0.0f, 0};
+    uint32_t               face_count = static_cast<uint32_t>(face_list.size() / 3);
+    for(uint32_t i = 0; i < face_count; ++i)
+    {
+        auto hit = intersect(vertex_list[face_list[i * 3]],
+                             vertex_list[face_list[i * 3 + 1]],
+                             vertex_list[face_list[i * 3 + 2]]);
+        if(hit.intersects && hit.distance < t_min)
+        {
+            t_min = hit.distance;
+            result = {true, hit.distance, hit.barycentric_u, hit.barycentric_v, i};
+        }
+    }
+    return result;
 }
 
 bool Ray3::does_intersect_exist(const std::vector<Point3>   &vertex_list,
                                 const std::vector<uint16_t> &face_list,
                                 float                        t_min) const
 {
-    // Required in 605.767
+    for(size_t i = 0; i + 2 < face_list.size(); i += 3)
+    {
+        auto hit = intersect(vertex_list[face_list[i]],
+                             vertex_list[face_list[i + 1]],
+                             vertex_list[face_list[i + 2]]);
+        if(hit.intersects && hit.distance < t_min) return true;
+    }
     return false;
 }
 
@@ -131,8 +215,24 @@ bool Ray3::does_intersect_exist(const std::vector<VertexAndNormal> &vertex_list,
                                 const std::vector<uint16_t>        &face_list,
                                 float                               t_min) const
 {
-    // Required in 605.767
+    for(size_t i = 0; i + 2 < face_list.size(); i += 3)
+    {
+        auto hit = intersect(vertex_list[face_list[i]].vertex,
+                             vertex_list[face_list[i + 1]].vertex,
+                             vertex_list[face_list[i + 2]].vertex);
+        if(hit.intersects && hit.distance < t_min) return true;
+    }
     return false;
 }
 
+RayMeshIntersectResult Ray3::intersect(const MeshBVH &bvh, float t_min) const
+{
+    return bvh.intersect(*this, t_min);
+}
+
+bool Ray3::does_intersect_exist(const MeshBVH &bvh, float t_min) const
+{
+    return bvh.does_intersect_exist(*this, t_min);
+}
+
 } // namespace cg
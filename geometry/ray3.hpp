@@ -25,6 +25,7 @@ namespace cg
 {
 
 // Forward Declarations
+class MeshBVH;
 struct RayRefractionResult;
 struct RayObjectIntersectResult;
 struct RayTriangleIntersectResult;
@@ -120,6 +121,17 @@ struct Ray3
      */
     RayObjectIntersectResult intersect(const AABB &box) const;
 
+    /**
+     * Intersection of a ray and an axis aligned bounding box given the
+     * precomputed inverse of the ray direction. Use when testing one ray
+     * against many boxes.
+     * @param  box    AABB to test intersection with
+     * @param  inv_d  Inverse ray direction (1/d.x, 1/d.y, 1/d.z)
+     * @return Returns whether or not there is an intersection, and the distance
+     *         at which the intersection occurs (0.0 if no intersection).
+     */
+    RayObjectIntersectResult intersect(const AABB &box, const Vector3 &inv_d) const;
+
     /**
      * Intersection of a ray and a polygon
      * @param  polygon  Polygon to test intersection with
@@ -142,6 +154,19 @@ struct Ray3
     RayTriangleIntersectResult
         intersect(const Point3 &v0, const Point3 &v1, const Point3 &v2) const;
 
+    /**
+     * Intersection of a ray with a triangle given as a vertex and the 2 edges
+     * leaving it (e1 = v1 - v0, e2 = v2 - v0). Lets meshes precompute edges.
+     * @param   v0  Vertex of the triangle
+     * @param   e1  Edge from v0 to v1
+     * @param   e2  Edge from v0 to v2
+     * @return Returns whether or not there is an intersection, the distance
+     *         at which the intersection occurs (0.0 if no intersection), and
+     *         the barycentric coordinates of intersection.
+     */
+    RayTriangleIntersectResult
+        intersect(const Point3 &v0, const Vector3 &e1, const Vector3 &e2) const;
+
     /**
      * Does an intersection exist between ray with a triangle.
      * @param  v0  Vertex 0 of the triangle
@@ -190,6 +215,26 @@ struct Ray3
     bool does_intersect_exist(const std::vector<VertexAndNormal> &vertex_list,
                               const std::vector<uint16_t>        &face_list,
                               float                               t_min) const;
+
+    /**
+     * Calculates the intersect of a ray and a triangle mesh using a prebuilt
+     * bounding volume hierarchy. Use for large meshes that are queried often.
+     * @param bvh    Bounding volume hierarchy over the triangle mesh.
+     * @param t_min  Current minimum intersection (t) value along the ray.
+     * @return Returns whether or not there is an intersection, the distance
+     *         at which the intersection occurs (0.0 if no intersection),
+     *         the barycentric coordinates of intersection, and the face index.
+     */
+    RayMeshIntersectResult intersect(const MeshBVH &bvh, float t_min) const;
+
+    /**
+     * Does an intersection exist between ray and a triangle mesh using a prebuilt
+     * bounding volume hierarchy. The intersection must occur prior to t_min.
+     * @param bvh    Bounding volume hierarchy over the triangle mesh.
+     * @param t_min  t value for intersection.
+     * @return Returns true if an intersection exists, false if not.
+     */
+    bool does_intersect_exist(const MeshBVH &bvh, float t_min) const;
 };
 
 struct RayRefractionResult
@@ -0,0 +1,201 @@
+#include "geometry/ray_packet.hpp"
+
+#include "geometry/geometry.hpp"
+#include "geometry/simd.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace cg
+{
+
+RayPacket4::RayPacket4() : active_mask(0)
+{
+    for(uint32_t i = 0; i < WIDTH; ++i) set(i, Ray3());
+    active_mask = 0;
+}
+
+RayPacket4::RayPacket4(const Ray3 *rays, uint32_t count) : RayPacket4()
+{
+    for(uint32_t i = 0; i < count && i < WIDTH; ++i) set(i, rays[i]);
+}
+
+void RayPacket4::set(uint32_t lane, const Ray3 &ray)
+{
+    ox[lane] = ray.o.x;
+    oy[lane] = ray.o.y;
+    oz[lane] = ray.o.z;
+    dx[lane] = ray.d.x;
+    dy[lane] = ray.d.y;
+    dz[lane] = ray.d.z;
+    inv_dx[lane] = 1.0f / ray.d.x;
+    inv_dy[lane] = 1.0f / ray.d.y;
+    inv_dz[lane] = 1.0f / ray.d.z;
+    active_mask |= 1u << lane;
+}
+
+Ray3 RayPacket4::get(uint32_t lane) const
+{
+    return Ray3(Point3(ox[lane], oy[lane], oz[lane]), Vector3(dx[lane], dy[lane], dz[lane]));
+}
+
+uint32_t RayPacket4::intersect(const AABB &box, const float *t_max, float *t_entry) const
+{
+    if(box.is_empty()) return 0;
+    return intersect_box(&box.minpt.x, &box.maxpt.x, t_max, t_entry);
+}
+
+#ifdef CG_SIMD_SSE2
+
+namespace
+{
+
+// Clips [t_near, t_far] to one slab in each lane. The entry and exit planes are
+// chosen by the sign of the inverse direction, and maxps / minps return their
+// second operand when either is NaN, so a 0 * inf distance (zero direction with
+// the origin on a slab plane) leaves that lane's interval unchanged.
+inline void clip_slab(float lo, float hi, __m128 o, __m128 inv, __m128 &t_near, __m128 &t_far)
+{
+    __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(lo), o), inv);
+    __m128 t2 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(hi), o), inv);
+    __m128 neg = _mm_cmplt_ps(inv, _mm_setzero_ps());
+    __m128 t_enter = _mm_or_ps(_mm_and_ps(neg, t2), _mm_andnot_ps(neg, t1));
+    __m128 t_exit = _mm_or_ps(_mm_and_ps(neg, t1), _mm_andnot_ps(neg, t2));
+    t_near = _mm_max_ps(t_enter, t_near);
+    t_far = _mm_min_ps(t_exit, t_far);
+}
+
+} // namespace
+
+uint32_t RayPacket4::intersect_box(const float *bmin,
+                                   const float *bmax,
+                                   const float *t_max,
+                                   float       *t_entry) const
+{
+    __m128 t_near = _mm_set1_ps(-std::numeric_limits<float>::infinity());
+    __m128 t_far = _mm_set1_ps(std::numeric_limits<float>::infinity());
+    clip_slab(bmin[0], bmax[0], _mm_load_ps(ox), _mm_load_ps(inv_dx), t_near, t_far);
+    clip_slab(bmin[1], bmax[1], _mm_load_ps(oy), _mm_load_ps(inv_dy), t_near, t_far);
+    clip_slab(bmin[2], bmax[2], _mm_load_ps(oz), _mm_load_ps(inv_dz), t_near, t_far);
+
+    __m128 hit = _mm_and_ps(_mm_cmpge_ps(t_far, t_near), _mm_cmpge_ps(t_far, _mm_setzero_ps()));
+    hit = _mm_and_ps(hit, _mm_cmplt_ps(t_near, _mm_loadu_ps(t_max)));
+    if(t_entry != nullptr) _mm_storeu_ps(t_entry, t_near);
+    return static_cast<uint32_t>(_mm_movemask_ps(hit)) & active_mask;
+}
+
+uint32_t RayPacket4::intersect(const Point3  &v0,
+                               const Vector3 &e1,
+                               const Vector3 &e2,
+                               float         *t,
+                               float         *u,
+                               float         *v) const
+{
+    __m128 dx4 = _mm_load_ps(dx), dy4 = _mm_load_ps(dy), dz4 = _mm_load_ps(dz);
+    __m128 e1x = _mm_set1_ps(e1.x), e1y = _mm_set1_ps(e1.y), e1z = _mm_set1_ps(e1.z);
+    __m128 e2x = _mm_set1_ps(e2.x), e2y = _mm_set1_ps(e2.y), e2z = _mm_set1_ps(e2.z);
+
+    // p = d x e2, det = e1 . p
+    __m128 px = _mm_sub_ps(_mm_mul_ps(dy4, e2z), _mm_mul_ps(dz4, e2y));
+    __m128 py = _mm_sub_ps(_mm_mul_ps(dz4, e2x), _mm_mul_ps(dx4, e2z));
+    __m128 pz = _mm_sub_ps(_mm_mul_ps(dx4, e2y), _mm_mul_ps(dy4, e2x));
+    __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)),
+                            _mm_mul_ps(e1z, pz));
+    __m128 inv_det = _mm_div_ps(_mm_set1_ps(1.0f), det);
+
+    // s = o - v0, u = (s . p) / det
+    __m128 sx = _mm_sub_ps(_mm_load_ps(ox), _mm_set1_ps(v0.x));
+    __m128 sy = _mm_sub_ps(_mm_load_ps(oy), _mm_set1_ps(v0.y));
+    __m128 sz = _mm_sub_ps(_mm_load_ps(oz), _mm_set1_ps(v0.z));
+    __m128 u4 = _mm_mul_ps(
+        _mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)),
+        inv_det);
+
+    // q = s x e1, v = (d . q) / det, t = (e2 . q) / det
+    __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+    __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+    __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+    __m128 v4 = _mm_mul_ps(
+        _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx4, qx), _mm_mul_ps(dy4, qy)), _mm_mul_ps(dz4, qz)),
+        inv_det);
+    __m128 t4 = _mm_mul_ps(
+        _mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)),
+        inv_det);
+
+    // Combine the rejection tests. |det| is computed by clearing the sign bit.
+    __m128 zero = _mm_setzero_ps();
+    __m128 abs_det = _mm_andnot_ps(_mm_set1_ps(-0.0f), det);
+    __m128 t_cur = _mm_loadu_ps(t);
+    __m128 hit = _mm_cmpge_ps(abs_det, _mm_set1_ps(EPSILON));
+    hit = _mm_and_ps(hit, _mm_cmpge_ps(u4, zero));
+    hit = _mm_and_ps(hit, _mm_cmpge_ps(v4, zero));
+    hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_add_ps(u4, v4), _mm_set1_ps(1.0f)));
+    hit = _mm_and_ps(hit, _mm_cmpge_ps(t4, _mm_set1_ps(EPSILON)));
+    hit = _mm_and_ps(hit, _mm_cmplt_ps(t4, t_cur));
+    uint32_t mask = static_cast<uint32_t>(_mm_movemask_ps(hit)) & active_mask;
+    if(mask == 0) return 0;
+
+    // Replace t, u, v in the lanes that hit
+    hit = _mm_castsi128_ps(_mm_set_epi32((mask & 8) ? -1 : 0, (mask & 4) ? -1 : 0,
+                                         (mask & 2) ? -1 : 0, (mask & 1) ? -1 : 0));
+    _mm_storeu_ps(t, _mm_or_ps(_mm_and_ps(hit, t4), _mm_andnot_ps(hit, t_cur)));
+    _mm_storeu_ps(u, _mm_or_ps(_mm_and_ps(hit, u4), _mm_andnot_ps(hit, _mm_loadu_ps(u))));
+    _mm_storeu_ps(v, _mm_or_ps(_mm_and_ps(hit, v4), _mm_andnot_ps(hit, _mm_loadu_ps(v))));
+    return mask;
+}
+
+#else
+
+uint32_t RayPacket4::intersect_box(const float *bmin,
+                                   const float *bmax,
+                                   const float *t_max,
+                                   float       *t_entry) const
+{
+    uint32_t mask = 0;
+    for(uint32_t i = 0; i < WIDTH; ++i)
+    {
+        // Same NaN-safe ordering as the SSE path
+        const float o[3] = {ox[i], oy[i], oz[i]};
+        const float inv[3] = {inv_dx[i], inv_dy[i], inv_dz[i]};
+        float       t_near = -std::numeric_limits<float>::infinity();
+        float       t_far = std::numeric_limits<float>::infinity();
+        for(uint32_t a = 0; a < 3; ++a)
+        {
+            bool  neg = inv[a] < 0.0f;
+            float t_enter = ((neg ? bmax[a] : bmin[a]) - o[a]) * inv[a];
+            float t_exit = ((neg ? bmin[a] : bmax[a]) - o[a]) * inv[a];
+            if(t_enter > t_near) t_near = t_enter;
+            if(t_exit < t_far) t_far = t_exit;
+        }
+        if(t_far >= t_near && t_far >= 0.0f && t_near < t_max[i]) mask |= 1u << i;
+        if(t_entry != nullptr) t_entry[i] = t_near;
+    }
+    return mask & active_mask;
+}
+
+uint32_t RayPacket4::intersect(const Point3  &v0,
+                               const Vector3 &e1,
+                               const Vector3 &e2,
+                               float         *t,
+                               float         *u,
+                               float         *v) const
+{
+    uint32_t mask = 0;
+    for(uint32_t i = 0; i < WIDTH; ++i)
+    {
+        if((active_mask & (1u << i)) == 0) continue;
+        auto hit = get(i).intersect(v0, e1, e2);
+        if(hit.intersects && hit.distance < t[i])
+        {
+            t[i] = hit.distance;
+            u[i] = hit.barycentric_u;
+            v[i] = hit.barycentric_v;
+            mask |= 1u << i;
+        }
+    }
+    return mask;
+}
+
+#endif
+
+} // namespace cg
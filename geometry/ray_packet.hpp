@@ -0,0 +1,116 @@
+//============================================================================
+//	Johns Hopkins University Engineering for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  David W. Nesbitt
+//	File:    ray_packet.hpp
+//	Purpose: Packet of 4 rays stored in SoA form. Tests all 4 rays against
+//           a box or triangle at once (SSE where available).
+//============================================================================
+
+#ifndef __GEOMETRY_RAY_PACKET_HPP__
+#define __GEOMETRY_RAY_PACKET_HPP__
+
+#include "geometry/aabb.hpp"
+#include "geometry/point3.hpp"
+#include "geometry/ray3.hpp"
+#include "geometry/vector3.hpp"
+
+#include <cstdint>
+
+namespace cg
+{
+
+/**
+ * Packet of 4 rays in structure of arrays form. Intended for coherent rays
+ * (picking grids, shadow probes) so that one box test during traversal
+ * serves all 4 rays. Lanes not holding a ray are excluded by active_mask.
+ * Test results are returned as a 4 bit mask (bit i set if ray i hits).
+ */
+struct alignas(16) RayPacket4
+{
+    static constexpr uint32_t WIDTH = 4;
+
+    float    ox[WIDTH];     // Ray origins
+    float    oy[WIDTH];
+    float    oz[WIDTH];
+    float    dx[WIDTH];     // Ray directions
+    float    dy[WIDTH];
+    float    dz[WIDTH];
+    float    inv_dx[WIDTH]; // Inverse ray directions (for slab tests)
+    float    inv_dy[WIDTH];
+    float    inv_dz[WIDTH];
+    uint32_t active_mask;   // Bit i set if lane i holds a ray
+
+    /**
+     * Default constructor. Creates an empty packet (no active lanes).
+     */
+    RayPacket4();
+
+    /**
+     * Constructor from an array of rays.
+     * @param  rays   Rays to place in the packet.
+     * @param  count  Number of rays (at most 4).
+     */
+    RayPacket4(const Ray3 *rays, uint32_t count);
+
+    /**
+     * Set the ray in a lane and mark the lane active.
+     * @param  lane  Lane index (0-3).
+     * @param  ray   Ray to store.
+     */
+    void set(uint32_t lane, const Ray3 &ray);
+
+    /**
+     * Get the ray stored in a lane.
+     * @param  lane  Lane index (0-3).
+     * @return Returns the ray.
+     */
+    Ray3 get(uint32_t lane) const;
+
+    /**
+     * Slab test of all rays against an axis aligned bounding box.
+     * @param  box      AABB to test intersection with.
+     * @param  t_max    Per ray limit: boxes entered at or beyond this are missed.
+     * @param  t_entry  Output (may be null): per ray entry distance.
+     * @return Returns the mask of rays that hit the box.
+     */
+    uint32_t intersect(const AABB &box, const float *t_max, float *t_entry = nullptr) const;
+
+    /**
+     * Slab test of all rays against a box given as min and max arrays.
+     * @param  bmin     Box minimum (x,y,z).
+     * @param  bmax     Box maximum (x,y,z).
+     * @param  t_max    Per ray limit: boxes entered at or beyond this are missed.
+     * @param  t_entry  Output (may be null): per ray entry distance.
+     * @return Returns the mask of rays that hit the box.
+     */
+    uint32_t intersect_box(const float *bmin,
+                           const float *bmax,
+                           const float *t_max,
+                           float       *t_entry) const;
+
+    /**
+     * Intersection of all rays with a triangle given as a vertex and 2 edges
+     * (Moller-Trumbore, two sided). Rays that hit nearer than their current
+     * t have t, u, and v replaced.
+     * @param  v0     Vertex of the triangle.
+     * @param  e1     Edge from v0 to v1.
+     * @param  e2     Edge from v0 to v2.
+     * @param  t      In/out: per ray nearest distance so far.
+     * @param  u      Out: barycentric u of rays that hit.
+     * @param  v      Out: barycentric v of rays that hit.
+     * @return Returns the mask of rays whose nearest hit was updated.
+     */
+    uint32_t intersect(const Point3  &v0,
+                       const Vector3 &e1,
+                       const Vector3 &e2,
+                       float         *t,
+                       float         *u,
+                       float         *v) const;
+};
+
+} // namespace cg
+
+#endif
@@ -0,0 +1,20 @@
+//============================================================================
+//	Johns Hopkins University Engineering for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  David W. Nesbitt
+//	File:    simd.hpp
+//	Purpose: Detects SIMD support. Defines CG_SIMD_SSE2 and includes the
+//           SSE2 intrinsics when the target supports them.
+//============================================================================
+
+#ifndef __GEOMETRY_SIMD_HPP__
+#define __GEOMETRY_SIMD_HPP__
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CG_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#endif
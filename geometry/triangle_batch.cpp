@@ -0,0 +1,182 @@
+#include "geometry/triangle_batch.hpp"
+
+#include "geometry/geometry.hpp"
+#include "geometry/simd.hpp"
+
+#include <algorithm>
+
+namespace cg
+{
+
+namespace
+{
+
+constexpr uint32_t PADDING = 3; // Lets a 4 wide load start at the last triangle
+
+} // namespace
+
+TriangleBatch::TriangleBatch() : count_(0) {}
+
+void TriangleBatch::clear()
+{
+    count_ = 0;
+    for(auto *a : {&v0x_, &v0y_, &v0z_, &e1x_, &e1y_, &e1z_, &e2x_, &e2y_, &e2z_}) a->clear();
+}
+
+void TriangleBatch::reserve(uint32_t count)
+{
+    for(auto *a : {&v0x_, &v0y_, &v0z_, &e1x_, &e1y_, &e1z_, &e2x_, &e2y_, &e2z_})
+        a->reserve(count + PADDING);
+}
+
+void TriangleBatch::add(const Point3 &v0, const Point3 &v1, const Point3 &v2)
+{
+    uint32_t i = count_++;
+    for(auto *a : {&v0x_, &v0y_, &v0z_, &e1x_, &e1y_, &e1z_, &e2x_, &e2y_, &e2z_})
+        a->resize(count_ + PADDING, 0.0f);
+
+    Vector3 e1 = v1 - v0;
+    Vector3 e2 = v2 - v0;
+    v0x_[i] = v0.x;
+    v0y_[i] = v0.y;
+    v0z_[i] = v0.z;
+    e1x_[i] = e1.x;
+    e1y_[i] = e1.y;
+    e1z_[i] = e1.z;
+    e2x_[i] = e2.x;
+    e2y_[i] = e2.y;
+    e2z_[i] = e2.z;
+}
+
+uint32_t TriangleBatch::size() const { return count_; }
+
+Point3 TriangleBatch::v0(uint32_t i) const { return Point3(v0x_[i], v0y_[i], v0z_[i]); }
+
+Vector3 TriangleBatch::e1(uint32_t i) const { return Vector3(e1x_[i], e1y_[i], e1z_[i]); }
+
+Vector3 TriangleBatch::e2(uint32_t i) const { return Vector3(e2x_[i], e2y_[i], e2z_[i]); }
+
+#ifdef CG_SIMD_SSE2
+
+RayMeshIntersectResult
+    TriangleBatch::intersect(const Ray3 &ray, uint32_t first, uint32_t count, float t_min) const
+{
+    RayMeshIntersectResult result{false, 0.0f, 0.0f, 0.0f, 0};
+
+    __m128 dx = _mm_set1_ps(ray.d.x), dy = _mm_set1_ps(ray.d.y), dz = _mm_set1_ps(ray.d.z);
+    __m128 ox = _mm_set1_ps(ray.o.x), oy = _mm_set1_ps(ray.o.y), oz = _mm_set1_ps(ray.o.z);
+    __m128 zero = _mm_setzero_ps();
+    __m128 one = _mm_set1_ps(1.0f);
+    __m128 eps = _mm_set1_ps(EPSILON);
+    __m128 sign_bit = _mm_set1_ps(-0.0f);
+
+    uint32_t end = first + count;
+    for(uint32_t i = first; i < end; i += 4)
+    {
+        __m128 e1x = _mm_loadu_ps(&e1x_[i]), e1y = _mm_loadu_ps(&e1y_[i]),
+               e1z = _mm_loadu_ps(&e1z_[i]);
+        __m128 e2x = _mm_loadu_ps(&e2x_[i]), e2y = _mm_loadu_ps(&e2y_[i]),
+               e2z = _mm_loadu_ps(&e2z_[i]);
+
+        // p = d x e2, det = e1 . p
+        __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+        __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+        __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+        __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)),
+                                _mm_mul_ps(e1z, pz));
+        __m128 inv_det = _mm_div_ps(one, det);
+
+        // s = o - v0, u = (s . p) / det
+        __m128 sx = _mm_sub_ps(ox, _mm_loadu_ps(&v0x_[i]));
+        __m128 sy = _mm_sub_ps(oy, _mm_loadu_ps(&v0y_[i]));
+        __m128 sz = _mm_sub_ps(oz, _mm_loadu_ps(&v0z_[i]));
+        __m128 u = _mm_mul_ps(
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)),
+            inv_det);
+
+        // q = s x e1, v = (d . q) / det, t = (e2 . q) / det
+        __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+        __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+        __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+        __m128 v = _mm_mul_ps(
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)),
+            inv_det);
+        __m128 t = _mm_mul_ps(
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)),
+            inv_det);
+
+        __m128 hit = _mm_cmpge_ps(_mm_andnot_ps(sign_bit, det), eps);
+        hit = _mm_and_ps(hit, _mm_cmpge_ps(u, zero));
+        hit = _mm_and_ps(hit, _mm_cmpge_ps(v, zero));
+        hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_add_ps(u, v), one));
+        hit = _mm_and_ps(hit, _mm_cmpge_ps(t, eps));
+        hit = _mm_and_ps(hit, _mm_cmplt_ps(t, _mm_set1_ps(t_min)));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_ps(hit));
+        if(end - i < 4) mask &= (1u << (end - i)) - 1;
+        if(mask == 0) continue;
+
+        // Rare: pick the nearest of the lanes that hit
+        alignas(16) float ta[4], ua[4], va[4];
+        _mm_store_ps(ta, t);
+        _mm_store_ps(ua, u);
+        _mm_store_ps(va, v);
+        for(uint32_t lane = 0; lane < 4; ++lane)
+        {
+            if((mask & (1u << lane)) && ta[lane] < t_min)
+            {
+                t_min = ta[lane];
+                result = {true, ta[lane], ua[lane], va[lane], i + lane};
+            }
+        }
+    }
+    return result;
+}
+
+bool TriangleBatch::does_intersect_exist(const Ray3 &ray,
+                                         uint32_t    first,
+                                         uint32_t    count,
+                                         float       t_min) const
+{
+    // Test 4 at a time and stop at the first block with a hit
+    uint32_t end = first + count;
+    for(uint32_t i = first; i < end; i += 4)
+    {
+        if(intersect(ray, i, std::min(4u, end - i), t_min).intersects) return true;
+    }
+    return false;
+}
+
+#else
+
+RayMeshIntersectResult
+    TriangleBatch::intersect(const Ray3 &ray, uint32_t first, uint32_t count, float t_min) const
+{
+    RayMeshIntersectResult result{false, 0.0f, 0.0f, 0.0f, 0};
+    for(uint32_t i = first; i < first + count; ++i)
+    {
+        auto hit = ray.intersect(v0(i), e1(i), e2(i));
+        if(hit.intersects && hit.distance < t_min)
+        {
+            t_min = hit.distance;
+            result = {true, hit.distance, hit.barycentric_u, hit.barycentric_v, i};
+        }
+    }
+    return result;
+}
+
+bool TriangleBatch::does_intersect_exist(const Ray3 &ray,
+                                         uint32_t    first,
+                                         uint32_t    count,
+                                         float       t_min) const
+{
+    for(uint32_t i = first; i < first + count; ++i)
+    {
+        auto hit = ray.intersect(v0(i), e1(i), e2(i));
+        if(hit.intersects && hit.distance < t_min) return true;
+    }
+    return false;
+}
+
+#endif
+
+} // namespace cg
@@ -0,0 +1,116 @@
+//============================================================================
+//	Johns Hopkins University Engineering for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  David W. Nesbitt
+//	File:    triangle_batch.hpp
+//	Purpose: Triangles stored in SoA form for testing one ray against a
+//           contiguous block of triangles (4 at a time with SSE).
+//============================================================================
+
+#ifndef __GEOMETRY_TRIANGLE_BATCH_HPP__
+#define __GEOMETRY_TRIANGLE_BATCH_HPP__
+
+#include "geometry/point3.hpp"
+#include "geometry/ray3.hpp"
+#include "geometry/vector3.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace cg
+{
+
+/**
+ * Triangles in structure of arrays form: vertex 0 and the 2 edges leaving it
+ * (the form used by Moller-Trumbore). Arrays are padded with 3 degenerate
+ * triangles so a block starting at any index can be loaded 4 wide.
+ */
+class TriangleBatch
+{
+  public:
+    /**
+     * Constructor. Creates an empty batch.
+     */
+    TriangleBatch();
+
+    /**
+     * Remove all triangles.
+     */
+    void clear();
+
+    /**
+     * Reserve storage.
+     * @param  count  Number of triangles.
+     */
+    void reserve(uint32_t count);
+
+    /**
+     * Append a triangle.
+     * @param  v0  Vertex 0 of the triangle
+     * @param  v1  Vertex 1 of the triangle
+     * @param  v2  Vertex 2 of the triangle
+     */
+    void add(const Point3 &v0, const Point3 &v1, const Point3 &v2);
+
+    /**
+     * Get the number of triangles (excluding padding).
+     * @return  Returns the triangle count.
+     */
+    uint32_t size() const;
+
+    /**
+     * Get vertex 0 of a triangle.
+     * @param  i  Triangle index.
+     * @return  Returns the vertex.
+     */
+    Point3 v0(uint32_t i) const;
+
+    /**
+     * Get the edge from vertex 0 to vertex 1 of a triangle.
+     * @param  i  Triangle index.
+     * @return  Returns the edge.
+     */
+    Vector3 e1(uint32_t i) const;
+
+    /**
+     * Get the edge from vertex 0 to vertex 2 of a triangle.
+     * @param  i  Triangle index.
+     * @return  Returns the edge.
+     */
+    Vector3 e2(uint32_t i) const;
+
+    /**
+     * Find the nearest intersection of a ray with a contiguous block of triangles
+     * that occurs before t_min.
+     * @param  ray    Ray to intersect.
+     * @param  first  Index of the first triangle in the block.
+     * @param  count  Number of triangles in the block.
+     * @param  t_min  Current minimum intersection (t) value along the ray.
+     * @return Returns whether or not there is an intersection, the distance,
+     *         the barycentric coordinates, and the index (face_index) of the triangle.
+     */
+    RayMeshIntersectResult
+        intersect(const Ray3 &ray, uint32_t first, uint32_t count, float t_min) const;
+
+    /**
+     * Does any triangle in a contiguous block intersect the ray before t_min?
+     * @param  ray    Ray to intersect.
+     * @param  first  Index of the first triangle in the block.
+     * @param  count  Number of triangles in the block.
+     * @param  t_min  t value for intersection.
+     * @return Returns true if an intersection exists, false if not.
+     */
+    bool does_intersect_exist(const Ray3 &ray, uint32_t first, uint32_t count, float t_min) const;
+
+  protected:
+    uint32_t           count_;
+    std::vector<float> v0x_, v0y_, v0z_; // Vertex 0
+    std::vector<float> e1x_, e1y_, e1z_; // Edge v1 - v0
+    std::vector<float> e2x_, e2y_, e2z_; // Edge v2 - v0
+};
+
+} // namespace cg
+
+#endif
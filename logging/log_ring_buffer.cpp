@@ -0,0 +1,86 @@
+
+
+#include "logging/log_ring_buffer.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+namespace cg
+{
+
+LogRingBuffer::LogRingBuffer(uint32_t capacity) : push_position_(0), pop_position_(0)
+{
+    uint64_t size = 2;
+    while(size < capacity) size <<= 1;
+    mask_ = size - 1;
+    slots_.reset(new Slot[size]);
+    for(uint64_t i = 0; i < size; ++i) slots_[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+bool LogRingBuffer::push(LogLevel level, const char *format, va_list args)
+{
+    // Claim the slot at the push position if the consumer has freed it
+    uint64_t position = push_position_.load(std::memory_order_relaxed);
+    Slot    *slot;
+    for(;;)
+    {
+        slot = &slots_[position & mask_];
+        uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+        int64_t  difference = static_cast<int64_t>(sequence - position);
+        if(difference == 0)
+        {
+            if(push_position_.compare_exchange_weak(position, position + 1,
+                                                    std::memory_order_relaxed))
+                break;
+        }
+        else if(difference < 0)
+        {
+            return false;
+        }
+        else
+        {
+            position = push_position_.load(std::memory_order_relaxed);
+        }
+    }
+
+    int32_t length = std::vsnprintf(slot->record.text, LOG_MESSAGE_SIZE, format, args);
+    if(length < 0) length = 0;
+    if(length >= static_cast<int32_t>(LOG_MESSAGE_SIZE))
+    {
+        // Mark the truncation so a cut off line is not mistaken for the whole message
+        length = LOG_MESSAGE_SIZE - 1;
+        std::memcpy(slot->record.text + length - 3, "...", 3);
+    }
+    slot->record.level = level;
+    slot->record.length = static_cast<uint16_t>(length);
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+bool LogRingBuffer::pop(LogRecord &record)
+{
+    uint64_t position = pop_position_.load(std::memory_order_relaxed);
+    Slot    &slot = slots_[position & mask_];
+    if(slot.sequence.load(std::memory_order_acquire) != position + 1) return false;
+
+    record.level = slot.record.level;
+    record.length = slot.record.length;
+    std::memcpy(record.text, slot.record.text, record.length + 1);
+
+    // Hand the slot back to producers one lap ahead
+    slot.sequence.store(position + mask_ + 1, std::memory_order_release);
+    pop_position_.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+uint64_t LogRingBuffer::get_push_count() const
+{
+    return push_position_.load(std::memory_order_acquire);
+}
+
+uint64_t LogRingBuffer::get_pop_count() const
+{
+    return pop_position_.load(std::memory_order_acquire);
+}
+
+} // namespace cg
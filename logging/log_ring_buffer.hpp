@@ -0,0 +1,108 @@
+///============================================================================
+//	Johns Hopkins University Engineering Programs for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  Brian Russin
+//	File:    log_ring_buffer.hpp
+//	Purpose: Lock-free bounded multiple producer / single consumer ring
+//           buffer of log records.
+//============================================================================
+
+#ifndef __LOGGING_LOG_RING_BUFFER_HPP__
+#define __LOGGING_LOG_RING_BUFFER_HPP__
+
+#include <atomic>
+#include <cstdarg>
+#include <cstdint>
+#include <memory>
+
+namespace cg
+{
+
+// Log levels (ERR since windows.h defines ERROR)
+enum class LogLevel : uint8_t
+{
+    DEBUG = 0,
+    INFO,
+    WARNING,
+    ERR
+};
+
+// Longest message kept (including the terminating null); longer ones are truncated
+// and end in "..."
+constexpr uint32_t LOG_MESSAGE_SIZE = 240;
+
+/**
+ * One formatted log message.
+ */
+struct LogRecord
+{
+    LogLevel level;
+    uint16_t length;
+    char     text[LOG_MESSAGE_SIZE];
+};
+
+/**
+ * Bounded ring buffer of log records (Vyukov). Any number of threads may
+ * push; a single thread pops. Messages are formatted straight into their
+ * slot, so pushing never allocates, locks or makes a system call. A push to
+ * a full buffer fails rather than waiting.
+ */
+class LogRingBuffer
+{
+  public:
+    /**
+     * Constructor.
+     * @param  capacity  Number of records (rounded up to a power of 2).
+     */
+    explicit LogRingBuffer(uint32_t capacity);
+
+    LogRingBuffer(const LogRingBuffer &) = delete;
+    LogRingBuffer &operator=(const LogRingBuffer &) = delete;
+
+    /**
+     * Format a message into the buffer. Safe to call from any thread.
+     * @param  level   Log level.
+     * @param  format  printf style format.
+     * @param  args    Format arguments.
+     * @return  Returns false if the buffer is full (the message is not added).
+     */
+    bool push(LogLevel level, const char *format, va_list args);
+
+    /**
+     * Remove the oldest record. Call from the consumer thread only.
+     * @param  record  Output: the record.
+     * @return  Returns false if the buffer is empty.
+     */
+    bool pop(LogRecord &record);
+
+    /**
+     * Get the number of records pushed so far.
+     * @return  Returns the push count.
+     */
+    uint64_t get_push_count() const;
+
+    /**
+     * Get the number of records popped so far.
+     * @return  Returns the pop count.
+     */
+    uint64_t get_pop_count() const;
+
+  protected:
+    // Sequence numbers tell producers and the consumer whose turn a slot is
+    struct alignas(64) Slot
+    {
+        std::atomic<uint64_t> sequence;
+        LogRecord             record;
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    uint64_t                mask_;
+    alignas(64) std::atomic<uint64_t> push_position_;
+    alignas(64) std::atomic<uint64_t> pop_position_;
+};
+
+} // namespace cg
+
+#endif
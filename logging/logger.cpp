@@ -0,0 +1,138 @@
+
+
+#include "logging/logger.hpp"
+
+#include <chrono>
+
+namespace cg
+{
+
+// How long the writer sleeps when there is nothing to write
+static constexpr auto WRITER_IDLE_TIME = std::chrono::milliseconds(5);
+
+static const char *level_prefix(LogLevel level)
+{
+    switch(level)
+    {
+        case LogLevel::DEBUG: return "Debug: ";
+        case LogLevel::WARNING: return "Warning: ";
+        case LogLevel::ERR: return "Error: ";
+        default: return "";
+    }
+}
+
+Logger::Logger(uint32_t capacity)
+    : buffer_(capacity), file_(nullptr), wait_if_full_(false), stop_(false), written_count_(0),
+      dropped_count_(0)
+{
+}
+
+Logger::~Logger() { close(); }
+
+bool Logger::open(const std::string &filename, bool wait_if_full)
+{
+    close();
+    file_ = fopen(filename.c_str(), "w");
+    if(file_ == nullptr) return false;
+
+    wait_if_full_ = wait_if_full;
+    stop_ = false;
+    writer_ = std::thread(&Logger::run_writer, this);
+    return true;
+}
+
+void Logger::close()
+{
+    if(file_ == nullptr) return;
+
+    wait_if_full_ = false;
+    stop_ = true;
+    writer_.join();
+    uint64_t dropped = dropped_count_.exchange(0);
+    if(dropped > 0)
+    {
+        fprintf(file_, "Warning: %llu log messages dropped\n",
+                static_cast<unsigned long long>(dropped));
+    }
+    fclose(file_);
+    file_ = nullptr;
+}
+
+void Logger::write(LogLevel level, const char *format, va_list args)
+{
+    while(!buffer_.push(level, format, args))
+    {
+        if(!wait_if_full_)
+        {
+            dropped_count_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        std::this_thread::yield();
+    }
+}
+
+void Logger::flush()
+{
+    uint64_t target = buffer_.get_push_count();
+    while(file_ != nullptr && written_count_.load(std::memory_order_acquire) < target)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+uint64_t Logger::get_dropped_count() const
+{
+    return dropped_count_.load(std::memory_order_relaxed);
+}
+
+void Logger::run_writer()
+{
+    LogRecord record;
+    for(;;)
+    {
+        // Read stop before draining so messages logged before close are written
+        bool     stopping = stop_;
+        uint32_t count = 0;
+        while(buffer_.pop(record))
+        {
+            fputs(level_prefix(record.level), file_);
+            fwrite(record.text, 1, record.length, file_);
+            putc('\n', file_);
+            ++count;
+        }
+        if(count > 0)
+        {
+            fflush(file_);
+            written_count_.fetch_add(count, std::memory_order_release);
+        }
+        else if(stopping)
+        {
+            break;
+        }
+        else
+        {
+            std::this_thread::sleep_for(WRITER_IDLE_TIME);
+        }
+    }
+}
+
+Logger &get_logger()
+{
+    static Logger logger;
+    return logger;
+}
+
+void log_message(LogLevel level, const char *format, ...)
+{
+    if(!is_log_level_enabled(level)) return;
+    va_list args;
+    va_start(args, format);
+    get_logger().write(level, format, args);
+    va_end(args);
+}
+
+void log_message_v(LogLevel level, const char *format, va_list args)
+{
+    if(!is_log_level_enabled(level)) return;
+    get_logger().write(level, format, args);
+}
+
+} // namespace cg
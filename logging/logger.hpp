@@ -0,0 +1,159 @@
+///============================================================================
+//	Johns Hopkins University Engineering Programs for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  Brian Russin
+//	File:    logger.hpp
+//	Purpose: Asynchronous logging to a file.
+//============================================================================
+
+#ifndef __LOGGING_LOGGER_HPP__
+#define __LOGGING_LOGGER_HPP__
+
+#include "logging/log_ring_buffer.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+// Messages below this level are compiled out of the CG_LOG_* macros and dropped
+// by log_message (0 = debug, 1 = info, 2 = warning, 3 = error)
+#ifndef CG_LOG_LEVEL
+#define CG_LOG_LEVEL 1
+#endif
+
+namespace cg
+{
+
+/**
+ * Asynchronous file logger. Callers format their message into a lock-free
+ * ring buffer and return; a writer thread writes the messages to the file
+ * and flushes once per batch. When the buffer is full, messages are dropped
+ * (and counted) unless the logger was opened to wait, so logging never
+ * stalls a frame.
+ */
+class Logger
+{
+  public:
+    /**
+     * Constructor.
+     * @param  capacity  Number of messages the buffer holds.
+     */
+    explicit Logger(uint32_t capacity = 4096);
+
+    /**
+     * Destructor. Writes any queued messages and closes the file.
+     */
+    ~Logger();
+
+    Logger(const Logger &) = delete;
+    Logger &operator=(const Logger &) = delete;
+
+    /**
+     * Open the log file and start the writer thread. Messages logged before
+     * open are kept (up to the buffer capacity).
+     * @param  filename       Log file.
+     * @param  wait_if_full   Wait for space instead of dropping messages when
+     *                        the buffer is full (for tests that need every line).
+     * @return  Returns true if the file was opened.
+     */
+    bool open(const std::string &filename, bool wait_if_full = false);
+
+    /**
+     * Write all queued messages, stop the writer and close the file. Reports
+     * the number of dropped messages to the file.
+     */
+    void close();
+
+    /**
+     * Log a message. Safe to call from any thread.
+     * @param  level   Log level.
+     * @param  format  printf style format.
+     * @param  args    Format arguments.
+     */
+    void write(LogLevel level, const char *format, va_list args);
+
+    /**
+     * Wait until all messages logged before the call are in the file.
+     */
+    void flush();
+
+    /**
+     * Get the number of messages dropped because the buffer was full.
+     * @return  Returns the dropped count.
+     */
+    uint64_t get_dropped_count() const;
+
+  protected:
+    LogRingBuffer         buffer_;
+    FILE                 *file_;
+    std::atomic<bool>     wait_if_full_; // Only set while the writer is running
+    std::atomic<bool>     stop_;
+    std::atomic<uint64_t> written_count_; // Records written and flushed to the file
+    std::atomic<uint64_t> dropped_count_;
+    std::thread           writer_;
+
+    void run_writer();
+};
+
+/**
+ * Get the logger shared by the application.
+ * @return  Returns the logger.
+ */
+Logger &get_logger();
+
+/**
+ * Whether messages of a level are logged (those below CG_LOG_LEVEL are not).
+ * @param  level  Log level.
+ * @return  Returns true if the level is logged.
+ */
+constexpr bool is_log_level_enabled(LogLevel level)
+{
+    return static_cast<int>(level) >= CG_LOG_LEVEL;
+}
+
+/**
+ * Log a message to the shared logger if its level is enabled. Messages longer
+ * than LOG_MESSAGE_SIZE - 1 characters are truncated and end in "...".
+ * @param  level   Log level.
+ * @param  format  printf style format.
+ */
+void log_message(LogLevel level, const char *format, ...);
+
+/**
+ * Log a message to the shared logger if its level is enabled (see log_message).
+ * @param  level   Log level.
+ * @param  format  printf style format.
+ * @param  args    Format arguments.
+ */
+void log_message_v(LogLevel level, const char *format, va_list args);
+
+} // namespace cg
+
+#if CG_LOG_LEVEL <= 0
+#define CG_LOG_DEBUG(...) ::cg::log_message(::cg::LogLevel::DEBUG, __VA_ARGS__)
+#else
+#define CG_LOG_DEBUG(...) ((void)0)
+#endif
+
+#if CG_LOG_LEVEL <= 1
+#define CG_LOG_INFO(...) ::cg::log_message(::cg::LogLevel::INFO, __VA_ARGS__)
+#else
+#define CG_LOG_INFO(...) ((void)0)
+#endif
+
+#if CG_LOG_LEVEL <= 2
+#define CG_LOG_WARNING(...) ::cg::log_message(::cg::LogLevel::WARNING, __VA_ARGS__)
+#else
+#define CG_LOG_WARNING(...) ((void)0)
+#endif
+
+#if CG_LOG_LEVEL <= 3
+#define CG_LOG_ERROR(...) ::cg::log_message(::cg::LogLevel::ERR, __VA_ARGS__)
+#else
+#define CG_LOG_ERROR(...) ((void)0)
+#endif
+
+#endif
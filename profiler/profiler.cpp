@@ -0,0 +1,148 @@
+
+
+#include "profiler/profiler.hpp"
+
+#ifdef CG_ENABLE_PROFILER
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace cg
+{
+
+// Zones kept per thread per capture; later zones are dropped
+static constexpr uint32_t MAX_THREAD_ZONES = 1 << 18;
+
+struct ProfileZone
+{
+    const char *name;
+    uint64_t    start_ns;
+    uint64_t    duration_ns;
+};
+
+// Zones recorded by one thread. Only the owning thread appends; count is
+// published with release so the writer sees complete zones.
+struct ProfileThreadBuffer
+{
+    uint32_t                  thread_id;
+    std::vector<ProfileZone>  zones;
+    std::atomic<uint32_t>     count{0};
+    std::atomic<uint64_t>     dropped{0};
+};
+
+static std::mutex                                        g_buffers_mutex; // Guards g_buffers
+static std::vector<std::unique_ptr<ProfileThreadBuffer>> g_buffers;
+static std::atomic<bool>                                 g_capture_running{false};
+static std::atomic<uint64_t>                             g_capture_start_ns{0};
+
+static uint64_t now_ns()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+}
+
+// The calling thread's buffer, registered on first use
+static ProfileThreadBuffer &get_thread_buffer()
+{
+    thread_local ProfileThreadBuffer *buffer = nullptr;
+    if(buffer == nullptr)
+    {
+        auto new_buffer = std::make_unique<ProfileThreadBuffer>();
+        new_buffer->zones.resize(MAX_THREAD_ZONES);
+        std::lock_guard<std::mutex> lock(g_buffers_mutex);
+        new_buffer->thread_id = static_cast<uint32_t>(g_buffers.size()) + 1;
+        buffer = new_buffer.get();
+        g_buffers.push_back(std::move(new_buffer));
+    }
+    return *buffer;
+}
+
+ProfileScope::ProfileScope(const char *name)
+    : name_(name), start_ns_(g_capture_running.load(std::memory_order_relaxed) ? now_ns() : 0)
+{
+}
+
+ProfileScope::~ProfileScope()
+{
+    if(start_ns_ == 0 || !g_capture_running.load(std::memory_order_relaxed)) return;
+
+    uint64_t             end_ns = now_ns();
+    ProfileThreadBuffer &buffer = get_thread_buffer();
+    uint32_t             index = buffer.count.load(std::memory_order_relaxed);
+    if(index >= MAX_THREAD_ZONES)
+    {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer.zones[index] = {name_, start_ns_, end_ns - start_ns_};
+    buffer.count.store(index + 1, std::memory_order_release);
+}
+
+void start_profile_capture()
+{
+    {
+        std::lock_guard<std::mutex> lock(g_buffers_mutex);
+        for(auto &buffer : g_buffers)
+        {
+            buffer->count.store(0, std::memory_order_relaxed);
+            buffer->dropped.store(0, std::memory_order_relaxed);
+        }
+    }
+    g_capture_start_ns = now_ns();
+    g_capture_running = true;
+}
+
+void stop_profile_capture() { g_capture_running = false; }
+
+bool is_profile_capture_running() { return g_capture_running; }
+
+bool write_profile_trace(const std::string &filename)
+{
+    FILE *file = fopen(filename.c_str(), "w");
+    if(file == nullptr) return false;
+
+    // Complete ("X") events with times in microseconds from the capture start
+    uint64_t capture_start_ns = g_capture_start_ns;
+    bool     first = true;
+    fputs("{\"traceEvents\":[\n", file);
+    std::lock_guard<std::mutex> lock(g_buffers_mutex);
+    for(const auto &buffer : g_buffers)
+    {
+        fprintf(file,
+                "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                "\"args\":{\"name\":\"Thread %u\"}}",
+                first ? "" : ",\n", buffer->thread_id, buffer->thread_id);
+        first = false;
+
+        uint32_t count = buffer->count.load(std::memory_order_acquire);
+        for(uint32_t i = 0; i < count; ++i)
+        {
+            const ProfileZone &zone = buffer->zones[i];
+            if(zone.start_ns < capture_start_ns) continue;
+            fprintf(file,
+                    ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,"
+                    "\"dur\":%.3f}",
+                    zone.name, buffer->thread_id, (zone.start_ns - capture_start_ns) * 0.001,
+                    zone.duration_ns * 0.001);
+        }
+        uint64_t dropped = buffer->dropped.load(std::memory_order_relaxed);
+        if(dropped > 0)
+        {
+            fprintf(file,
+                    ",\n{\"name\":\"%llu zones dropped\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,"
+                    "\"tid\":%u,\"ts\":0}",
+                    static_cast<unsigned long long>(dropped), buffer->thread_id);
+        }
+    }
+    fputs("\n]}\n", file);
+    return fclose(file) == 0;
+}
+
+} // namespace cg
+
+#endif
@@ -0,0 +1,92 @@
+///============================================================================
+//	Johns Hopkins University Engineering Programs for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  Brian Russin
+//	File:    profiler.hpp
+//	Purpose: Scoped CPU timing zones exported as Chrome trace events.
+//============================================================================
+
+#ifndef __PROFILER_PROFILER_HPP__
+#define __PROFILER_PROFILER_HPP__
+
+// Instrumentation is only compiled when CG_ENABLE_PROFILER is defined
+// (cmake -DCG_ENABLE_PROFILER=ON). Otherwise the macros expand to nothing
+// and none of the profiler is built.
+#ifdef CG_ENABLE_PROFILER
+
+#include <cstdint>
+#include <string>
+
+namespace cg
+{
+
+/**
+ * Records the time from construction to destruction as a zone on the
+ * calling thread while a capture is running. Each thread records into its
+ * own buffer, so recording takes no locks. Use CG_PROFILE_SCOPE.
+ */
+class ProfileScope
+{
+  public:
+    /**
+     * Constructor. Starts the zone.
+     * @param  name  Zone name. Must outlive the capture (use a string literal).
+     */
+    explicit ProfileScope(const char *name);
+
+    /**
+     * Destructor. Ends the zone.
+     */
+    ~ProfileScope();
+
+    ProfileScope(const ProfileScope &) = delete;
+    ProfileScope &operator=(const ProfileScope &) = delete;
+
+  protected:
+    const char *name_;
+    uint64_t    start_ns_; // 0 if no capture was running at construction
+};
+
+/**
+ * Start a capture, discarding any zones from an earlier capture. Call when
+ * no zones are open on other threads.
+ */
+void start_profile_capture();
+
+/**
+ * Stop the capture. Zones still open are not recorded.
+ */
+void stop_profile_capture();
+
+/**
+ * Check if a capture is running.
+ * @return  Returns true if zones are being recorded.
+ */
+bool is_profile_capture_running();
+
+/**
+ * Write the zones of the last capture as Chrome trace-event JSON (open it in
+ * chrome://tracing or Perfetto). Call after stop_profile_capture.
+ * @param  filename  Output file.
+ * @return  Returns true if the file was written.
+ */
+bool write_profile_trace(const std::string &filename);
+
+} // namespace cg
+
+#define CG_PROFILE_CONCAT_INNER(a, b) a##b
+#define CG_PROFILE_CONCAT(a, b) CG_PROFILE_CONCAT_INNER(a, b)
+
+// Time the rest of the enclosing scope as a zone called name
+#define CG_PROFILE_SCOPE(name)                                                                     \
+    ::cg::ProfileScope CG_PROFILE_CONCAT(cg_profile_scope_, __LINE__)(name)
+
+#else
+
+#define CG_PROFILE_SCOPE(name)
+
+#endif
+
+#endif
@@ -9,4 +9,14 @@ GeometryNode::~GeometryNode() {}
 
 void GeometryNode::draw(SceneState &scene_state) {}
 
+void GeometryNode::set_bounds(const BoundingSphere &sphere, const AABB &box)
+{
+    local_sphere_ = sphere;
+    local_aabb_ = box;
+    has_bounds_ = true;
+    mark_bounds_dirty();
+}
+
+void GeometryNode::compute_local_bounds() {}
+
 } // namespace cg
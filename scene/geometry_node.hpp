@@ -38,6 +38,20 @@ class GeometryNode : public SceneNode
      * @param  scene_state  Current scene state
      */
     virtual void draw(SceneState &scene_state) override;
+
+    /**
+     * Set the bounding volumes (object coordinates) of this geometry. Geometry
+     * without bounds is never culled, nor is any subtree containing it.
+     * @param  sphere  Bounding sphere
+     * @param  box     Axis aligned bounding box
+     */
+    void set_bounds(const BoundingSphere &sphere, const AABB &box);
+
+  protected:
+    /**
+     * Geometry bounds are set explicitly, nothing to compute.
+     */
+    void compute_local_bounds() override;
 };
 
 } // namespace cg
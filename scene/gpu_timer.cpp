@@ -0,0 +1,67 @@
+#include "scene/gpu_timer.hpp"
+
+namespace cg
+{
+
+GpuTimer::GpuTimer() : frame_(0), active_(false), elapsed_ms_(-1.0f)
+{
+    for(uint32_t i = 0; i < GPU_TIMER_FRAMES; ++i)
+    {
+        queries_[i][0] = queries_[i][1] = 0;
+        pending_[i] = false;
+    }
+}
+
+GpuTimer::~GpuTimer()
+{
+    if(queries_[0][0] != 0) glDeleteQueries(GPU_TIMER_FRAMES * 2, &queries_[0][0]);
+}
+
+void GpuTimer::begin()
+{
+    // Create the queries on first use so the timer can be built before a context exists
+    if(queries_[0][0] == 0) glGenQueries(GPU_TIMER_FRAMES * 2, &queries_[0][0]);
+
+    collect();
+    uint32_t index = frame_ % GPU_TIMER_FRAMES;
+    active_ = !pending_[index];
+    if(active_) glQueryCounter(queries_[index][0], GL_TIMESTAMP);
+}
+
+void GpuTimer::end()
+{
+    if(!active_) return;
+
+    uint32_t index = frame_ % GPU_TIMER_FRAMES;
+    glQueryCounter(queries_[index][1], GL_TIMESTAMP);
+    pending_[index] = true;
+    active_ = false;
+    ++frame_;
+}
+
+float GpuTimer::get_elapsed_ms() const { return elapsed_ms_; }
+
+void GpuTimer::collect()
+{
+    // Slot frame_ % GPU_TIMER_FRAMES holds the oldest frame (the one the next
+    // begin reuses), so walk forward from it and stop at the first unfinished one
+    for(uint32_t i = 0; i < GPU_TIMER_FRAMES; ++i)
+    {
+        uint32_t index = (frame_ + i) % GPU_TIMER_FRAMES;
+        if(!pending_[index]) continue;
+
+        // The end timestamp is written after the start one
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(queries_[index][1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if(available != GL_TRUE) break;
+
+        GLuint64 start = 0;
+        GLuint64 end = 0;
+        glGetQueryObjectui64v(queries_[index][0], GL_QUERY_RESULT, &start);
+        glGetQueryObjectui64v(queries_[index][1], GL_QUERY_RESULT, &end);
+        elapsed_ms_ = static_cast<float>(end - start) * 1.0e-6f;
+        pending_[index] = false;
+    }
+}
+
+} // namespace cg
@@ -0,0 +1,75 @@
+
+//============================================================================
+//	Johns Hopkins University Engineering Programs for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:	David W. Nesbitt
+//	File:    gpu_timer.hpp
+//	Purpose: GPU time of a span of GL commands using timer queries.
+//
+//============================================================================
+
+#ifndef __SCENE_GPU_TIMER_HPP__
+#define __SCENE_GPU_TIMER_HPP__
+
+#include "scene/graphics.hpp"
+
+namespace cg
+{
+
+// Frames of queries in flight. Results are read this many frames late, by
+// which time the GPU has finished them, so reading never stalls.
+constexpr uint32_t GPU_TIMER_FRAMES = 3;
+
+/**
+ * Measures the GPU time between begin and end once per frame. Uses a pair
+ * of GL_TIMESTAMP queries rather than GL_TIME_ELAPSED so timers can be
+ * nested (only one GL_TIME_ELAPSED query may be active at a time). Queries
+ * are triple buffered and results are only read once available; if the
+ * oldest query is still pending the frame is not timed rather than waiting.
+ */
+class GpuTimer
+{
+  public:
+    GpuTimer();
+
+    /**
+     * Destructor. Deletes the queries.
+     */
+    ~GpuTimer();
+
+    GpuTimer(const GpuTimer &) = delete;
+    GpuTimer &operator=(const GpuTimer &) = delete;
+
+    /**
+     * Start timing. Collects any finished earlier results.
+     */
+    void begin();
+
+    /**
+     * End timing.
+     */
+    void end();
+
+    /**
+     * Get the most recent result.
+     * @return  Returns the GPU time in milliseconds, or a negative value if
+     *          no result is available yet.
+     */
+    float get_elapsed_ms() const;
+
+  protected:
+    GLuint   queries_[GPU_TIMER_FRAMES][2]; // Start and end timestamp per frame
+    bool     pending_[GPU_TIMER_FRAMES];
+    uint32_t frame_;
+    bool     active_;
+    float    elapsed_ms_;
+
+    // Read results that are available, oldest first
+    void collect();
+};
+
+} // namespace cg
+
+#endif
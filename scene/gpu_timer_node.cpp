@@ -0,0 +1,26 @@
+#include "scene/gpu_timer_node.hpp"
+
+#include <chrono>
+
+namespace cg
+{
+
+GpuTimerNode::GpuTimerNode(const std::string &name) : name_(name), cpu_ms_(0.0f) {}
+
+void GpuTimerNode::draw(SceneState &scene_state)
+{
+    auto start = std::chrono::steady_clock::now();
+    timer_.begin();
+    SceneNode::draw(scene_state);
+    timer_.end();
+    cpu_ms_ = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start)
+                  .count();
+}
+
+const std::string &GpuTimerNode::get_name() const { return name_; }
+
+float GpuTimerNode::get_gpu_ms() const { return timer_.get_elapsed_ms(); }
+
+float GpuTimerNode::get_cpu_ms() const { return cpu_ms_; }
+
+} // namespace cg
@@ -0,0 +1,70 @@
+
+//============================================================================
+//	Johns Hopkins University Engineering Programs for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:	David W. Nesbitt
+//	File:    gpu_timer_node.hpp
+//	Purpose: Scene graph node that times drawing its subtree.
+//
+//============================================================================
+
+#ifndef __SCENE_GPU_TIMER_NODE_HPP__
+#define __SCENE_GPU_TIMER_NODE_HPP__
+
+#include "scene/gpu_timer.hpp"
+#include "scene/scene_node.hpp"
+
+#include <string>
+
+namespace cg
+{
+
+/**
+ * Times drawing its children: GPU time with a GpuTimer (a few frames late)
+ * and CPU time spent issuing the draw calls. Insert above a subtree, e.g. a
+ * ShaderNode, to see what it costs.
+ */
+class GpuTimerNode : public SceneNode
+{
+  public:
+    /**
+     * Constructor.
+     * @param  name  Name used when reporting the times.
+     */
+    explicit GpuTimerNode(const std::string &name);
+
+    /**
+     * Draw the children, timing them.
+     * @param  scene_state  Current scene state.
+     */
+    void draw(SceneState &scene_state) override;
+
+    /**
+     * Get the name of this timer.
+     * @return  Returns the name.
+     */
+    const std::string &get_name() const;
+
+    /**
+     * Get the GPU time of the most recent finished frame.
+     * @return  Returns the time in milliseconds (negative until available).
+     */
+    float get_gpu_ms() const;
+
+    /**
+     * Get the CPU time of the last draw.
+     * @return  Returns the time in milliseconds.
+     */
+    float get_cpu_ms() const;
+
+  protected:
+    std::string name_;
+    GpuTimer    timer_;
+    float       cpu_ms_;
+};
+
+} // namespace cg
+
+#endif
@@ -0,0 +1,99 @@
+#include "scene/mesh_node.hpp"
+
+#include "filesystem_support/asset_archive.hpp"
+#include "filesystem_support/file_locator.hpp"
+#include "filesystem_support/mapped_file.hpp"
+
+#include <iostream>
+
+namespace cg
+{
+
+MeshNode::MeshNode() : vao_(0), vbo_(0), ebo_(0), draw_count_(0), index_type_(0) {}
+
+MeshNode::~MeshNode() { destroy_buffers(); }
+
+bool MeshNode::load(const std::string &filename, int32_t position_loc, int32_t normal_loc)
+{
+    // Use a mounted asset archive if it holds the mesh, otherwise map the file
+    FileView   view;
+    MappedFile file;
+    if(!find_mounted_asset(filename, view))
+    {
+        auto file_info = locate_path_for_filename(filename);
+        if(!file_info.found || !file.open(file_info.file_path))
+        {
+            std::cout << "Could not find mesh file " << filename << '\n';
+            return false;
+        }
+        view = file.view();
+    }
+
+    CookedMeshView mesh;
+    if(!parse_cooked_mesh(view.data, view.size, mesh))
+    {
+        std::cout << "Invalid mesh file " << filename << '\n';
+        return false;
+    }
+    create(mesh, position_loc, normal_loc);
+    return true;
+}
+
+void MeshNode::create(const CookedMeshView &mesh, int32_t position_loc, int32_t normal_loc)
+{
+    destroy_buffers();
+    set_bounds(mesh.sphere, mesh.box);
+
+    glGenVertexArrays(1, &vao_);
+    glBindVertexArray(vao_);
+
+    // Vertex block is uploaded as is
+    glGenBuffers(1, &vbo_);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    glBufferData(GL_ARRAY_BUFFER, mesh.vertex_count * sizeof(VertexAndNormal), mesh.vertices,
+                 GL_STATIC_DRAW);
+    glVertexAttribPointer(position_loc, 3, GL_FLOAT, GL_FALSE, sizeof(VertexAndNormal), (void *)0);
+    glEnableVertexAttribArray(position_loc);
+    glVertexAttribPointer(normal_loc, 3, GL_FLOAT, GL_FALSE, sizeof(VertexAndNormal),
+                          (void *)(sizeof(Point3)));
+    glEnableVertexAttribArray(normal_loc);
+
+    // Index block, if any (the element buffer binding is stored in the VAO)
+    if(mesh.index_count > 0)
+    {
+        glGenBuffers(1, &ebo_);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.index_count * mesh.index_size, mesh.indices,
+                     GL_STATIC_DRAW);
+        index_type_ = (mesh.index_size == 2) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        draw_count_ = static_cast<GLsizei>(mesh.index_count);
+    }
+    else
+    {
+        index_type_ = 0;
+        draw_count_ = static_cast<GLsizei>(mesh.vertex_count);
+    }
+
+    glBindVertexArray(0);
+}
+
+void MeshNode::draw(SceneState &)
+{
+    glBindVertexArray(vao_);
+    if(index_type_ != 0)
+        glDrawElements(GL_TRIANGLES, draw_count_, index_type_, (void *)0);
+    else
+        glDrawArrays(GL_TRIANGLES, 0, draw_count_);
+    glBindVertexArray(0);
+}
+
+void MeshNode::destroy_buffers()
+{
+    if(ebo_ != 0) glDeleteBuffers(1, &ebo_);
+    if(vbo_ != 0) glDeleteBuffers(1, &vbo_);
+    if(vao_ != 0) glDeleteVertexArrays(1, &vao_);
+    vao_ = vbo_ = ebo_ = 0;
+    draw_count_ = 0;
+}
+
+} // namespace cg
@@ -0,0 +1,77 @@
+//============================================================================
+//	Johns Hopkins University Engineering Programs for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:	 David W. Nesbitt
+//	File:    mesh_node.hpp
+//	Purpose: Geometry node that draws a cooked (binary) mesh.
+//
+//============================================================================
+
+#ifndef __SCENE_MESH_NODE_HPP__
+#define __SCENE_MESH_NODE_HPP__
+
+#include "scene/geometry_node.hpp"
+
+#include "geometry/cooked_mesh.hpp"
+
+#include <string>
+
+namespace cg
+{
+
+/**
+ * Mesh geometry node. Loads a cooked mesh file (from a mounted asset archive
+ * or the filesystem) by mapping it and uploading the vertex and index blocks
+ * directly to buffer objects. Bounds come from the file.
+ */
+class MeshNode : public GeometryNode
+{
+  public:
+    /**
+     * Constructor.
+     */
+    MeshNode();
+
+    /**
+     * Destructor. Cleans up OpenGL resources.
+     */
+    ~MeshNode();
+
+    /**
+     * Load a cooked mesh file.
+     * @param  filename      Cooked mesh file name.
+     * @param  position_loc  Shader attribute location for vertex positions
+     * @param  normal_loc    Shader attribute location for vertex normals
+     * @return  Returns true if the mesh was loaded.
+     */
+    bool load(const std::string &filename, int32_t position_loc, int32_t normal_loc);
+
+    /**
+     * Create the mesh from a cooked mesh view.
+     * @param  mesh          Cooked mesh.
+     * @param  position_loc  Shader attribute location for vertex positions
+     * @param  normal_loc    Shader attribute location for vertex normals
+     */
+    void create(const CookedMeshView &mesh, int32_t position_loc, int32_t normal_loc);
+
+    /**
+     * Draw the mesh. Geometry nodes are leaf nodes.
+     * @param scene_state  Current scene state
+     */
+    void draw(SceneState &scene_state) override;
+
+  protected:
+    GLuint  vao_;
+    GLuint  vbo_;
+    GLuint  ebo_;
+    GLsizei draw_count_; // Number of indices (or vertices if not indexed)
+    GLenum  index_type_; // GL_UNSIGNED_SHORT, GL_UNSIGNED_INT, or 0 if not indexed
+
+    void destroy_buffers();
+};
+
+} // namespace cg
+
+#endif
@@ -0,0 +1,63 @@
+#include "scene/noise_texture.hpp"
+
+namespace cg
+{
+
+NoiseTexture::NoiseTexture() : texture_(0), target_(GL_TEXTURE_2D) {}
+
+NoiseTexture::~NoiseTexture() { destroy(); }
+
+bool NoiseTexture::create(const NoiseVolume &volume)
+{
+    destroy();
+    if(volume.sample_count() == 0) return false;
+
+    bool   is_float = volume.format == NoiseFormat::FLOAT32;
+    GLint  internal_format = is_float ? GL_R32F : GL_RGBA8;
+    GLenum format = is_float ? GL_RED : GL_RGBA;
+    GLenum type = is_float ? GL_FLOAT : GL_UNSIGNED_BYTE;
+    target_ = (volume.depth > 1) ? GL_TEXTURE_3D : GL_TEXTURE_2D;
+
+    glGenTextures(1, &texture_);
+    if(texture_ == 0) return false;
+    glBindTexture(target_, texture_);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, is_float ? 4 : 1);
+    if(target_ == GL_TEXTURE_3D)
+    {
+        glTexImage3D(target_, 0, internal_format, volume.width, volume.height, volume.depth, 0,
+                     format, type, volume.data());
+        glTexParameteri(target_, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    }
+    else
+    {
+        glTexImage2D(target_, 0, internal_format, volume.width, volume.height, 0, format, type,
+                     volume.data());
+    }
+    glTexParameteri(target_, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(target_, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(target_, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(target_, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(target_, 0);
+    return glGetError() == GL_NO_ERROR;
+}
+
+void NoiseTexture::bind(uint32_t unit) const
+{
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(target_, texture_);
+}
+
+void NoiseTexture::destroy()
+{
+    if(texture_ != 0)
+    {
+        glDeleteTextures(1, &texture_);
+        texture_ = 0;
+    }
+}
+
+GLuint NoiseTexture::get_texture() const { return texture_; }
+
+GLenum NoiseTexture::get_target() const { return target_; }
+
+} // namespace cg
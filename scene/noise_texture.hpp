@@ -0,0 +1,81 @@
+//============================================================================
+//	Johns Hopkins University Engineering Programs for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:	 David W. Nesbitt
+//	File:    noise_texture.hpp
+//	Purpose: OpenGL texture created from a baked noise volume.
+//
+//============================================================================
+
+#ifndef __SCENE_NOISE_TEXTURE_HPP__
+#define __SCENE_NOISE_TEXTURE_HPP__
+
+#include "scene/graphics.hpp"
+
+#include "geometry/noise_baker.hpp"
+
+namespace cg
+{
+
+/**
+ * OpenGL texture holding a baked noise volume. Volumes with depth 1 become
+ * 2D textures, others 3D textures. FLOAT32 volumes use a single red channel.
+ */
+class NoiseTexture
+{
+  public:
+    /**
+     * Constructor.
+     */
+    NoiseTexture();
+
+    /**
+     * Destructor. Deletes the texture.
+     */
+    ~NoiseTexture();
+
+    NoiseTexture(const NoiseTexture &) = delete;
+    NoiseTexture &operator=(const NoiseTexture &) = delete;
+
+    /**
+     * Create (or replace) the texture from a noise volume. Requires a current
+     * GL context. Uses linear filtering and clamps to the edge (baked noise
+     * does not tile, so repeating would show seams).
+     * @param  volume  Baked noise volume.
+     * @return  Returns true if the texture was created.
+     */
+    bool create(const NoiseVolume &volume);
+
+    /**
+     * Bind the texture to a texture unit.
+     * @param  unit  Texture unit (0 based).
+     */
+    void bind(uint32_t unit) const;
+
+    /**
+     * Delete the texture.
+     */
+    void destroy();
+
+    /**
+     * Get the texture object.
+     * @return  Returns the texture (0 if not created).
+     */
+    GLuint get_texture() const;
+
+    /**
+     * Get the texture target.
+     * @return  Returns GL_TEXTURE_2D or GL_TEXTURE_3D.
+     */
+    GLenum get_target() const;
+
+  protected:
+    GLuint texture_;
+    GLenum target_;
+};
+
+} // namespace cg
+
+#endif
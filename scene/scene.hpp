@@ -24,6 +24,10 @@
 #include "scene/geometry_node.hpp"
 #include "scene/shader_node.hpp"
 #include "scene/camera_node.hpp"
+#include "scene/noise_texture.hpp"
+#include "scene/mesh_node.hpp"
+#include "scene/gpu_timer.hpp"
+#include "scene/gpu_timer_node.hpp"
 // clang-format on
 
 namespace cg
@@ -1,5 +1,9 @@
 #include "scene/scene_node.hpp"
 
+#include "profiler/profiler.hpp"
+
+#include <algorithm>
+
 namespace cg
 {
 
@@ -18,25 +22,160 @@ std::ostream &operator<<(std::ostream &out, const SceneNodeType &type)
     return out;
 }
 
-SceneNode::SceneNode() : node_type_(SceneNodeType::BASE) {}
+SceneNode::SceneNode() : node_type_(SceneNodeType::BASE), bounds_dirty_(true), has_bounds_(false)
+{
+}
 
 SceneNode::~SceneNode() { destroy(); }
 
 void SceneNode::draw(SceneState &scene_state)
 {
-    // Loop through the list and draw the children
-    for(auto c : children_) { c->draw(scene_state); }
+    CG_PROFILE_SCOPE("SceneNode::draw");
+
+    // Loop through the list and draw the children that are not culled. Once a
+    // subtree is known to be inside the frustum its descendants are not tested.
+    for(auto &c : children_)
+    {
+        FrustumTestResult result = c->frustum_test(scene_state);
+        if(result == FrustumTestResult::OUTSIDE) continue;
+
+        if(result == FrustumTestResult::INSIDE && !scene_state.inside_frustum)
+        {
+            scene_state.inside_frustum = true;
+            c->draw(scene_state);
+            scene_state.inside_frustum = false;
+        }
+        else c->draw(scene_state);
+    }
 }
 
 void SceneNode::update(SceneState &scene_state)
 {
+    CG_PROFILE_SCOPE("SceneNode::update");
+
     // Loop through the list and update the children
     for(auto c : children_) { c->update(scene_state); }
 }
 
-void SceneNode::destroy() { children_.clear(); }
+FrustumTestResult SceneNode::frustum_test(SceneState &scene_state)
+{
+    FrustumTestResult result = FrustumTestResult::INTERSECT;
+    if(scene_state.frustum_culling)
+    {
+        if(scene_state.inside_frustum) result = FrustumTestResult::INSIDE;
+        else if(has_bounds())
+        {
+            // Test the sphere first, the tighter box only if the sphere straddles a plane
+            ++scene_state.cull_tests;
+            result = scene_state.frustum.test(scene_state.model_matrix * parent_sphere_);
+            if(result == FrustumTestResult::INTERSECT)
+                result = scene_state.frustum.test(scene_state.model_matrix * parent_aabb_);
+        }
+    }
+
+    if(result == FrustumTestResult::OUTSIDE) ++scene_state.nodes_culled;
+    else if(node_type_ == SceneNodeType::GEOMETRY) ++scene_state.nodes_drawn;
+    return result;
+}
+
+void SceneNode::mark_bounds_dirty()
+{
+    // Ancestors of a dirty node are always dirty, so stop when one is found
+    if(bounds_dirty_) return;
+    bounds_dirty_ = true;
+    for(auto p : parents_) p->mark_bounds_dirty();
+}
+
+bool SceneNode::has_bounds()
+{
+    update_bounds();
+    return has_bounds_;
+}
+
+const BoundingSphere &SceneNode::get_bounding_sphere()
+{
+    update_bounds();
+    return local_sphere_;
+}
+
+const AABB &SceneNode::get_aabb()
+{
+    update_bounds();
+    return local_aabb_;
+}
+
+BoundingSphere SceneNode::get_world_bounding_sphere(const Matrix4x4 &parent_matrix)
+{
+    update_bounds();
+    return parent_matrix * parent_sphere_;
+}
+
+AABB SceneNode::get_world_aabb(const Matrix4x4 &parent_matrix)
+{
+    update_bounds();
+    return parent_matrix * parent_aabb_;
+}
+
+void SceneNode::update_bounds()
+{
+    if(!bounds_dirty_) return;
+
+    compute_local_bounds();
+    const Matrix4x4 *m = local_transform();
+    if(m != nullptr)
+    {
+        parent_sphere_ = *m * local_sphere_;
+        parent_aabb_ = *m * local_aabb_;
+    }
+    else
+    {
+        parent_sphere_ = local_sphere_;
+        parent_aabb_ = local_aabb_;
+    }
+    bounds_dirty_ = false;
+}
 
-void SceneNode::add_child(std::shared_ptr<SceneNode> node) { children_.push_back(node); }
+void SceneNode::compute_local_bounds()
+{
+    // Bounded only if there are children and all of them are bounded
+    has_bounds_ = !children_.empty();
+    local_aabb_ = AABB();
+    for(size_t i = 0; i < children_.size() && has_bounds_; ++i)
+    {
+        SceneNode *c = children_[i].get();
+        c->update_bounds();
+        if(!c->has_bounds_)
+        {
+            has_bounds_ = false;
+            break;
+        }
+
+        if(i == 0) local_sphere_ = c->parent_sphere_;
+        else local_sphere_.merge_with(c->parent_sphere_);
+        local_aabb_.merge(c->parent_aabb_);
+    }
+}
+
+const Matrix4x4 *SceneNode::local_transform() const { return nullptr; }
+
+void SceneNode::destroy()
+{
+    for(auto &c : children_)
+    {
+        auto &p = c->parents_;
+        auto  parent = std::find(p.begin(), p.end(), this);
+        if(parent != p.end()) p.erase(parent);
+    }
+    children_.clear();
+    mark_bounds_dirty();
+}
+
+void SceneNode::add_child(std::shared_ptr<SceneNode> node)
+{
+    node->parents_.push_back(this);
+    children_.push_back(node);
+    mark_bounds_dirty();
+}
 
 SceneNodeType SceneNode::node_type() const { return node_type_; }
 
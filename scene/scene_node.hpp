@@ -16,6 +16,10 @@
 #include "scene/graphics.hpp"
 #include "scene/scene_state.hpp"
 
+#include "geometry/aabb.hpp"
+#include "geometry/bounding_sphere.hpp"
+#include "geometry/frustum.hpp"
+
 #include <iostream>
 #include <memory>
 #include <string>
@@ -66,6 +70,60 @@ class SceneNode
      */
     virtual void update(SceneState &scene_state);
 
+    /**
+     * Test this node's subtree bounds against the view frustum. Called by the
+     * parent during draw traversal, with the parent's modeling matrix current
+     * in the scene state, so a single test can reject a whole subtree. Nodes
+     * without bounds always return INTERSECT so their children are tested.
+     * @param  scene_state  Current scene state
+     * @return  Returns OUTSIDE if the subtree can be skipped, INSIDE if no
+     *          descendants need to be tested.
+     */
+    FrustumTestResult frustum_test(SceneState &scene_state);
+
+    /**
+     * Mark the bounds of this node and all of its ancestors out of date. The
+     * bounds are recomputed lazily the next time they are needed.
+     */
+    void mark_bounds_dirty();
+
+    /**
+     * Does this subtree have bounds? A subtree is bounded only if every
+     * descendant leaf is bounded.
+     * @return  Returns true if the subtree is bounded.
+     */
+    bool has_bounds();
+
+    /**
+     * Get the bounding sphere of this subtree in the node's own (local)
+     * coordinate frame. Recomputes from the children if out of date.
+     * @return  Returns the local bounding sphere.
+     */
+    const BoundingSphere &get_bounding_sphere();
+
+    /**
+     * Get the axis aligned bounding box of this subtree in the node's own
+     * (local) coordinate frame. Recomputes from the children if out of date.
+     * @return  Returns the local bounding box.
+     */
+    const AABB &get_aabb();
+
+    /**
+     * Get the bounding sphere of this subtree in world coordinates. Nodes can
+     * be shared by several parents, so the accumulated modeling matrix of the
+     * parent is supplied.
+     * @param  parent_matrix  Composite modeling matrix of the parent.
+     * @return  Returns the world bounding sphere.
+     */
+    BoundingSphere get_world_bounding_sphere(const Matrix4x4 &parent_matrix);
+
+    /**
+     * Get the axis aligned bounding box of this subtree in world coordinates.
+     * @param  parent_matrix  Composite modeling matrix of the parent.
+     * @return  Returns the world bounding box.
+     */
+    AABB get_world_aabb(const Matrix4x4 &parent_matrix);
+
     /**
      * Destroy all the children
      */
@@ -101,6 +159,32 @@ class SceneNode
     std::string                             name_;
     SceneNodeType                           node_type_;
     std::vector<std::shared_ptr<SceneNode>> children_;
+    std::vector<SceneNode *>                parents_; // Non-owning, for dirty propagation
+
+    // Bounds of the subtree. Local bounds are in this node's coordinate frame,
+    // parent bounds have this node's transform (if any) applied.
+    bool           bounds_dirty_;
+    bool           has_bounds_;
+    BoundingSphere local_sphere_;
+    AABB           local_aabb_;
+    BoundingSphere parent_sphere_;
+    AABB           parent_aabb_;
+
+    /**
+     * Recompute bounds if they are out of date.
+     */
+    void update_bounds();
+
+    /**
+     * Compute the local bounds. The base class merges the bounds of the children.
+     */
+    virtual void compute_local_bounds();
+
+    /**
+     * Get the transform this node applies to its children.
+     * @return  Returns the local transform, or nullptr if the node has none.
+     */
+    virtual const Matrix4x4 *local_transform() const;
 };
 
 } // namespace cg
@@ -7,6 +7,11 @@ void SceneState::init()
 {
     model_matrix.set_identity();
     model_matrix_stack.clear();
+    frustum.set(pv);
+    inside_frustum = false;
+    cull_tests = 0;
+    nodes_drawn = 0;
+    nodes_culled = 0;
 }
 
 void SceneState::push_transforms() { model_matrix_stack.push_back(model_matrix); }
@@ -12,6 +12,7 @@
 #ifndef __SCENE_SCENE_STATE_HPP__
 #define __SCENE_SCENE_STATE_HPP__
 
+#include "geometry/frustum.hpp"
 #include "geometry/matrix.hpp"
 #include "scene/graphics.hpp"
 
@@ -52,8 +53,17 @@ struct SceneState
     // Retained state to push/pop modeling matrix
     std::list<Matrix4x4> model_matrix_stack;
 
+    // View frustum culling. The frustum is rebuilt from pv in init().
+    Frustum  frustum;                // Current view frustum (world coordinates)
+    bool     frustum_culling = true; // Cull nodes outside the view frustum
+    bool     inside_frustum = false; // Current subtree is entirely inside the frustum
+    uint32_t cull_tests = 0;         // Frustum tests performed this frame
+    uint32_t nodes_drawn = 0;        // Geometry nodes drawn this frame
+    uint32_t nodes_culled = 0;       // Subtrees culled this frame
+
     /**
-     * Initialize scene state prior to drawing.
+     * Initialize scene state prior to drawing. Rebuilds the view frustum from
+     * the current pv matrix and resets the culling statistics.
      */
     void init();
 
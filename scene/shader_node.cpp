@@ -1,63 +1,223 @@
 #include "scene/shader_node.hpp"
 
+#include "filesystem_support/asset_archive.hpp"
+#include "filesystem_support/file_locator.hpp"
+#include "shader_support/program_cache.hpp"
+
+#include <chrono>
+#include <algorithm>
 #include <iostream>
 
 namespace cg
 {
 
-ShaderNode::ShaderNode() { node_type_ = SceneNodeType::SHADER; }
-
-ShaderNode::~ShaderNode() {}
+static float elapsed_ms(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
+}
 
-bool ShaderNode::create(const char *vertex_shader_filename, const char *fragment_shader_filename)
+ShaderNode::ShaderNode() : watcher_(nullptr), reload_requested_(false), reload_pending_(false)
 {
-    // Create and compile the vertex shader
-    if(!vertex_shader_.create(vertex_shader_filename))
-    {
-        std::cout << "Vertex Shader compile failed\n";
-        return false;
-    }
+    node_type_ = SceneNodeType::SHADER;
+}
 
-    // Create and compile the fragment shader
-    if(!fragment_shader_.create(fragment_shader_filename))
+ShaderNode::~ShaderNode()
+{
+    if(watcher_ != nullptr)
     {
-        std::cout << "Fragment Shader compile failed\n";
-        return false;
+        for(uint32_t id : watch_ids_) watcher_->unwatch(id);
     }
+}
 
-    shader_program_.create();
-    if(!shader_program_.attach_shaders(vertex_shader_.get(), fragment_shader_.get()))
+bool ShaderNode::create(const char          *vertex_shader_filename,
+                        const char          *fragment_shader_filename,
+                        const ShaderDefines &defines)
+{
+    auto vertex_variant = get_shader_variant(vertex_shader_filename, defines);
+    auto fragment_variant = get_shader_variant(fragment_shader_filename, defines);
+    if(vertex_variant == nullptr || fragment_variant == nullptr)
     {
-        std::cout << "Shader program link failed\n";
+        std::cout << "Shader source not found\n";
         return false;
     }
-    return true;
+    vertex_filename_ = vertex_shader_filename;
+    fragment_filename_ = fragment_shader_filename;
+    defines_ = defines;
+    return create_program(*vertex_variant, *fragment_variant);
 }
 
 bool ShaderNode::create_from_source(const char *vertex_shader_source,
                                     const char *fragment_shader_source)
 {
+    // Sources given directly are not preprocessed or kept in the variant cache
+    vertex_filename_.clear();
+    fragment_filename_.clear();
+    ShaderVariant vertex_variant;
+    ShaderVariant fragment_variant;
+    vertex_variant.source = vertex_shader_source;
+    fragment_variant.source = fragment_shader_source;
+    return create_program(vertex_variant, fragment_variant);
+}
+
+bool ShaderNode::create_program(ShaderVariant &vertex_variant, ShaderVariant &fragment_variant)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    shader_program_.create();
+
+    // Link from the cached binary when the sources and driver are unchanged
+    uint64_t key = 0;
+    if(is_program_cache_enabled())
+    {
+        float build_ms = 0.0f;
+        key = program_cache_key({vertex_variant.source.data(), vertex_variant.source.size()},
+                                {fragment_variant.source.data(), fragment_variant.source.size()});
+        if(load_cached_program(key, shader_program_, build_ms))
+        {
+            float load_ms = elapsed_ms(t0);
+            std::cout << "Program cache hit: loaded in " << load_ms << " ms, saved "
+                      << build_ms - load_ms << " ms\n";
+            return true;
+        }
+        std::cout << "Program cache miss: compiling from source\n";
+    }
+
     // Create and compile the vertex shader
-    if(!vertex_shader_.create_from_source(vertex_shader_source))
+    if(!vertex_shader_.create(vertex_variant))
     {
         std::cout << "Vertex Shader compile failed\n";
         return false;
     }
 
     // Create and compile the fragment shader
-    if(!fragment_shader_.create_from_source(fragment_shader_source))
+    if(!fragment_shader_.create(fragment_variant))
     {
         std::cout << "Fragment Shader compile failed\n";
         return false;
     }
 
-    shader_program_.create();
     if(!shader_program_.attach_shaders(vertex_shader_.get(), fragment_shader_.get()))
     {
         std::cout << "Shader program link failed\n";
         return false;
     }
+
+    if(is_program_cache_enabled()) save_cached_program(key, shader_program_, elapsed_ms(t0));
     return true;
 }
 
+bool ShaderNode::enable_hot_reload(FileWatcher &watcher)
+{
+    if(vertex_filename_.empty() || fragment_filename_.empty()) return false;
+
+    // Let the driver compile reloads in the background when it can
+    enable_parallel_shader_compile();
+    watcher_ = &watcher;
+    return watch_source_files();
+}
+
+void ShaderNode::update(SceneState &scene_state)
+{
+    if(reload_requested_ && !reload_pending_) begin_reload();
+    if(reload_pending_ && reload_program_.is_link_complete()) finish_reload();
+    SceneNode::update(scene_state);
+}
+
+bool ShaderNode::watch_source_files()
+{
+    for(uint32_t id : watch_ids_) watcher_->unwatch(id);
+    watch_ids_.clear();
+
+    auto vertex_variant = get_shader_variant(vertex_filename_, defines_);
+    auto fragment_variant = get_shader_variant(fragment_filename_, defines_);
+    if(vertex_variant == nullptr || fragment_variant == nullptr) return false;
+
+    std::vector<std::string> files = vertex_variant->files;
+    files.insert(files.end(), fragment_variant->files.begin(), fragment_variant->files.end());
+    std::sort(files.begin(), files.end());
+    files.erase(std::unique(files.begin(), files.end()), files.end());
+    for(const auto &filename : files)
+    {
+        // Files in asset archives cannot change
+        FileView view;
+        if(find_mounted_asset(filename, view)) continue;
+
+        auto file_info = locate_path_for_filename(filename);
+        if(!file_info.found) continue;
+        uint32_t id = watcher_->watch(file_info.file_path,
+                                      [this, filename](const FileChange &change)
+                                      {
+                                          invalidate_shader_variants(filename);
+                                          if(!reload_requested_) reload_time_ = change.time;
+                                          reload_requested_ = true;
+                                      });
+        if(id != 0) watch_ids_.push_back(id);
+    }
+    return !watch_ids_.empty();
+}
+
+void ShaderNode::begin_reload()
+{
+    reload_requested_ = false;
+    reload_vertex_variant_ = get_shader_variant(vertex_filename_, defines_);
+    reload_fragment_variant_ = get_shader_variant(fragment_filename_, defines_);
+    if(reload_vertex_variant_ == nullptr || reload_fragment_variant_ == nullptr)
+    {
+        std::cout << "Shader reload failed: source not found. Keeping the current program\n";
+        return;
+    }
+
+    reload_vertex_shader_.begin_create(*reload_vertex_variant_);
+    reload_fragment_shader_.begin_create(*reload_fragment_variant_);
+    reload_program_.create();
+    reload_program_.begin_link(reload_vertex_shader_.get(), reload_fragment_shader_.get());
+    reload_pending_ = true;
+}
+
+void ShaderNode::finish_reload()
+{
+    reload_pending_ = false;
+    bool success = reload_vertex_shader_.finish_create(*reload_vertex_variant_) &&
+                   reload_fragment_shader_.finish_create(*reload_fragment_variant_) &&
+                   reload_program_.finish_link();
+    if(success)
+    {
+        // Swap in the new program. Keep the current one if the derived node
+        // cannot find its variables in the new program.
+        std::swap(shader_program_, reload_program_);
+        success = get_locations();
+        if(!success)
+        {
+            std::swap(shader_program_, reload_program_);
+            get_locations();
+        }
+    }
+    reload_program_.destroy();
+
+    if(success)
+    {
+        std::swap(vertex_shader_, reload_vertex_shader_);
+        std::swap(fragment_shader_, reload_fragment_shader_);
+        std::cout << "Shader program reloaded " << elapsed_ms(reload_time_)
+                  << " ms after the change\n";
+        if(is_program_cache_enabled())
+        {
+            const auto &vertex_source = reload_vertex_variant_->source;
+            const auto &fragment_source = reload_fragment_variant_->source;
+            uint64_t    key = program_cache_key({vertex_source.data(), vertex_source.size()},
+                                                {fragment_source.data(), fragment_source.size()});
+            save_cached_program(key, shader_program_, elapsed_ms(reload_time_));
+        }
+
+        // Includes may have been added or removed
+        watch_source_files();
+    }
+    else
+    {
+        std::cout << "Shader reload failed. Keeping the current program\n";
+    }
+    reload_vertex_variant_.reset();
+    reload_fragment_variant_.reset();
+}
+
 } // namespace cg
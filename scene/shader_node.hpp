@@ -14,9 +14,15 @@
 
 #include "scene/scene_node.hpp"
 
+#include "filesystem_support/file_watcher.hpp"
 #include "shader_support/glsl_shader.hpp"
 #include "shader_support/glsl_shader_program.hpp"
 
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
 namespace cg
 {
 
@@ -40,12 +46,16 @@ class ShaderNode : public SceneNode
 
     /**
      * Create a shader program given a filename for the vertex shader and a filename
-     * for the fragment shader.
+     * for the fragment shader. Sources are preprocessed (#include and the defines)
+     * and each variant is compiled once, however many nodes use it.
      * @param  vertex_shader_filename    Vertex shader file name
      * @param  fragment_shader_filename  Fragment shader file name
+     * @param  defines                   Defines selecting the shader variant
      * @return  Returns true if successful, false if compile or link errors occur.
      */
-    bool create(const char *vertex_shader_filename, const char *fragment_shader_filename);
+    bool create(const char          *vertex_shader_filename,
+                const char          *fragment_shader_filename,
+                const ShaderDefines &defines = ShaderDefines());
 
     /**
      * Create a shader program given source char array for the vertex shader and source
@@ -56,6 +66,27 @@ class ShaderNode : public SceneNode
      */
     bool create_from_source(const char *vertex_shader_source, const char *fragment_shader_source);
 
+    /**
+     * Reload the program when its shader files (including #include files)
+     * change. The new program is compiled while frames keep drawing with the
+     * current one (in the background if the driver supports parallel
+     * compiles) and swapped in by update. If the new program fails to compile
+     * or link, the current program is kept. Attribute locations must not
+     * change (geometry nodes bake them into their vertex arrays), so declare
+     * them with layout qualifiers. The watcher must outlive this node.
+     * @param  watcher  File watcher (its dispatch_changes is called once per frame).
+     * @return  Returns true if the files are watched (false for programs created
+     *          from source strings or read from an asset archive).
+     */
+    bool enable_hot_reload(FileWatcher &watcher);
+
+    /**
+     * Update: swaps in a reloaded program at the frame boundary, then updates
+     * the children.
+     * @param  scene_state  Current scene state.
+     */
+    void update(SceneState &scene_state) override;
+
     // Derived classes must add this to set all internal uniforms and attribute locations
     virtual bool get_locations() = 0;
 
@@ -63,6 +94,41 @@ class ShaderNode : public SceneNode
     GLSLVertexShader   vertex_shader_;
     GLSLFragmentShader fragment_shader_;
     GLSLShaderProgram  shader_program_;
+
+    // Files and defines the program was created from
+    std::string   vertex_filename_;
+    std::string   fragment_filename_;
+    ShaderDefines defines_;
+
+    // Hot reload
+    FileWatcher                           *watcher_;
+    std::vector<uint32_t>                  watch_ids_;
+    bool                                   reload_requested_;
+    bool                                   reload_pending_;
+    std::chrono::steady_clock::time_point  reload_time_; // When the change was seen
+    std::shared_ptr<ShaderVariant>         reload_vertex_variant_;
+    std::shared_ptr<ShaderVariant>         reload_fragment_variant_;
+    GLSLVertexShader                       reload_vertex_shader_;
+    GLSLFragmentShader                     reload_fragment_shader_;
+    GLSLShaderProgram                      reload_program_;
+
+    /**
+     * Build the program from vertex and fragment shader variants, linking from
+     * the program binary cache when it holds an entry for the sources.
+     * @param  vertex_variant    Vertex shader variant
+     * @param  fragment_variant  Fragment shader variant
+     * @return  Returns true if successful, false if compile or link errors occur.
+     */
+    bool create_program(ShaderVariant &vertex_variant, ShaderVariant &fragment_variant);
+
+    // Watch the files of the current variants (replacing any earlier watches)
+    bool watch_source_files();
+
+    // Start compiling the changed sources into the reload program
+    void begin_reload();
+
+    // Swap in the reload program if it compiled and linked
+    void finish_reload();
 };
 
 } // namespace cg
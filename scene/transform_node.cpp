@@ -1,5 +1,7 @@
 #include "scene/transform_node.hpp"
 
+#include "profiler/profiler.hpp"
+
 namespace cg
 {
 
@@ -11,22 +13,52 @@ TransformNode::TransformNode()
 
 TransformNode::~TransformNode() {}
 
-void TransformNode::load_identity() { model_matrix_.set_identity(); }
+void TransformNode::load_identity()
+{
+    model_matrix_.set_identity();
+    mark_bounds_dirty();
+}
 
-void TransformNode::translate(float x, float y, float z) { model_matrix_.translate(x, y, z); }
+void TransformNode::translate(float x, float y, float z)
+{
+    model_matrix_.translate(x, y, z);
+    mark_bounds_dirty();
+}
 
-void TransformNode::rotate(float deg, Vector3 &v) { model_matrix_.rotate(deg, v.x, v.y, v.z); }
+void TransformNode::rotate(float deg, Vector3 &v)
+{
+    model_matrix_.rotate(deg, v.x, v.y, v.z);
+    mark_bounds_dirty();
+}
 
-void TransformNode::rotate_x(float deg) { model_matrix_.rotate_x(deg); }
+void TransformNode::rotate_x(float deg)
+{
+    model_matrix_.rotate_x(deg);
+    mark_bounds_dirty();
+}
 
-void TransformNode::rotate_y(float deg) { model_matrix_.rotate_y(deg); }
+void TransformNode::rotate_y(float deg)
+{
+    model_matrix_.rotate_y(deg);
+    mark_bounds_dirty();
+}
 
-void TransformNode::rotate_z(float deg) { model_matrix_.rotate_z(deg); }
+void TransformNode::rotate_z(float deg)
+{
+    model_matrix_.rotate_z(deg);
+    mark_bounds_dirty();
+}
 
-void TransformNode::scale(float x, float y, float z) { model_matrix_.scale(x, y, z); }
+void TransformNode::scale(float x, float y, float z)
+{
+    model_matrix_.scale(x, y, z);
+    mark_bounds_dirty();
+}
 
 void TransformNode::draw(SceneState &scene_state)
 {
+    CG_PROFILE_SCOPE("TransformNode::draw");
+
     // Copy current transforms onto stack
     scene_state.push_transforms();
 
@@ -54,4 +86,6 @@ void TransformNode::draw(SceneState &scene_state)
 
 void TransformNode::update(SceneState &scene_state) {}
 
+const Matrix4x4 *TransformNode::local_transform() const { return &model_matrix_; }
+
 } // namespace cg
@@ -96,6 +96,12 @@ class TransformNode : public SceneNode
 
   protected:
     Matrix4x4 model_matrix_; // Local modeling transformation
+
+    /**
+     * Get the transform this node applies to its children.
+     * @return  Returns the local modeling transformation.
+     */
+    const Matrix4x4 *local_transform() const override;
 };
 
 } // namespace cg
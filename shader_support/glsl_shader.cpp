@@ -1,5 +1,6 @@
 #include "shader_support/glsl_shader.hpp"
 
+#include "filesystem_support/asset_archive.hpp"
 #include "filesystem_support/file_locator.hpp"
 
 #include <iostream>
@@ -11,20 +12,36 @@ GLSLShader::GLSLShader(const std::string &shader_str, GLenum shader_type)
 {
     shader_type_str_ = shader_str;
     gl_shader_type_ = shader_type;
+    gl_shader_ = 0;
 }
 
-bool GLSLShader::create_from_source(const char *source)
+bool GLSLShader::create_from_source(const char *source) { return create_from_source(source, -1); }
+
+bool GLSLShader::create_from_source(const char *source, int32_t length)
+{
+    compile(source, length);
+    return finish_compile(source, length);
+}
+
+void GLSLShader::compile(const char *source, int32_t length)
 {
-    bool success = true;
     gl_shader_ = glCreateShader(gl_shader_type_);
-    glShaderSource(gl_shader_, 1, &source, NULL);
+    glShaderSource(gl_shader_, 1, &source, (length < 0) ? NULL : &length);
     glCompileShader(gl_shader_);
+}
+
+bool GLSLShader::finish_compile(const char *source, int32_t length)
+{
+    bool success = true;
     if(!check_compile_status(gl_shader_))
     {
         std::cout << shader_type_str_ << " shader compile failed.\n";
         log_compile_error(gl_shader_);
         std::cout << shader_type_str_ << " Shader Source = \n";
-        std::cout << source << '\n';
+        if(length < 0)
+            std::cout << source << '\n';
+        else
+            std::cout << std::string(source, length) << '\n';
         success = false;
     }
     return success;
@@ -32,19 +49,54 @@ bool GLSLShader::create_from_source(const char *source)
 
 bool GLSLShader::create(const char *filename)
 {
-    FileContents file_contents;
-    if(!read_shader_source(filename, file_contents)) exit(-1);
+    FileView   source;
+    MappedFile file;
+    if(!load_source(filename, file, source)) exit(-1);
+    return create_from_source(source.data, static_cast<int32_t>(source.size));
+}
+
+bool GLSLShader::create(ShaderVariant &variant)
+{
+    begin_create(variant);
+    return finish_create(variant);
+}
+
+void GLSLShader::begin_create(ShaderVariant &variant)
+{
+    if(variant.shader != 0)
+        gl_shader_ = variant.shader;
+    else
+        compile(variant.source.c_str(), static_cast<int32_t>(variant.source.size()));
+}
 
-    uint32_t end_idx = file_contents.size - 1;
-    while(file_contents.data[end_idx] < ' ' || file_contents.data[end_idx] > '~')
+bool GLSLShader::finish_create(ShaderVariant &variant)
+{
+    if(gl_shader_ == variant.shader) return true;
+    if(!finish_compile(variant.source.c_str(), static_cast<int32_t>(variant.source.size())))
     {
-        file_contents.data[end_idx] = '\0';
-        --end_idx;
+        return false;
     }
+    variant.shader = gl_shader_;
+    return true;
+}
 
-    bool success = create_from_source(file_contents.data);
-    file_contents.destroy();
-    return success;
+bool GLSLShader::load_source(const char *filename, MappedFile &file, FileView &source)
+{
+    // Use a mounted asset archive if it holds the shader, otherwise map the file
+    if(filename == nullptr || !find_mounted_asset(filename, source))
+    {
+        if(!read_shader_source(filename, file)) return false;
+        source = file.view();
+    }
+
+    // Trim trailing non-printable characters by shortening the length passed to
+    // GL rather than writing into the (read-only) mapping
+    while(source.size > 0 &&
+          (source.data[source.size - 1] < ' ' || source.data[source.size - 1] > '~'))
+    {
+        --source.size;
+    }
+    return true;
 }
 
 GLuint GLSLShader::get() const { return gl_shader_; }
@@ -56,7 +108,7 @@ bool GLSLShader::check_compile_status(GLuint shader)
     return (param == GL_TRUE);
 }
 
-bool GLSLShader::read_shader_source(const char *filename, FileContents &file_contents)
+bool GLSLShader::read_shader_source(const char *filename, MappedFile &file)
 {
     if(filename == 0)
     {
@@ -73,7 +125,7 @@ bool GLSLShader::read_shader_source(const char *filename, FileContents &file_con
         return false;
     }
 
-    return load_file_contents(file_info.file_path, file_contents);
+    return file.open(file_info.file_path);
 }
 
 void GLSLShader::log_compile_error(GLuint shader)
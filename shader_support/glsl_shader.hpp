@@ -12,8 +12,9 @@
 #ifndef __SHADER_SUPPORT_GLSL_SHADER_HPP__
 #define __SHADER_SUPPORT_GLSL_SHADER_HPP__
 
-#include "filesystem_support/file_loader.hpp"
+#include "filesystem_support/mapped_file.hpp"
 #include "scene/graphics.hpp"
+#include "shader_support/shader_preprocessor.hpp"
 
 namespace cg
 {
@@ -35,6 +36,14 @@ class GLSLShader
      */
     bool create_from_source(const char *source);
 
+    /**
+     * Create shader from source code that need not be null terminated.
+     * @param  source  Source code for the shader.
+     * @param  length  Length of the source in characters.
+     * @return  Returns true if successful, false if not.
+     */
+    bool create_from_source(const char *source, int32_t length);
+
     /**
      * Create shader from source code file.
      * @param  filename File name for the source code for the shader.
@@ -42,6 +51,41 @@ class GLSLShader
      */
     bool create(const char *filename);
 
+    /**
+     * Create shader from a preprocessed variant. Uses the variant's shader
+     * object if it has already been compiled, otherwise compiles the variant
+     * and stores the shader object with it.
+     * @param  variant  Shader variant (see get_shader_variant).
+     * @return  Returns true if successful, false if not.
+     */
+    bool create(ShaderVariant &variant);
+
+    /**
+     * Start creating the shader from a variant without waiting for the
+     * compile, so drivers that compile on their own threads can do so in the
+     * background. Complete with finish_create.
+     * @param  variant  Shader variant (see get_shader_variant).
+     */
+    void begin_create(ShaderVariant &variant);
+
+    /**
+     * Finish creating a shader started with begin_create. Waits for the
+     * compile if it is still running.
+     * @param  variant  Shader variant passed to begin_create.
+     * @return  Returns true if successful, false if not.
+     */
+    bool finish_create(ShaderVariant &variant);
+
+    /**
+     * Get the source code for the shader from a mounted asset archive or by
+     * mapping the file. Trailing non-printable characters are trimmed.
+     * @param  filename  File name for the source code for the shader.
+     * @param  file      Mapped file (keeps the source valid when not from an archive).
+     * @param  source    Output: source code.
+     * @return  Returns true if the source was found.
+     */
+    bool load_source(const char *filename, MappedFile &file, FileView &source);
+
     /**
      * Get the shader handle.
      * @return Returns a handle to the shader.
@@ -59,8 +103,14 @@ class GLSLShader
      */
     bool check_compile_status(GLuint shader);
 
-    // Utility to read a shader source file
-    bool read_shader_source(const char *filename, FileContents &file_contents);
+    // Create the shader object and start compiling the source
+    void compile(const char *source, int32_t length);
+
+    // Check the compile status, logging the error and source on failure
+    bool finish_compile(const char *source, int32_t length);
+
+    // Utility to read (map) a shader source file
+    bool read_shader_source(const char *filename, MappedFile &file);
 
     /**
      * Logs a shader compile error
@@ -1,33 +1,202 @@
 #include "shader_support/glsl_shader_program.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 
 namespace cg
 {
 
+// Set by enable_parallel_shader_compile
+static bool g_parallel_shader_compile = false;
+
 GLSLShaderProgram::GLSLShaderProgram() : shader_program_(0) {}
 GLSLShaderProgram::~GLSLShaderProgram() {}
 
 void GLSLShaderProgram::create() { shader_program_ = glCreateProgram(); }
 
+bool enable_parallel_shader_compile()
+{
+#ifdef GL_KHR_parallel_shader_compile
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for(GLint i = 0; i < count && !g_parallel_shader_compile; ++i)
+    {
+        const char *name = reinterpret_cast<const char *>(glGetStringi(GL_EXTENSIONS, i));
+        g_parallel_shader_compile = std::strcmp(name, "GL_KHR_parallel_shader_compile") == 0;
+    }
+
+    // Extension entry points are not exported by every GL library, so look it up
+    auto max_threads = reinterpret_cast<PFNGLMAXSHADERCOMPILERTHREADSKHRPROC>(
+        SDL_GL_GetProcAddress("glMaxShaderCompilerThreadsKHR"));
+    g_parallel_shader_compile = g_parallel_shader_compile && max_threads != nullptr;
+    if(g_parallel_shader_compile) max_threads(0xFFFFFFFF);
+#endif
+    return g_parallel_shader_compile;
+}
+
 bool GLSLShaderProgram::attach_shaders(GLuint vertex_shader, GLuint fragment_shader)
+{
+    begin_link(vertex_shader, fragment_shader);
+    return finish_link();
+}
+
+void GLSLShaderProgram::begin_link(GLuint vertex_shader, GLuint fragment_shader)
 {
     glAttachShader(shader_program_, vertex_shader);
     glAttachShader(shader_program_, fragment_shader);
+    glProgramParameteri(shader_program_, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     glLinkProgram(shader_program_);
+}
+
+bool GLSLShaderProgram::is_link_complete() const
+{
+#ifdef GL_KHR_parallel_shader_compile
+    if(g_parallel_shader_compile)
+    {
+        GLint complete = GL_TRUE;
+        glGetProgramiv(shader_program_, GL_COMPLETION_STATUS_KHR, &complete);
+        return complete == GL_TRUE;
+    }
+#endif
+    return true;
+}
+
+bool GLSLShaderProgram::finish_link()
+{
     if(!check_link_status())
     {
         std::cout << "Shader link failed\n";
         log_link_error();
         return false;
     }
+    reflect();
+    return true;
+}
+
+bool GLSLShaderProgram::load_binary(GLenum format, const void *binary, GLsizei length)
+{
+    // A rejected binary (e.g. after a driver update) just leaves the program unlinked
+    glProgramBinary(shader_program_, format, binary, length);
+    if(!check_link_status()) return false;
+    reflect();
     return true;
 }
 
+bool GLSLShaderProgram::get_binary(GLenum &format, std::vector<char> &binary) const
+{
+    GLint length = 0;
+    glGetProgramiv(shader_program_, GL_PROGRAM_BINARY_LENGTH, &length);
+    if(length <= 0) return false;
+
+    binary.resize(length);
+    GLsizei written = 0;
+    glGetProgramBinary(shader_program_, length, &written, &format, binary.data());
+    binary.resize(written);
+    return written > 0;
+}
+
+static GLint find_location(const std::unordered_map<uint32_t, GLint> &table, uint32_t name_hash)
+{
+    auto itr = table.find(name_hash);
+    return (itr == table.end()) ? -1 : itr->second;
+}
+
+GLint GLSLShaderProgram::get_attribute_location(uint32_t name_hash) const
+{
+    return find_location(attribute_locations_, name_hash);
+}
+
+GLint GLSLShaderProgram::get_uniform_location(uint32_t name_hash) const
+{
+    return find_location(uniform_locations_, name_hash);
+}
+
+GLint GLSLShaderProgram::get_uniform_block_index(uint32_t name_hash) const
+{
+    return find_location(uniform_block_indexes_, name_hash);
+}
+
 GLuint GLSLShaderProgram::get_program() const { return shader_program_; }
 
 void GLSLShaderProgram::use() { glUseProgram(shader_program_); }
 
+void GLSLShaderProgram::destroy()
+{
+    if(shader_program_ != 0) glDeleteProgram(shader_program_);
+    shader_program_ = 0;
+    attribute_locations_.clear();
+    uniform_locations_.clear();
+    uniform_block_indexes_.clear();
+}
+
+void GLSLShaderProgram::reflect()
+{
+    attribute_locations_.clear();
+    uniform_locations_.clear();
+    uniform_block_indexes_.clear();
+
+    GLint max_length = 0;
+    GLint length = 0;
+    glGetProgramiv(shader_program_, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &length);
+    max_length = std::max(max_length, length);
+    glGetProgramiv(shader_program_, GL_ACTIVE_UNIFORM_MAX_LENGTH, &length);
+    max_length = std::max(max_length, length);
+    glGetProgramiv(shader_program_, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &length);
+    max_length = std::max(max_length, length);
+    std::vector<GLchar> name(max_length + 1);
+
+    GLint   count = 0;
+    GLint   size = 0;
+    GLenum  type = 0;
+    GLsizei name_length = 0;
+    glGetProgramiv(shader_program_, GL_ACTIVE_ATTRIBUTES, &count);
+    for(GLint i = 0; i < count; ++i)
+    {
+        glGetActiveAttrib(shader_program_, i, static_cast<GLsizei>(name.size()), &name_length,
+                          &size, &type, name.data());
+        add_location(attribute_locations_, std::string(name.data(), name_length),
+                     glGetAttribLocation(shader_program_, name.data()));
+    }
+
+    glGetProgramiv(shader_program_, GL_ACTIVE_UNIFORMS, &count);
+    for(GLint i = 0; i < count; ++i)
+    {
+        glGetActiveUniform(shader_program_, i, static_cast<GLsizei>(name.size()), &name_length,
+                           &size, &type, name.data());
+
+        // Uniforms in blocks have no location
+        GLint location = glGetUniformLocation(shader_program_, name.data());
+        if(location < 0) continue;
+
+        std::string uniform_name(name.data(), name_length);
+        add_location(uniform_locations_, uniform_name, location);
+        if(uniform_name.size() > 3 && uniform_name.compare(uniform_name.size() - 3, 3, "[0]") == 0)
+        {
+            uniform_name.resize(uniform_name.size() - 3);
+            add_location(uniform_locations_, uniform_name, location);
+        }
+    }
+
+    glGetProgramiv(shader_program_, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+    for(GLint i = 0; i < count; ++i)
+    {
+        glGetActiveUniformBlockName(shader_program_, i, static_cast<GLsizei>(name.size()),
+                                    &name_length, name.data());
+        add_location(uniform_block_indexes_, std::string(name.data(), name_length), i);
+    }
+}
+
+void GLSLShaderProgram::add_location(std::unordered_map<uint32_t, GLint> &table,
+                                     const std::string                   &name,
+                                     GLint                                location)
+{
+    if(!table.emplace(shader_name_hash(name.c_str()), location).second)
+    {
+        std::cout << "Shader variable name hash collision: " << name << '\n';
+    }
+}
+
 bool GLSLShaderProgram::check_link_status()
 {
     int param = 0;
@@ -13,9 +13,27 @@
 
 #include "scene/graphics.hpp"
 
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 namespace cg
 {
 
+/**
+ * FNV-1a hash of a shader variable name. Use it to initialize constexpr keys
+ * so the hash is computed at compile time, e.g.
+ *   constexpr uint32_t PVM_MATRIX = shader_name_hash("pvm_matrix");
+ * @param  name  Variable name (as declared in the shader).
+ * @return  Returns the hash.
+ */
+constexpr uint32_t shader_name_hash(const char *name)
+{
+    uint32_t hash = 2166136261u;
+    for(; *name != 0; ++name) hash = (hash ^ static_cast<uint8_t>(*name)) * 16777619u;
+    return hash;
+}
+
 /**
  * GLSL shader program
  */
@@ -35,6 +53,71 @@ class GLSLShaderProgram
      */
     bool attach_shaders(GLuint vertex_shader, GLuint fragment_shader);
 
+    /**
+     * Attach the specified shaders and start linking without waiting for the
+     * result. Complete with finish_link.
+     */
+    void begin_link(GLuint vertex_shader, GLuint fragment_shader);
+
+    /**
+     * Finish a link started with begin_link. Waits for the link if it is still
+     * running.
+     * @return  Returns true if the program linked.
+     */
+    bool finish_link();
+
+    /**
+     * Check if the compiles and link started with begin_link are done, so
+     * finish_link will not wait. Always true unless the driver supports
+     * KHR_parallel_shader_compile.
+     * @return  Returns true if the program is ready.
+     */
+    bool is_link_complete() const;
+
+    /**
+     * Delete the program.
+     */
+    void destroy();
+
+    /**
+     * Link the program from a binary previously retrieved with get_binary.
+     * @param  format  Binary format.
+     * @param  binary  Program binary.
+     * @param  length  Length of the binary in bytes.
+     * @return  Returns true if the driver accepted the binary.
+     */
+    bool load_binary(GLenum format, const void *binary, GLsizei length);
+
+    /**
+     * Get the binary of the linked program.
+     * @param  format  Output: binary format.
+     * @param  binary  Output: program binary.
+     * @return  Returns true if the driver returned a binary.
+     */
+    bool get_binary(GLenum &format, std::vector<char> &binary) const;
+
+    /**
+     * Get the location of an active vertex attribute.
+     * @param  name_hash  shader_name_hash of the attribute name.
+     * @return  Returns the location or -1 if the attribute is not active.
+     */
+    GLint get_attribute_location(uint32_t name_hash) const;
+
+    /**
+     * Get the location of an active uniform (not in a uniform block). Arrays
+     * are found by their name with or without "[0]".
+     * @param  name_hash  shader_name_hash of the uniform name.
+     * @return  Returns the location or -1 if the uniform is not active.
+     */
+    GLint get_uniform_location(uint32_t name_hash) const;
+
+    /**
+     * Get the index of an active uniform block.
+     * @param  name_hash  shader_name_hash of the block name.
+     * @return  Returns the block index or -1 if the block is not active.
+     */
+    GLint get_uniform_block_index(uint32_t name_hash) const;
+
     /**
      * Get the shader program handle
      * @return  Returns the handle to the shader program.
@@ -49,6 +132,24 @@ class GLSLShaderProgram
   protected:
     GLuint shader_program_;
 
+    // Active variables by name hash, filled in once after each successful link
+    std::unordered_map<uint32_t, GLint> attribute_locations_;
+    std::unordered_map<uint32_t, GLint> uniform_locations_;
+    std::unordered_map<uint32_t, GLint> uniform_block_indexes_;
+
+    /**
+     * Enumerates the active attributes, uniforms and uniform blocks of the
+     * linked program into the location tables.
+     */
+    void reflect();
+
+    /**
+     * Add a variable to a location table. Logs a hash collision.
+     */
+    void add_location(std::unordered_map<uint32_t, GLint> &table,
+                      const std::string                   &name,
+                      GLint                                location);
+
     /**
      * Checks the link status.
      * @return  Returns true if hte linker was successful, false if an error occured.
@@ -61,6 +162,13 @@ class GLSLShaderProgram
     void log_link_error();
 };
 
+/**
+ * Ask the driver to compile and link shaders on its own threads, if it
+ * supports KHR_parallel_shader_compile. Requires a current context.
+ * @return  Returns true if compiles and links can run in the background.
+ */
+bool enable_parallel_shader_compile();
+
 } // namespace cg
 
 #endif
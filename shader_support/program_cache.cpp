@@ -0,0 +1,124 @@
+#include "shader_support/program_cache.hpp"
+
+#include "filesystem_support/file_loader.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace cg
+{
+
+static std::string g_program_cache_directory;
+
+// FNV-1a, continued from the running hash
+static uint64_t hash_bytes(uint64_t hash, const char *data, uint64_t size)
+{
+    for(uint64_t i = 0; i < size; ++i)
+    {
+        hash ^= static_cast<uint8_t>(data[i]);
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+static uint64_t hash_gl_string(uint64_t hash, GLenum name)
+{
+    const char *str = reinterpret_cast<const char *>(glGetString(name));
+    if(str == nullptr) return hash;
+    return hash_bytes(hash, str, std::char_traits<char>::length(str) + 1);
+}
+
+static std::string cache_file_path(uint64_t key)
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+    return g_program_cache_directory + "/" + name;
+}
+
+void set_program_cache_directory(const std::string &directory)
+{
+    g_program_cache_directory = directory;
+}
+
+bool is_program_cache_enabled() { return !g_program_cache_directory.empty(); }
+
+uint64_t program_cache_key(const FileView &vertex_source, const FileView &fragment_source)
+{
+    // Lengths are hashed too so moving text between the stages changes the key
+    uint64_t hash = 0xcbf29ce484222325ull;
+    hash = hash_bytes(hash, reinterpret_cast<const char *>(&vertex_source.size),
+                      sizeof(vertex_source.size));
+    hash = hash_bytes(hash, vertex_source.data, vertex_source.size);
+    hash = hash_bytes(hash, reinterpret_cast<const char *>(&fragment_source.size),
+                      sizeof(fragment_source.size));
+    hash = hash_bytes(hash, fragment_source.data, fragment_source.size);
+    hash = hash_gl_string(hash, GL_VENDOR);
+    hash = hash_gl_string(hash, GL_RENDERER);
+    return hash_gl_string(hash, GL_VERSION);
+}
+
+bool load_cached_program(uint64_t key, GLSLShaderProgram &program, float &build_ms)
+{
+    if(!is_program_cache_enabled()) return false;
+
+    FileContents contents;
+    if(!load_file_contents(cache_file_path(key), contents)) return false;
+
+    bool               loaded = false;
+    ProgramCacheHeader header;
+    if(contents.size >= sizeof(header))
+    {
+        std::memcpy(&header, contents.data, sizeof(header));
+        if(header.magic == PROGRAM_CACHE_MAGIC && header.version == PROGRAM_CACHE_VERSION &&
+           header.key == key && contents.size - sizeof(header) >= header.binary_size)
+        {
+            loaded = program.load_binary(header.binary_format, contents.data + sizeof(header),
+                                         static_cast<GLsizei>(header.binary_size));
+            build_ms = header.build_ms;
+        }
+    }
+    contents.destroy();
+    return loaded;
+}
+
+bool save_cached_program(uint64_t key, const GLSLShaderProgram &program, float build_ms)
+{
+    if(!is_program_cache_enabled()) return false;
+
+    GLenum            format = 0;
+    std::vector<char> binary;
+    if(!program.get_binary(format, binary)) return false;
+
+    std::error_code ec;
+    std::filesystem::create_directories(g_program_cache_directory, ec);
+
+    ProgramCacheHeader header = {};
+    header.magic = PROGRAM_CACHE_MAGIC;
+    header.version = PROGRAM_CACHE_VERSION;
+    header.key = key;
+    header.binary_format = format;
+    header.binary_size = static_cast<uint32_t>(binary.size());
+    header.build_ms = build_ms;
+
+    // Write to a temporary file and rename so a partial write is never loaded
+    std::string   path = cache_file_path(key);
+    std::string   temp_path = path + ".tmp";
+    std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(binary.data(), binary.size());
+    out.close();
+    if(!out)
+    {
+        std::remove(temp_path.c_str());
+        std::cout << "Could not write program cache file " << temp_path << '\n';
+        return false;
+    }
+    std::filesystem::rename(temp_path, path, ec);
+    return !ec;
+}
+
+} // namespace cg
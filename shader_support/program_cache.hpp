@@ -0,0 +1,83 @@
+//============================================================================
+//	Johns Hopkins University Engineering Programs for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  David W. Nesbitt
+//	File:    program_cache.hpp
+//	Purpose: On-disk cache of linked shader program binaries
+//============================================================================
+
+#ifndef __SHADER_SUPPORT_PROGRAM_CACHE_HPP__
+#define __SHADER_SUPPORT_PROGRAM_CACHE_HPP__
+
+#include "filesystem_support/mapped_file.hpp"
+#include "shader_support/glsl_shader_program.hpp"
+
+#include <string>
+
+namespace cg
+{
+
+// Cache file layout: ProgramCacheHeader followed by binary_size bytes of
+// program binary. Files are named <key in hex>.bin in the cache directory.
+constexpr uint32_t PROGRAM_CACHE_MAGIC = 0x42504743; // "CGPB"
+constexpr uint32_t PROGRAM_CACHE_VERSION = 1;
+
+struct ProgramCacheHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint32_t binary_format; // Driver specific format from glGetProgramBinary
+    uint32_t binary_size;
+    float    build_ms;      // Time spent compiling and linking from source
+    uint32_t reserved;
+};
+
+/**
+ * Set the directory program binaries are cached in. The directory is created
+ * when the first binary is saved. An empty string disables the cache (the
+ * default).
+ * @param  directory  Cache directory.
+ */
+void set_program_cache_directory(const std::string &directory);
+
+/**
+ * Check if the program cache is enabled.
+ * @return  Returns true if a cache directory has been set.
+ */
+bool is_program_cache_enabled();
+
+/**
+ * Compute the cache key for a program: a hash of the shader sources plus the
+ * GL vendor, renderer and version strings, so binaries are never offered to
+ * a different driver. Requires a current GL context.
+ * @param  vertex_source    Vertex shader source.
+ * @param  fragment_source  Fragment shader source.
+ * @return  Returns the cache key.
+ */
+uint64_t program_cache_key(const FileView &vertex_source, const FileView &fragment_source);
+
+/**
+ * Load a cached binary into a program. Fails (and leaves the program unlinked)
+ * if there is no entry or the driver rejects the binary.
+ * @param  key       Cache key.
+ * @param  program   Program (created, nothing attached).
+ * @param  build_ms  Output: source compile and link time recorded with the entry.
+ * @return  Returns true if the program is linked from the cached binary.
+ */
+bool load_cached_program(uint64_t key, GLSLShaderProgram &program, float &build_ms);
+
+/**
+ * Save the binary of a linked program to the cache.
+ * @param  key       Cache key.
+ * @param  program   Linked program.
+ * @param  build_ms  Time taken to compile and link the program from source.
+ * @return  Returns true if the binary was written.
+ */
+bool save_cached_program(uint64_t key, const GLSLShaderProgram &program, float build_ms);
+
+} // namespace cg
+
+#endif
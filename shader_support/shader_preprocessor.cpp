@@ -0,0 +1,194 @@
+#include "shader_support/shader_preprocessor.hpp"
+
+#include "filesystem_support/asset_archive.hpp"
+#include "filesystem_support/file_locator.hpp"
+#include "filesystem_support/mapped_file.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <memory>
+
+namespace cg
+{
+
+static std::map<std::string, std::shared_ptr<ShaderVariant>> g_shader_variants;
+
+// Read a file from a mounted archive or the filesystem, one line per entry with
+// line endings and trailing non-printable characters removed
+static bool read_source_lines(const std::string &filename, std::vector<std::string> &lines)
+{
+    FileView   view;
+    MappedFile file;
+    if(!find_mounted_asset(filename, view))
+    {
+        auto file_info = locate_path_for_filename(filename);
+        if(!file_info.found || !file.open(file_info.file_path)) return false;
+        view = file.view();
+    }
+
+    lines.clear();
+    uint64_t start = 0;
+    while(start < view.size)
+    {
+        uint64_t end = start;
+        while(end < view.size && view.data[end] != '\n') ++end;
+        uint64_t length = end - start;
+        while(length > 0 && (view.data[start + length - 1] < ' ' ||
+                             view.data[start + length - 1] > '~'))
+        {
+            --length;
+        }
+        lines.emplace_back(view.data + start, length);
+        start = end + 1;
+    }
+    return true;
+}
+
+// Returns true and the quoted name if the line is an #include directive
+static bool parse_include(const std::string &line, std::string &name)
+{
+    size_t pos = line.find_first_not_of(" \t");
+    if(pos == std::string::npos || line[pos] != '#') return false;
+    pos = line.find_first_not_of(" \t", pos + 1);
+    if(pos == std::string::npos || line.compare(pos, 7, "include") != 0) return false;
+    size_t open = line.find('"', pos + 7);
+    size_t close = (open == std::string::npos) ? open : line.find('"', open + 1);
+    if(close == std::string::npos) return false;
+    name = line.substr(open + 1, close - open - 1);
+    return true;
+}
+
+static bool is_version_line(const std::string &line)
+{
+    size_t pos = line.find_first_not_of(" \t");
+    return pos != std::string::npos && line.compare(pos, 8, "#version") == 0;
+}
+
+// Directory part of a file name including the trailing separator
+static std::string directory_of(const std::string &filename)
+{
+    size_t pos = filename.find_last_of("/\\");
+    return (pos == std::string::npos) ? std::string() : filename.substr(0, pos + 1);
+}
+
+static bool expand_file(const std::string   &filename,
+                        const ShaderDefines &defines,
+                        ShaderVariant       &variant)
+{
+    std::vector<std::string> lines;
+    if(!read_source_lines(filename, lines))
+    {
+        std::cout << "Could not find shader file " << filename << '\n';
+        return false;
+    }
+    size_t file_index = variant.files.size();
+    variant.files.push_back(filename);
+
+    size_t line_index = 0;
+    if(file_index == 0)
+    {
+        // #version must come first so defines go after it
+        if(!lines.empty() && is_version_line(lines[0]))
+        {
+            variant.source += lines[0] + '\n';
+            line_index = 1;
+        }
+        for(const auto &define : defines)
+        {
+            std::string text = define;
+            std::replace(text.begin(), text.end(), '=', ' ');
+            variant.source += "#define " + text + '\n';
+        }
+    }
+    variant.source += "#line " + std::to_string(line_index + 1) + ' ' +
+                      std::to_string(file_index) + '\n';
+
+    for(; line_index < lines.size(); ++line_index)
+    {
+        std::string include_name;
+        if(!parse_include(lines[line_index], include_name))
+        {
+            variant.source += lines[line_index] + '\n';
+            continue;
+        }
+
+        // Prefer a file next to the including file
+        std::string directory = directory_of(filename);
+        std::string relative_name = directory + include_name;
+        FileView    view;
+        if(!directory.empty() && (find_mounted_asset(relative_name, view) ||
+                                  locate_path_for_filename(relative_name).found))
+        {
+            include_name = relative_name;
+        }
+
+        // Include each file once (also stops include cycles)
+        if(std::find(variant.files.begin(), variant.files.end(), include_name) ==
+           variant.files.end())
+        {
+            if(!expand_file(include_name, defines, variant)) return false;
+        }
+        variant.source += "#line " + std::to_string(line_index + 2) + ' ' +
+                          std::to_string(file_index) + '\n';
+    }
+    return true;
+}
+
+bool preprocess_shader(const std::string   &filename,
+                       const ShaderDefines &defines,
+                       ShaderVariant       &variant)
+{
+    variant.source.clear();
+    variant.files.clear();
+    variant.shader = 0;
+    return expand_file(filename, defines, variant);
+}
+
+std::shared_ptr<ShaderVariant> get_shader_variant(const std::string   &filename,
+                                                  const ShaderDefines &defines)
+{
+    ShaderDefines sorted_defines = defines;
+    std::sort(sorted_defines.begin(), sorted_defines.end());
+    std::string key = filename;
+    for(const auto &define : sorted_defines) key += '\n' + define;
+
+    auto itr = g_shader_variants.find(key);
+    if(itr != g_shader_variants.end()) return itr->second;
+
+    auto variant = std::make_shared<ShaderVariant>();
+    if(!preprocess_shader(filename, sorted_defines, *variant)) return nullptr;
+    g_shader_variants.emplace(key, variant);
+    return variant;
+}
+
+void invalidate_shader_variants(const std::string &filename)
+{
+    auto itr = g_shader_variants.begin();
+    while(itr != g_shader_variants.end())
+    {
+        const auto &files = itr->second->files;
+        if(std::find(files.begin(), files.end(), filename) == files.end())
+        {
+            ++itr;
+            continue;
+        }
+
+        // Programs keep attached shaders alive, so the object can be deleted
+        // unless a variant holder may still attach it
+        if(itr->second.use_count() == 1 && itr->second->shader != 0)
+            glDeleteShader(itr->second->shader);
+        itr = g_shader_variants.erase(itr);
+    }
+}
+
+void clear_shader_variants()
+{
+    for(auto &variant : g_shader_variants)
+    {
+        if(variant.second->shader != 0) glDeleteShader(variant.second->shader);
+    }
+    g_shader_variants.clear();
+}
+
+} // namespace cg
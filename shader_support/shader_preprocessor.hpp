@@ -0,0 +1,84 @@
+//============================================================================
+//	Johns Hopkins University Engineering Programs for Professionals
+//	605.667 Computer Graphics and 605.767 Applied Computer Graphics
+//	Instructor:	Brian Russin
+//
+//	Author:  David W. Nesbitt
+//	File:    shader_preprocessor.hpp
+//	Purpose: Shader source #include resolution, #define injection and a
+//           cache of preprocessed (and compiled) shader variants
+//============================================================================
+
+#ifndef __SHADER_SUPPORT_SHADER_PREPROCESSOR_HPP__
+#define __SHADER_SUPPORT_SHADER_PREPROCESSOR_HPP__
+
+#include "scene/graphics.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace cg
+{
+
+// Defines for a shader variant: "NAME" or "NAME VALUE" (or "NAME=VALUE")
+using ShaderDefines = std::vector<std::string>;
+
+/**
+ * Preprocessed shader source for one file and set of defines.
+ */
+struct ShaderVariant
+{
+    std::string              source; // Source with includes expanded and defines injected
+    std::vector<std::string> files;  // Files read (main file first). #line source numbers
+                                     // index this list.
+    GLuint                   shader = 0; // Compiled shader object, 0 until compiled
+};
+
+/**
+ * Preprocess a shader file:
+ *   - #include "name" lines are replaced by the named file. The name is
+ *     looked up relative to the including file's directory first, then as
+ *     given. Each file is included at most once.
+ *   - #define lines for the defines are inserted after the #version line.
+ *   - #line directives keep compile errors pointing at the original files.
+ * Files come from a mounted asset archive or are found with
+ * locate_path_for_filename.
+ * @param  filename  Shader file name.
+ * @param  defines   Defines for the variant.
+ * @param  variant   Output: preprocessed source and files read.
+ * @return  Returns true if the file and all of its includes were found.
+ */
+bool preprocess_shader(const std::string   &filename,
+                       const ShaderDefines &defines,
+                       ShaderVariant       &variant);
+
+/**
+ * Get a shader variant from the variant cache, preprocessing it the first
+ * time it is requested. The order of the defines does not matter. The
+ * compiled shader object is kept with the variant so each variant compiles
+ * once.
+ * @param  filename  Shader file name.
+ * @param  defines   Defines for the variant.
+ * @return  Returns the variant or nullptr if the source was not found.
+ */
+std::shared_ptr<ShaderVariant> get_shader_variant(const std::string   &filename,
+                                                  const ShaderDefines &defines);
+
+/**
+ * Remove the variants built from a file (directly or through #include) from
+ * the cache, so the next get_shader_variant reads the file again. Variants
+ * still held elsewhere stay valid.
+ * @param  filename  Shader file name (as passed to get_shader_variant or #include).
+ */
+void invalidate_shader_variants(const std::string &filename);
+
+/**
+ * Remove all variants from the cache and delete their shader objects
+ * (programs they are attached to are unaffected).
+ */
+void clear_shader_variants();
+
+} // namespace cg
+
+#endif